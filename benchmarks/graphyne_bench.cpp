@@ -0,0 +1,698 @@
+/**
+ * @file graphyne_bench.cpp
+ * @brief Headless engine benchmark producing JSON results for performance regression checks
+ *
+ * Boots the engine with the null renderer, spawns a synthetic scene of moving
+ * entities and runs a fixed number of frames with a fixed delta time, so two
+ * runs with the same arguments submit exactly the same work.
+ */
+#include "core/engine.h"
+#include "graphics/null_renderer.h"
+#include "utils/logger.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fmt/format.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+// Heap allocation tracking, every allocation of the process goes through these operators
+namespace
+{
+
+std::atomic<uint64_t> g_allocationCount{0};
+std::atomic<uint64_t> g_allocatedBytes{0};
+std::atomic<int64_t> g_liveBytes{0};
+std::atomic<int64_t> g_peakLiveBytes{0};
+
+// The size is stored in front of each block so that frees can be accounted for
+constexpr size_t ALLOCATION_HEADER = alignof(std::max_align_t);
+
+void* trackedAllocate(size_t size)
+{
+    void* block = std::malloc(size + ALLOCATION_HEADER);
+    if (!block)
+    {
+        throw std::bad_alloc();
+    }
+    *static_cast<size_t*>(block) = size;
+
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    int64_t live = g_liveBytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed) +
+                   static_cast<int64_t>(size);
+    int64_t peak = g_peakLiveBytes.load(std::memory_order_relaxed);
+    while (live > peak && !g_peakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+    {
+    }
+    return static_cast<uint8_t*>(block) + ALLOCATION_HEADER;
+}
+
+void trackedFree(void* pointer)
+{
+    if (!pointer)
+    {
+        return;
+    }
+    void* block = static_cast<uint8_t*>(pointer) - ALLOCATION_HEADER;
+    g_liveBytes.fetch_sub(static_cast<int64_t>(*static_cast<size_t*>(block)), std::memory_order_relaxed);
+    std::free(block);
+}
+
+} // namespace
+
+void* operator new(size_t size)
+{
+    return trackedAllocate(size);
+}
+
+void* operator new[](size_t size)
+{
+    return trackedAllocate(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    trackedFree(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    trackedFree(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    trackedFree(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+    trackedFree(pointer);
+}
+
+namespace
+{
+
+using namespace graphyne;
+
+struct BenchConfig
+{
+    uint32_t entityCount = 10000;
+    uint32_t frameCount = 1000;
+    uint32_t warmupFrames = 60;
+    uint32_t materialCount = 8;
+    uint32_t seed = 1;
+    uint32_t workerThreads = 0;
+    bool perfCounters = false;
+    bool parallelRecording = false;
+    bool gpuCulling = false;
+    std::string outputPath; // Empty writes to stdout
+};
+
+struct Entity
+{
+    glm::vec3 position;
+    glm::vec3 velocity;
+    glm::vec3 rotationAxis;
+    float rotationSpeed = 0.0f;
+    float angle = 0.0f;
+    uint32_t material = 0;
+    glm::mat4 transform;
+};
+
+/**
+ * @class SyntheticScene
+ * @brief Entities bouncing in a box, each drawn as an indexed cube with one of a few pipelines
+ */
+class SyntheticScene
+{
+public:
+    static constexpr float HALF_EXTENT = 100.0f;
+
+    bool load(graphics::Renderer& renderer, const BenchConfig& config)
+    {
+        std::mt19937 random(config.seed);
+        std::uniform_real_distribution<float> position(-HALF_EXTENT, HALF_EXTENT);
+        std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+        std::uniform_real_distribution<float> speed(0.5f, 10.0f);
+        std::uniform_int_distribution<uint32_t> material(0, config.materialCount - 1);
+
+        m_entities.resize(config.entityCount);
+        for (Entity& entity : m_entities)
+        {
+            entity.position = {position(random), position(random), position(random)};
+            entity.velocity = glm::vec3(direction(random), direction(random), direction(random)) * speed(random);
+            entity.rotationAxis =
+                glm::normalize(glm::vec3(direction(random), direction(random), direction(random)) + glm::vec3(0.01f));
+            entity.rotationSpeed = direction(random) * 3.0f;
+            entity.material = material(random);
+            entity.transform = glm::mat4(1.0f);
+        }
+
+        // Sorted by material to minimize pipeline switches, like a real render queue would
+        std::sort(m_entities.begin(), m_entities.end(), [](const Entity& a, const Entity& b) {
+            return a.material < b.material;
+        });
+
+        m_gpuCulling = config.gpuCulling;
+        return createResources(renderer, config.materialCount) &&
+               (!m_gpuCulling || createCullingResources(renderer, config.materialCount));
+    }
+
+    void unload(graphics::Renderer& renderer)
+    {
+        for (graphics::PipelineHandle pipeline : m_pipelines)
+        {
+            renderer.destroyPipeline(pipeline);
+        }
+        renderer.destroyBuffer(m_vertexBuffer);
+        renderer.destroyBuffer(m_indexBuffer);
+        if (m_gpuCulling)
+        {
+            renderer.destroyBuffer(m_cullDesc.objects);
+            renderer.destroyBuffer(m_cullDesc.drawCommands);
+            renderer.destroyBuffer(m_cullDesc.drawCounts);
+            renderer.destroyBuffer(m_transformBuffer);
+        }
+        m_pipelines.clear();
+        m_entities.clear();
+    }
+
+    void update(float deltaTime)
+    {
+        for (Entity& entity : m_entities)
+        {
+            entity.position += entity.velocity * deltaTime;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                if (entity.position[axis] < -HALF_EXTENT || entity.position[axis] > HALF_EXTENT)
+                {
+                    entity.velocity[axis] = -entity.velocity[axis];
+                    entity.position[axis] = glm::clamp(entity.position[axis], -HALF_EXTENT, HALF_EXTENT);
+                }
+            }
+
+            entity.angle += entity.rotationSpeed * deltaTime;
+            entity.transform = glm::rotate(glm::translate(glm::mat4(1.0f), entity.position),
+                                           entity.angle,
+                                           entity.rotationAxis);
+        }
+
+        if (m_gpuCulling)
+        {
+            for (size_t i = 0; i < m_entities.size(); ++i)
+            {
+                const Entity& entity = m_entities[i];
+                graphics::GpuCullObject& object = m_cullObjects[i];
+                object.boundingSphere[0] = entity.position.x;
+                object.boundingSphere[1] = entity.position.y;
+                object.boundingSphere[2] = entity.position.z;
+                m_transforms[i] = entity.transform;
+            }
+        }
+    }
+
+    void render(graphics::Renderer& renderer, bool parallel) const
+    {
+        if (m_gpuCulling)
+        {
+            renderGpuCulled(renderer);
+            return;
+        }
+        if (parallel)
+        {
+            renderer.recordParallel(static_cast<uint32_t>(m_entities.size()),
+                                    0,
+                                    [this](graphics::CommandRecorder& recorder, uint32_t begin, uint32_t end) {
+                                        record(recorder, begin, end);
+                                    });
+            return;
+        }
+        record(renderer, 0, static_cast<uint32_t>(m_entities.size()));
+    }
+
+private:
+    static constexpr uint32_t CUBE_INDEX_COUNT = 36;
+    static constexpr float CUBE_BOUNDING_RADIUS = 0.8660254f; // Half the diagonal of a unit cube
+
+    // Renderer and CommandRecorder share the recording methods, so both paths issue the same commands
+    template <typename Recorder>
+    void record(Recorder& recorder, uint32_t begin, uint32_t end) const
+    {
+        recorder.bindVertexBuffer(m_vertexBuffer);
+        recorder.bindIndexBuffer(m_indexBuffer, graphics::IndexType::Uint16);
+
+        uint32_t boundMaterial = UINT32_MAX;
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            const Entity& entity = m_entities[i];
+            if (entity.material != boundMaterial)
+            {
+                recorder.bindPipeline(m_pipelines[entity.material]);
+                boundMaterial = entity.material;
+            }
+            recorder.pushConstants(&entity.transform, sizeof(glm::mat4));
+            recorder.drawIndexed(CUBE_INDEX_COUNT);
+        }
+    }
+
+    // Objects are culled and compacted per material on the GPU, the CPU cost no longer depends on the entity count
+    void renderGpuCulled(graphics::Renderer& renderer) const
+    {
+        renderer.updateBuffer(
+            m_cullDesc.objects, m_cullObjects.data(), m_cullObjects.size() * sizeof(graphics::GpuCullObject));
+        renderer.updateBuffer(m_transformBuffer, m_transforms.data(), m_transforms.size() * sizeof(glm::mat4));
+        renderer.cullDraws(m_cullDesc);
+
+        renderer.bindVertexBuffer(m_vertexBuffer);
+        renderer.bindIndexBuffer(m_indexBuffer, graphics::IndexType::Uint16);
+        for (uint32_t material = 0; material < m_cullDesc.groupCount; ++material)
+        {
+            renderer.bindPipeline(m_pipelines[material]);
+            renderer.drawIndexedIndirectCount(m_cullDesc.drawCommands,
+                                              static_cast<size_t>(material) * m_cullDesc.maxDrawsPerGroup *
+                                                  sizeof(graphics::DrawIndexedIndirectCommand),
+                                              m_cullDesc.drawCounts,
+                                              material * sizeof(uint32_t),
+                                              m_cullDesc.maxDrawsPerGroup);
+        }
+    }
+
+    bool createResources(graphics::Renderer& renderer, uint32_t materialCount)
+    {
+        const float cubeVertices[] = {-0.5f, -0.5f, -0.5f, 0.5f, -0.5f, -0.5f, 0.5f, 0.5f, -0.5f, -0.5f, 0.5f, -0.5f,
+                                      -0.5f, -0.5f, 0.5f,  0.5f, -0.5f, 0.5f,  0.5f, 0.5f, 0.5f,  -0.5f, 0.5f, 0.5f};
+        const uint16_t cubeIndices[CUBE_INDEX_COUNT] = {0, 2, 1, 0, 3, 2, 4, 5, 6, 4, 6, 7, 0, 1, 5, 0, 5, 4,
+                                                        3, 6, 2, 3, 7, 6, 0, 4, 7, 0, 7, 3, 1, 2, 6, 1, 6, 5};
+
+        graphics::BufferDesc vertexDesc;
+        vertexDesc.size = sizeof(cubeVertices);
+        vertexDesc.usage = graphics::BufferUsage::Vertex;
+        vertexDesc.debugName = "BenchCubeVertices";
+        m_vertexBuffer = renderer.createBuffer(vertexDesc, cubeVertices);
+
+        graphics::BufferDesc indexDesc;
+        indexDesc.size = sizeof(cubeIndices);
+        indexDesc.usage = graphics::BufferUsage::Index;
+        indexDesc.debugName = "BenchCubeIndices";
+        m_indexBuffer = renderer.createBuffer(indexDesc, cubeIndices);
+
+        // The null renderer never runs shaders, a SPIR-V header is enough
+        const std::vector<uint32_t> placeholderShader = {0x07230203, 0x00010000, 0, 1, 0};
+        for (uint32_t i = 0; i < materialCount; ++i)
+        {
+            graphics::PipelineDesc pipelineDesc;
+            pipelineDesc.debugName = fmt::format("BenchMaterial{}", i);
+            pipelineDesc.vertexShader = placeholderShader;
+            pipelineDesc.fragmentShader = placeholderShader;
+            pipelineDesc.vertexStride = 3 * sizeof(float);
+            pipelineDesc.vertexAttributes = {{0, 0, graphics::VertexFormat::Float3}};
+            pipelineDesc.pushConstantSize = sizeof(glm::mat4);
+            m_pipelines.push_back(renderer.createPipeline(pipelineDesc));
+        }
+
+        return m_vertexBuffer.isValid() && m_indexBuffer.isValid() &&
+               std::all_of(m_pipelines.begin(), m_pipelines.end(), [](auto pipeline) { return pipeline.isValid(); });
+    }
+
+    // Vertex shaders read the transform of a draw from the transform buffer through gl_InstanceIndex
+    bool createCullingResources(graphics::Renderer& renderer, uint32_t materialCount)
+    {
+        if (!renderer.supportsGpuCulling())
+        {
+            std::cerr << "The renderer does not support GPU culling\n";
+            return false;
+        }
+
+        auto entityCount = static_cast<uint32_t>(m_entities.size());
+        m_cullObjects.resize(entityCount);
+        m_transforms.resize(entityCount);
+        for (uint32_t i = 0; i < entityCount; ++i)
+        {
+            graphics::GpuCullObject& object = m_cullObjects[i];
+            object.boundingSphere[3] = CUBE_BOUNDING_RADIUS;
+            object.indexCount = CUBE_INDEX_COUNT;
+            object.drawGroup = m_entities[i].material;
+        }
+
+        graphics::BufferDesc objectDesc;
+        objectDesc.size = entityCount * sizeof(graphics::GpuCullObject);
+        objectDesc.usage = graphics::BufferUsage::Storage;
+        objectDesc.hostVisible = true;
+        objectDesc.debugName = "BenchCullObjects";
+
+        graphics::BufferDesc transformDesc;
+        transformDesc.size = entityCount * sizeof(glm::mat4);
+        transformDesc.usage = graphics::BufferUsage::Storage;
+        transformDesc.hostVisible = true;
+        transformDesc.debugName = "BenchTransforms";
+
+        // Every entity of a material may be visible at once
+        graphics::BufferDesc commandDesc;
+        commandDesc.size =
+            static_cast<size_t>(materialCount) * entityCount * sizeof(graphics::DrawIndexedIndirectCommand);
+        commandDesc.usage = graphics::BufferUsage::Storage | graphics::BufferUsage::Indirect;
+        commandDesc.debugName = "BenchDrawCommands";
+
+        graphics::BufferDesc countDesc;
+        countDesc.size = materialCount * sizeof(uint32_t);
+        countDesc.usage = graphics::BufferUsage::Storage | graphics::BufferUsage::Indirect;
+        countDesc.debugName = "BenchDrawCounts";
+
+        m_cullDesc.objects = renderer.createBuffer(objectDesc);
+        m_cullDesc.drawCommands = renderer.createBuffer(commandDesc);
+        m_cullDesc.drawCounts = renderer.createBuffer(countDesc);
+        m_cullDesc.objectCount = entityCount;
+        m_cullDesc.groupCount = materialCount;
+        m_cullDesc.maxDrawsPerGroup = entityCount;
+        m_transformBuffer = renderer.createBuffer(transformDesc);
+
+        // Camera outside the box looking at its center, which sees most but not all of the entities
+        glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 1.0f, 1000.0f);
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 2.0f * HALF_EXTENT), glm::vec3(0.0f), glm::vec3(0, 1, 0));
+        glm::mat4 viewProjection = projection * view;
+        for (int i = 0; i < 6; ++i)
+        {
+            // Gribb-Hartmann extraction, planes are the sum or difference of the last row and one other row
+            int row = i / 2;
+            float sign = i % 2 == 0 ? 1.0f : -1.0f;
+            glm::vec4 plane;
+            for (int column = 0; column < 4; ++column)
+            {
+                plane[column] = viewProjection[column][3] + sign * viewProjection[column][row];
+            }
+            plane /= glm::length(glm::vec3(plane));
+            for (int component = 0; component < 4; ++component)
+            {
+                m_cullDesc.frustumPlanes[i][component] = plane[component];
+            }
+        }
+
+        return m_cullDesc.objects.isValid() && m_cullDesc.drawCommands.isValid() && m_cullDesc.drawCounts.isValid() &&
+               m_transformBuffer.isValid();
+    }
+
+    std::vector<Entity> m_entities;
+    std::vector<graphics::PipelineHandle> m_pipelines;
+    graphics::BufferHandle m_vertexBuffer;
+    graphics::BufferHandle m_indexBuffer;
+
+    // GPU culling mode
+    bool m_gpuCulling = false;
+    std::vector<graphics::GpuCullObject> m_cullObjects;
+    std::vector<glm::mat4> m_transforms;
+    graphics::GpuCullDesc m_cullDesc;
+    graphics::BufferHandle m_transformBuffer;
+};
+
+void printUsage()
+{
+    std::cerr << "Usage: graphyne_bench [options]\n"
+                 "  --entities N      Number of entities in the scene (default 10000)\n"
+                 "  --frames N        Number of measured frames (default 1000)\n"
+                 "  --warmup N        Frames run before measuring (default 60)\n"
+                 "  --materials N     Number of distinct pipelines (default 8)\n"
+                 "  --seed N          Seed of the scene generator (default 1)\n"
+                 "  --workers N       Job system worker threads, 0 for automatic (default 0)\n"
+                 "  --perf-counters   Report hardware performance counters when available\n"
+                 "  --parallel        Record draws on the job system workers\n"
+                 "  --gpu-culling     Cull on the GPU and draw each material with one indirect draw\n"
+                 "  --output PATH     Write the JSON results to PATH instead of stdout\n";
+}
+
+bool parseArguments(int argc, char* argv[], BenchConfig& config)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+        auto readNumber = [&](uint32_t& value) {
+            if (!hasValue)
+            {
+                return false;
+            }
+            char* end = nullptr;
+            unsigned long parsed = std::strtoul(argv[++i], &end, 10);
+            value = static_cast<uint32_t>(parsed);
+            return end && *end == '\0';
+        };
+
+        bool valid = true;
+        if (argument == "--entities")
+        {
+            valid = readNumber(config.entityCount);
+        }
+        else if (argument == "--frames")
+        {
+            valid = readNumber(config.frameCount) && config.frameCount > 0;
+        }
+        else if (argument == "--warmup")
+        {
+            valid = readNumber(config.warmupFrames);
+        }
+        else if (argument == "--materials")
+        {
+            valid = readNumber(config.materialCount) && config.materialCount > 0;
+        }
+        else if (argument == "--seed")
+        {
+            valid = readNumber(config.seed);
+        }
+        else if (argument == "--workers")
+        {
+            valid = readNumber(config.workerThreads);
+        }
+        else if (argument == "--perf-counters")
+        {
+            config.perfCounters = true;
+        }
+        else if (argument == "--parallel")
+        {
+            config.parallelRecording = true;
+        }
+        else if (argument == "--gpu-culling")
+        {
+            config.gpuCulling = true;
+        }
+        else if (argument == "--output" && hasValue)
+        {
+            config.outputPath = argv[++i];
+        }
+        else
+        {
+            valid = false;
+        }
+
+        if (!valid)
+        {
+            std::cerr << "Invalid argument: " << argument << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t getPeakResidentBytes()
+{
+#ifdef __linux__
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        return static_cast<uint64_t>(usage.ru_maxrss) * 1024; // Reported in kilobytes
+    }
+#endif
+    return 0;
+}
+
+void appendTiming(std::string& out, const char* name, const core::TimingSummary& timing)
+{
+    fmt::format_to(std::back_inserter(out),
+                   "\"{}\": {{\"average\": {:.4f}, \"p50\": {:.4f}, \"p95\": {:.4f}, \"p99\": {:.4f}, \"max\": {:.4f}}}",
+                   name,
+                   timing.average,
+                   timing.p50,
+                   timing.p95,
+                   timing.p99,
+                   timing.max);
+}
+
+void appendCounters(std::string& out, const char* name, const platform::PerfCounterValues& values, uint32_t frames)
+{
+    fmt::format_to(std::back_inserter(out),
+                   "\"{}\": {{\"cyclesPerFrame\": {}, \"instructionsPerFrame\": {}, \"cacheMissesPerFrame\": {}, "
+                   "\"branchMissesPerFrame\": {}, \"instructionsPerCycle\": {:.3f}}}",
+                   name,
+                   values.cycles / frames,
+                   values.instructions / frames,
+                   values.cacheMisses / frames,
+                   values.branchMisses / frames,
+                   values.getInstructionsPerCycle());
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    BenchConfig config;
+    if (!parseArguments(argc, argv, config))
+    {
+        printUsage();
+        return 1;
+    }
+
+    // Keep stdout clean for the JSON results
+    utils::Logger::getInstance().initialize("graphyne_bench.log", utils::LogLevel::Info, false);
+
+    Engine::Config engineConfig;
+    engineConfig.appName = "Graphyne Bench";
+    engineConfig.headless = true;
+    engineConfig.enableHotReload = false;
+    engineConfig.enableAssetCache = false;
+    engineConfig.workerThreadCount = config.workerThreads;
+    engineConfig.maxFrames = static_cast<uint64_t>(config.warmupFrames) + config.frameCount;
+    engineConfig.fixedDeltaTime = 1.0f / 60.0f;
+    engineConfig.frameStatsWindow = config.frameCount; // Warmup frames fall out of the window
+    engineConfig.statsLogInterval = 0.0;
+    engineConfig.enablePerfCounters = config.perfCounters;
+
+    Engine engine(engineConfig);
+    if (!engine.initialize())
+    {
+        std::cerr << "Failed to initialize the engine\n";
+        return 1;
+    }
+
+    SyntheticScene scene;
+    if (!scene.load(engine.getRenderer(), config))
+    {
+        std::cerr << "Failed to load the synthetic scene\n";
+        return 1;
+    }
+
+    // Counters are captured when the first measured frame starts
+    uint32_t frame = 0;
+    uint64_t allocationsBefore = 0;
+    uint64_t allocatedBytesBefore = 0;
+    Engine::PhaseCounters countersBefore;
+    engine.setUpdateCallback([&](float deltaTime) {
+        if (frame++ == config.warmupFrames)
+        {
+            allocationsBefore = g_allocationCount.load(std::memory_order_relaxed);
+            allocatedBytesBefore = g_allocatedBytes.load(std::memory_order_relaxed);
+            countersBefore = engine.getPhaseCounters();
+            if (auto* nullRenderer = dynamic_cast<graphics::NullRenderer*>(&engine.getRenderer()))
+            {
+                nullRenderer->resetCounters();
+            }
+        }
+        scene.update(deltaTime);
+    });
+    engine.setRenderCallback(
+        [&scene, &config](graphics::Renderer& renderer) { scene.render(renderer, config.parallelRecording); });
+
+    engine.run();
+
+    uint64_t allocations = g_allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+    uint64_t allocatedBytes = g_allocatedBytes.load(std::memory_order_relaxed) - allocatedBytesBefore;
+    core::FrameStatsSummary summary = engine.getFrameStats().computeSummary();
+    uint32_t measuredFrames = std::max(1u, summary.frameCount);
+
+    std::string out = "{\n";
+    fmt::format_to(std::back_inserter(out),
+                   "  \"config\": {{\"entities\": {}, \"frames\": {}, \"warmupFrames\": {}, \"materials\": {}, "
+                   "\"seed\": {}, \"workers\": {}, \"parallel\": {}, \"gpuCulling\": {}}},\n",
+                   config.entityCount,
+                   config.frameCount,
+                   config.warmupFrames,
+                   config.materialCount,
+                   config.seed,
+                   config.workerThreads,
+                   config.parallelRecording,
+                   config.gpuCulling);
+
+    out.append("  ");
+    appendTiming(out, "frameTimeMs", summary.frame);
+    out.append(",\n  \"subsystemsMs\": {\n    ");
+    appendTiming(out, "processEvents", summary.processEvents);
+    out.append(",\n    ");
+    appendTiming(out, "update", summary.update);
+    out.append(",\n    ");
+    appendTiming(out, "render", summary.render);
+    fmt::format_to(std::back_inserter(out),
+                   "\n  }},\n  \"hitches\": {{\"count\": {}, \"thresholdMs\": {:.1f}}},\n",
+                   summary.hitchCount,
+                   engine.getFrameStats().getHitchThreshold());
+
+    if (auto* nullRenderer = dynamic_cast<graphics::NullRenderer*>(&engine.getRenderer()))
+    {
+        const graphics::NullRenderer::Counters& counters = nullRenderer->getTotalCounters();
+        fmt::format_to(std::back_inserter(out),
+                       "  \"renderer\": {{\"drawCallsPerFrame\": {}, \"indirectDrawCallsPerFrame\": {}, "
+                       "\"stateChangesPerFrame\": {}, \"redundantBindsPerFrame\": {}, "
+                       "\"validationErrors\": {}}},\n",
+                       counters.drawCalls / measuredFrames,
+                       counters.indirectDrawCalls / measuredFrames,
+                       counters.getStateChanges() / measuredFrames,
+                       counters.redundantBinds / measuredFrames,
+                       counters.validationErrors);
+    }
+
+    fmt::format_to(std::back_inserter(out),
+                   "  \"memory\": {{\"allocations\": {}, \"allocationsPerFrame\": {:.2f}, \"allocatedBytes\": {}, "
+                   "\"peakHeapBytes\": {}, \"peakResidentBytes\": {}}}",
+                   allocations,
+                   static_cast<double>(allocations) / measuredFrames,
+                   allocatedBytes,
+                   g_peakLiveBytes.load(std::memory_order_relaxed),
+                   getPeakResidentBytes());
+
+    if (config.perfCounters)
+    {
+        const Engine::PhaseCounters& counters = engine.getPhaseCounters();
+
+        // Summed over the main thread and the job workers
+        fmt::format_to(std::back_inserter(out),
+                       ",\n  \"perfCounters\": {{\n    \"threads\": {},\n    ",
+                       engine.getPerfCounterThreadCount());
+        appendCounters(out, "processEvents", counters.processEvents - countersBefore.processEvents, measuredFrames);
+        out.append(",\n    ");
+        appendCounters(out, "update", counters.update - countersBefore.update, measuredFrames);
+        out.append(",\n    ");
+        appendCounters(out, "render", counters.render - countersBefore.render, measuredFrames);
+        out.append("\n  }");
+    }
+    out.append("\n}\n");
+
+    scene.unload(engine.getRenderer());
+    engine.shutdown();
+
+    if (config.outputPath.empty())
+    {
+        std::cout << out;
+        return 0;
+    }
+
+    std::ofstream file(config.outputPath, std::ios::trunc);
+    if (!file || !(file << out))
+    {
+        std::cerr << "Failed to write " << config.outputPath << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -44,6 +44,33 @@ function(graphyne_enable_warnings target)
     endif()
 endfunction()
 
+# Function to compile GLSL shaders into SPIR-V word lists, included by the target's sources as
+# "<shader file name>.spv.inc" to embed the shaders into the binary
+function(graphyne_compile_shaders target)
+    if(NOT Vulkan_GLSLC_EXECUTABLE)
+        message(FATAL_ERROR "glslc not found, it is required to compile the built-in shaders")
+    endif()
+
+    set(output_dir "${CMAKE_CURRENT_BINARY_DIR}/shaders")
+    set(outputs)
+    foreach(shader ${ARGN})
+        get_filename_component(shader_name ${shader} NAME)
+        set(output "${output_dir}/${shader_name}.spv.inc")
+        add_custom_command(
+            OUTPUT ${output}
+            COMMAND ${CMAKE_COMMAND} -E make_directory ${output_dir}
+            COMMAND ${Vulkan_GLSLC_EXECUTABLE} --target-env=vulkan1.1 -O -mfmt=num -o ${output} ${shader}
+            DEPENDS ${shader}
+            COMMENT "Compiling shader ${shader_name}"
+            VERBATIM
+        )
+        list(APPEND outputs ${output})
+    endforeach()
+
+    target_sources(${target} PRIVATE ${outputs})
+    target_include_directories(${target} PRIVATE ${output_dir})
+endfunction()
+
 # Function to add include directories for a target with proper interface
 function(graphyne_include_directories target)
     cmake_parse_arguments(PARSE_ARGV 1 ARG "" "" "PUBLIC;PRIVATE;INTERFACE")
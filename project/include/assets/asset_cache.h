@@ -0,0 +1,98 @@
+/**
+ * @file asset_cache.h
+ * @brief Content-addressed on-disk store for cooked asset data
+ */
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace graphyne::assets
+{
+
+/**
+ * @class AssetCache
+ * @brief Stores cooked blobs on disk under the hash of their inputs
+ *
+ * Entries are written to a temporary file and renamed into place, so a crash
+ * never leaves a truncated entry behind. When the total size exceeds the limit,
+ * the least recently used entries are evicted. All methods are thread-safe.
+ */
+class AssetCache
+{
+public:
+    /**
+     * @brief Constructor
+     * @param directory Root directory of the cache
+     * @param maxSize Size limit in bytes before entries get evicted
+     */
+    AssetCache(std::string directory, uint64_t maxSize);
+
+    /**
+     * @brief Index the entries already present on disk
+     * @return True if initialization succeeded, false otherwise
+     */
+    bool initialize();
+
+    /**
+     * @brief Read an entry and mark it as recently used
+     * @param key Content key of the entry
+     * @param data Receives the entry contents
+     * @return True on a cache hit, false otherwise
+     */
+    bool load(uint64_t key, std::vector<uint8_t>& data);
+
+    /**
+     * @brief Atomically write an entry, evicting old entries if needed
+     * @param key Content key of the entry
+     * @param data Entry contents
+     * @return True if the entry was written, false otherwise
+     */
+    bool store(uint64_t key, const std::vector<uint8_t>& data);
+
+    /**
+     * @brief Check if an entry exists without touching it
+     * @param key Content key of the entry
+     * @return True if the entry is in the cache, false otherwise
+     */
+    bool contains(uint64_t key) const;
+
+    /**
+     * @brief Delete an entry, for example one that turned out to be corrupt
+     * @param key Content key of the entry
+     */
+    void remove(uint64_t key);
+
+    /**
+     * @brief Evict least recently used entries until the cache fits its size limit
+     */
+    void trim();
+
+    /**
+     * @brief Get the total size of all entries
+     * @return Size in bytes
+     */
+    uint64_t getSize() const;
+
+private:
+    struct Entry
+    {
+        uint64_t size = 0;
+        int64_t lastAccess = 0; // File timestamp in clock ticks, also persisted as the file mtime
+    };
+
+    std::string getEntryPath(uint64_t key) const;
+    void removeLocked(uint64_t key);
+    void trimLocked();
+
+    std::string m_directory;
+    uint64_t m_maxSize;
+    uint64_t m_totalSize = 0;
+    std::unordered_map<uint64_t, Entry> m_entries;
+    mutable std::mutex m_mutex;
+};
+
+} // namespace graphyne::assets
@@ -0,0 +1,99 @@
+/**
+ * @file asset_pipeline.h
+ * @brief Entry point for loading assets through the cooked asset cache
+ */
+#pragma once
+
+#include "assets/asset_cache.h"
+#include "assets/texture_cooker.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace graphyne::core
+{
+struct JobCounter;
+}
+
+namespace graphyne::assets
+{
+
+/**
+ * @struct AssetPipelineConfig
+ * @brief Configuration for the asset pipeline
+ */
+struct AssetPipelineConfig
+{
+    bool enableCache = true;
+    std::string cacheDirectory = "cache";
+    uint64_t cacheSizeLimit = 2ull * 1024 * 1024 * 1024;
+};
+
+/**
+ * @class AssetPipeline
+ * @brief Turns source assets into cooked data, reusing cached results when possible
+ *
+ * Every request hashes the source bytes together with the cooker version and
+ * settings, and only runs the cooker when the cache has no entry for that key.
+ */
+class AssetPipeline
+{
+public:
+    using TextureCallback = std::function<void(bool success, CookedTexture&& texture)>;
+
+    /**
+     * @brief Constructor
+     * @param config Pipeline configuration
+     */
+    explicit AssetPipeline(const AssetPipelineConfig& config);
+
+    /**
+     * @brief Initialize the pipeline and its cache
+     * @return True if initialization succeeded, false otherwise
+     */
+    bool initialize();
+
+    /**
+     * @brief Shutdown the pipeline
+     */
+    void shutdown();
+
+    /**
+     * @brief Load a cooked texture, cooking and caching it on a miss
+     * @param path Path to the source image
+     * @param settings Cook settings
+     * @param texture Receives the cooked texture
+     * @return True if the texture was loaded, false otherwise
+     */
+    bool loadTexture(const std::string& path, const TextureCookSettings& settings, CookedTexture& texture);
+
+    /**
+     * @brief Load a cooked texture on a worker thread, as a background job
+     * @param path Path to the source image
+     * @param settings Cook settings
+     * @param callback Called from the worker thread once the texture is ready
+     * @param counter Optional counter to wait on for completion
+     */
+    void loadTextureAsync(const std::string& path,
+                          const TextureCookSettings& settings,
+                          TextureCallback callback,
+                          core::JobCounter* counter = nullptr);
+
+    /**
+     * @brief Compute the cache key of a texture
+     * @param source Source file contents
+     * @param settings Cook settings
+     * @return Key covering the source bytes, cooker version and settings
+     */
+    static uint64_t computeTextureKey(const std::vector<uint8_t>& source, const TextureCookSettings& settings);
+
+private:
+    AssetPipelineConfig m_config;
+    TextureCooker m_textureCooker;
+    std::unique_ptr<AssetCache> m_cache;
+};
+
+} // namespace graphyne::assets
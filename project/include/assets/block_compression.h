@@ -0,0 +1,45 @@
+/**
+ * @file block_compression.h
+ * @brief CPU encoders for BCn block compressed texture formats
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace graphyne::assets
+{
+
+/**
+ * All encoders take one 4x4 block of 16 RGBA8 texels in row-major order
+ * (64 bytes) and write a single compressed block to the output pointer.
+ */
+
+/**
+ * @brief Encode an opaque BC1 block
+ * @param texels 16 RGBA8 texels, alpha is ignored
+ * @param output Destination for 8 bytes
+ */
+void encodeBc1Block(const uint8_t* texels, uint8_t* output);
+
+/**
+ * @brief Encode a BC3 block (BC1 color plus interpolated alpha)
+ * @param texels 16 RGBA8 texels
+ * @param output Destination for 16 bytes
+ */
+void encodeBc3Block(const uint8_t* texels, uint8_t* output);
+
+/**
+ * @brief Encode a BC5 block from the red and green channels
+ * @param texels 16 RGBA8 texels, blue and alpha are ignored
+ * @param output Destination for 16 bytes
+ */
+void encodeBc5Block(const uint8_t* texels, uint8_t* output);
+
+/**
+ * @brief Encode a BC7 block using mode 6 (single subset RGBA, 4-bit indices)
+ * @param texels 16 RGBA8 texels
+ * @param output Destination for 16 bytes
+ */
+void encodeBc7Block(const uint8_t* texels, uint8_t* output);
+
+} // namespace graphyne::assets
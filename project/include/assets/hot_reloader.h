@@ -0,0 +1,139 @@
+/**
+ * @file hot_reloader.h
+ * @brief Background re-cooking of changed assets with frame-boundary swaps
+ */
+#pragma once
+
+#include "assets/texture_cooker.h"
+#include "core/job_system.h"
+#include "platform/file_watcher.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace graphyne::assets
+{
+
+class AssetPipeline;
+
+/**
+ * @class HotReloader
+ * @brief Watches source assets, re-cooks them on workers and swaps them in between frames
+ *
+ * Swaps run on the main thread from applyPendingSwaps(), which the engine calls at the
+ * frame boundary. A swap returns a retire function releasing the old resources, which is
+ * only invoked once every frame that could still reference them has completed.
+ */
+class HotReloader
+{
+public:
+    // Releases the resources replaced by a swap
+    using RetireFunction = std::function<void()>;
+    // Installs a re-cooked asset, runs on the main thread
+    using SwapFunction = std::function<RetireFunction()>;
+    // Re-cooks a changed file on a worker thread, returns an empty function on failure
+    using CookFunction = std::function<SwapFunction(const std::string& path)>;
+
+    /**
+     * @brief Constructor
+     * @param pipeline Asset pipeline used to re-cook textures
+     * @param retireLatency Number of frames a replaced resource may still be in use by the GPU
+     * @param maxSwapsPerFrame Upper bound of swaps applied per frame boundary
+     */
+    HotReloader(AssetPipeline& pipeline, uint32_t retireLatency, uint32_t maxSwapsPerFrame = 4);
+
+    /**
+     * @brief Destructor
+     */
+    ~HotReloader();
+
+    HotReloader(const HotReloader&) = delete;
+    HotReloader& operator=(const HotReloader&) = delete;
+
+    /**
+     * @brief Start the file watcher
+     * @return True if hot reload is available, false otherwise
+     */
+    bool initialize();
+
+    /**
+     * @brief Wait for in-flight cooks and release every retired resource
+     */
+    void shutdown();
+
+    /**
+     * @brief Watch a file with a custom cook step
+     * @param path Path to the source file
+     * @param cook Function re-cooking the file on a worker thread
+     */
+    void watch(const std::string& path, CookFunction cook);
+
+    /**
+     * @brief Watch a texture, re-cooking it through the asset pipeline
+     * @param path Path to the source image
+     * @param settings Cook settings
+     * @param swap Called at the frame boundary with the new texture, returns the retire function
+     */
+    void watchTexture(const std::string& path,
+                      const TextureCookSettings& settings,
+                      std::function<RetireFunction(CookedTexture&& texture)> swap);
+
+    /**
+     * @brief Watch a file whose raw bytes are used directly, such as SPIR-V shaders
+     * @param path Path to the file
+     * @param swap Called at the frame boundary with the new contents, returns the retire function
+     */
+    void watchFile(const std::string& path, std::function<RetireFunction(std::vector<uint8_t>&& data)> swap);
+
+    /**
+     * @brief Poll the file watcher and start re-cooking changed files
+     */
+    void update();
+
+    /**
+     * @brief Apply finished re-cooks and release retired resources, call between frames
+     * @param frameIndex Index of the frame that is about to start
+     */
+    void applyPendingSwaps(uint64_t frameIndex);
+
+private:
+    struct WatchedFile
+    {
+        CookFunction cook;
+        uint64_t generation = 0;
+    };
+
+    struct PendingSwap
+    {
+        std::string path;
+        uint64_t generation = 0;
+        SwapFunction swap;
+    };
+
+    struct RetiredResource
+    {
+        uint64_t frameIndex = 0;
+        RetireFunction retire;
+    };
+
+    void startCook(const std::string& path, WatchedFile& file);
+
+    AssetPipeline& m_pipeline;
+    uint32_t m_retireLatency;
+    uint32_t m_maxSwapsPerFrame;
+    platform::FileWatcher m_watcher;
+    std::unordered_map<std::string, WatchedFile> m_files;
+    std::deque<RetiredResource> m_retired;
+    std::vector<std::string> m_changedFiles;
+
+    core::JobCounter m_cookJobs;
+    std::mutex m_pendingMutex;
+    std::deque<PendingSwap> m_pendingSwaps;
+};
+
+} // namespace graphyne::assets
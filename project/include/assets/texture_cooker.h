@@ -0,0 +1,117 @@
+/**
+ * @file texture_cooker.h
+ * @brief Offline conversion of source images into GPU-ready mip chains
+ */
+#pragma once
+
+#include "graphics/texture_format.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace graphyne::assets
+{
+
+/**
+ * @struct TextureCookSettings
+ * @brief Options controlling how a source image is cooked
+ */
+struct TextureCookSettings
+{
+    graphics::TextureFormat format = graphics::TextureFormat::Bc7Srgb;
+    bool generateMips = true;
+    uint32_t maxMipLevels = 0; // 0 keeps the full chain down to 1x1
+};
+
+/**
+ * @struct CookedMip
+ * @brief Location of one mip level inside the cooked data blob
+ */
+struct CookedMip
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    size_t offset = 0;
+    size_t size = 0;
+};
+
+/**
+ * @struct CookedTexture
+ * @brief Cooked texture ready to be copied into a staging buffer as-is
+ */
+struct CookedTexture
+{
+    graphics::TextureFormat format = graphics::TextureFormat::Rgba8Unorm;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<CookedMip> mips;
+    std::vector<uint8_t> data; // All mips, tightly packed from the largest to the smallest
+};
+
+/**
+ * @class TextureCooker
+ * @brief Loads PNG/TGA/HDR images, builds mip chains and block compresses them
+ *
+ * Mip generation and block encoding are split into row ranges and
+ * distributed over the job system.
+ */
+class TextureCooker
+{
+public:
+    /**
+     * @brief Version of the cooker output, bump whenever cooked data changes
+     */
+    static constexpr uint32_t COOKER_VERSION = 1;
+
+    /**
+     * @brief Cook an image file
+     * @param path Path to the source image
+     * @param settings Cook settings
+     * @param output Receives the cooked texture
+     * @return True if cooking succeeded, false otherwise
+     */
+    bool cookFile(const std::string& path, const TextureCookSettings& settings, CookedTexture& output) const;
+
+    /**
+     * @brief Cook an encoded image held in memory
+     * @param source Encoded file contents (PNG, TGA or Radiance HDR)
+     * @param settings Cook settings
+     * @param output Receives the cooked texture
+     * @return True if cooking succeeded, false otherwise
+     */
+    bool cookMemory(const std::vector<uint8_t>& source,
+                    const TextureCookSettings& settings,
+                    CookedTexture& output) const;
+
+    /**
+     * @brief Serialize a cooked texture to a binary blob
+     * @param texture Texture to serialize
+     * @param output Receives the serialized bytes
+     */
+    static void serialize(const CookedTexture& texture, std::vector<uint8_t>& output);
+
+    /**
+     * @brief Deserialize a cooked texture from a binary blob
+     * @param input Serialized bytes
+     * @param texture Receives the texture
+     * @return True if the blob is a valid cooked texture, false otherwise
+     */
+    static bool deserialize(const std::vector<uint8_t>& input, CookedTexture& texture);
+
+private:
+    // Source pixels in linear floating point RGBA
+    struct LinearImage
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<float> pixels;
+    };
+
+    bool decode(const std::vector<uint8_t>& source, bool srgb, LinearImage& image) const;
+    void downsample(const LinearImage& source, LinearImage& destination) const;
+    void encode(const LinearImage& image, graphics::TextureFormat format, uint8_t* output) const;
+};
+
+} // namespace graphyne::assets
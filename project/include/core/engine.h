@@ -4,6 +4,11 @@
  */
 #pragma once
 
+#include "core/frame_stats.h"
+#include "platform/perf_counters.h"
+
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -11,6 +16,11 @@
 namespace graphyne {
 
 // Forward declarations
+namespace assets {
+class AssetPipeline;
+class HotReloader;
+}
+
 namespace graphics {
 class Renderer;
 }
@@ -37,6 +47,50 @@ public:
         uint32_t windowHeight = 720;
         bool enableValidation = true;
         bool enableVSync = true;
+        bool uncappedPresent = false;   // Without vsync, present immediately and allow tearing instead of MAILBOX
+        uint32_t framesInFlight = 2;    // Frames the CPU may record ahead of the GPU
+        uint32_t workerThreadCount = 0; // 0 uses one less than the hardware thread count
+        bool enableAssetCache = true;
+        std::string assetCacheDirectory = "cache";
+        std::string pipelineCachePath = "cache/pipelines.bin"; // Empty disables the on-disk pipeline cache
+        bool bindless = false; // Index textures and storage buffers from shaders, if the device supports it
+        bool enableHotReload = false;
+        bool headless = false;           // Skip window creation and use the null renderer backend
+        bool offscreenRendering = false; // In headless mode, render with Vulkan into offscreen images instead
+        uint64_t maxFrames = 0;          // Stop after this many frames, 0 runs until stopped
+        bool enableProfiling = false;    // Record GN_PROFILE_SCOPE events from startup
+        std::string profileTracePath;    // Trace written on shutdown, ".json" for Chrome JSON, otherwise Perfetto
+        uint32_t frameStatsWindow = 300; // Number of recent frames the frame statistics cover
+        double hitchThreshold = 33.3;    // Frame time in milliseconds above which a frame counts as a hitch
+        double statsLogInterval = 10.0;  // Seconds between frame statistics log summaries, 0 disables them
+        bool enablePerfCounters = false; // Count cycles and misses of the loop phases, summed with the job workers
+        bool pipelineStatistics = false; // Count shader invocations on the GPU, logged with the frame statistics
+        float fixedDeltaTime = 0.0f;     // Delta time passed to update for deterministic runs, 0 uses the frame time
+    };
+
+    /**
+     * @brief Called once per frame from update() with the frame delta time in seconds
+     */
+    using UpdateCallback = std::function<void(float deltaTime)>;
+
+    /**
+     * @brief Called once per frame from render() between beginFrame() and endFrame()
+     */
+    using RenderCallback = std::function<void(graphics::Renderer& renderer)>;
+
+    /**
+     * @struct PhaseCounters
+     * @brief Hardware counters and wall time accumulated per main loop phase
+     *
+     * The hardware counters are summed over the main thread and the job system workers while the
+     * phase runs, so jobs a phase hands to the workers are included, but so are background jobs
+     * like texture cooking that happen to overlap it.
+     */
+    struct PhaseCounters
+    {
+        platform::PerfCounterValues processEvents;
+        platform::PerfCounterValues update;
+        platform::PerfCounterValues render;
     };
 
     /**
@@ -84,6 +138,54 @@ public:
      */
     void stop() { m_running = false; }
 
+    /**
+     * @brief Set the application logic run every frame
+     * @param callback Update callback, an empty function removes it
+     */
+    void setUpdateCallback(UpdateCallback callback) { m_updateCallback = std::move(callback); }
+
+    /**
+     * @brief Set the application drawing run every frame
+     * @param callback Render callback, an empty function removes it
+     */
+    void setRenderCallback(RenderCallback callback) { m_renderCallback = std::move(callback); }
+
+    /**
+     * @brief Get the renderer, only valid after initialize()
+     * @return Reference to the renderer
+     */
+    graphics::Renderer& getRenderer() { return *m_renderer; }
+
+    /**
+     * @brief Get the asset pipeline used to load cooked assets
+     * @return Reference to the asset pipeline
+     */
+    assets::AssetPipeline& getAssetPipeline() { return *m_assetPipeline; }
+
+    /**
+     * @brief Get the hot reloader
+     * @return Pointer to the hot reloader, or nullptr if hot reload is disabled
+     */
+    assets::HotReloader* getHotReloader() { return m_hotReloader.get(); }
+
+    /**
+     * @brief Get the frame time statistics of the main loop
+     * @return Reference to the frame statistics
+     */
+    const core::FrameStats& getFrameStats() const { return m_frameStats; }
+
+    /**
+     * @brief Get the counters accumulated per main loop phase since the loop started
+     * @return Phase counters, only wall time is set unless Config::enablePerfCounters is on and supported
+     */
+    const PhaseCounters& getPhaseCounters() const { return m_phaseCounters; }
+
+    /**
+     * @brief Get the number of threads the hardware counters of the phases are summed over
+     * @return Main thread plus the workers that opened counters, 0 without hardware counters
+     */
+    uint32_t getPerfCounterThreadCount() const { return m_perfCounters ? m_perfCounters->getThreadCount() : 0; }
+
 private:
     Config m_config;
     bool m_initialized = false;
@@ -92,11 +194,35 @@ private:
     // Core subsystems
     std::unique_ptr<platform::Window> m_window;
     std::unique_ptr<graphics::Renderer> m_renderer;
+    std::unique_ptr<assets::AssetPipeline> m_assetPipeline;
+    std::unique_ptr<assets::HotReloader> m_hotReloader;
+
+    // Number of frames rendered so far
+    uint64_t m_frameIndex = 0;
+
+    // Application hooks
+    UpdateCallback m_updateCallback;
+    RenderCallback m_renderCallback;
+
+    // Frame timing
+    core::FrameStats m_frameStats;
+    std::chrono::steady_clock::time_point m_lastStatsLog;
+
+    // Hardware counters of the main loop phases
+    std::unique_ptr<platform::PerfCounters> m_perfCounters;
+    PhaseCounters m_phaseCounters;
+    PhaseCounters m_loggedPhaseCounters; // Values at the last log summary
+    uint64_t m_loggedFrameCount = 0;
+
+    // Shut down the subsystems created so far, also used when initialize() fails partway
+    void destroySubsystems();
 
     // Engine loop methods
     void processEvents();
     void update(float deltaTime);
     void render();
+    void recordFrameTiming(const core::FrameTiming& timing);
+    void logFrameStats();
 };
 
 } // namespace graphyne
@@ -0,0 +1,133 @@
+/**
+ * @file frame_stats.h
+ * @brief Rolling window frame time statistics with percentiles and hitch detection
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace graphyne::core
+{
+
+/**
+ * @struct FrameTiming
+ * @brief CPU time spent in one frame, in milliseconds
+ */
+struct FrameTiming
+{
+    double processEvents = 0.0;
+    double update = 0.0;
+    double render = 0.0;
+    double frame = 0.0; // Whole frame including everything not covered by the phases above
+};
+
+/**
+ * @struct TimingSummary
+ * @brief Distribution of one timing over the window, in milliseconds
+ */
+struct TimingSummary
+{
+    double average = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+/**
+ * @struct FrameStatsSummary
+ * @brief Statistics over the frames currently in the window
+ */
+struct FrameStatsSummary
+{
+    uint32_t frameCount = 0; // Frames in the window
+    TimingSummary processEvents;
+    TimingSummary update;
+    TimingSummary render;
+    TimingSummary frame;
+    uint32_t hitchCount = 0; // Hitches in the window
+};
+
+/**
+ * @class FrameStats
+ * @brief Keeps the timings of the most recent frames and summarizes them
+ *
+ * Averages hide stutters, so the summary reports tail percentiles and the
+ * worst frame. A frame is a hitch when it takes longer than the threshold.
+ */
+class FrameStats
+{
+public:
+    /**
+     * @brief Constructor
+     * @param windowSize Number of most recent frames kept
+     * @param hitchThreshold Frame time in milliseconds above which a frame counts as a hitch
+     */
+    explicit FrameStats(uint32_t windowSize = 300, double hitchThreshold = 33.3);
+
+    /**
+     * @brief Add the timings of a completed frame
+     * @param timing Frame timings
+     * @return True if the frame is a hitch, false otherwise
+     */
+    bool addFrame(const FrameTiming& timing);
+
+    /**
+     * @brief Compute statistics over the frames in the window
+     * @return Summary, zeroed if no frame was added yet
+     */
+    FrameStatsSummary computeSummary() const;
+
+    /**
+     * @brief Discard all frames, the totals included
+     */
+    void reset();
+
+    /**
+     * @brief Set the hitch threshold, applies to frames added afterwards
+     * @param hitchThreshold Frame time in milliseconds
+     */
+    void setHitchThreshold(double hitchThreshold) { m_hitchThreshold = hitchThreshold; }
+
+    /**
+     * @brief Get the hitch threshold
+     * @return Frame time in milliseconds above which a frame counts as a hitch
+     */
+    double getHitchThreshold() const { return m_hitchThreshold; }
+
+    /**
+     * @brief Get the timings of the last added frame
+     * @return Frame timings, zeroed if no frame was added yet
+     */
+    const FrameTiming& getLastFrame() const { return m_lastFrame; }
+
+    /**
+     * @brief Get the number of frames added since construction or reset
+     * @return Total frame count
+     */
+    uint64_t getTotalFrameCount() const { return m_totalFrames; }
+
+    /**
+     * @brief Get the number of hitches since construction or reset
+     * @return Total hitch count
+     */
+    uint64_t getTotalHitchCount() const { return m_totalHitches; }
+
+private:
+    struct Sample
+    {
+        FrameTiming timing;
+        bool hitch = false;
+    };
+
+    std::vector<Sample> m_samples; // Ring buffer of the window
+    uint32_t m_windowSize;
+    uint32_t m_nextSample = 0;
+    double m_hitchThreshold;
+    FrameTiming m_lastFrame;
+    uint64_t m_totalFrames = 0;
+    uint64_t m_totalHitches = 0;
+};
+
+} // namespace graphyne::core
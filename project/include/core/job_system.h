@@ -0,0 +1,142 @@
+/**
+ * @file job_system.h
+ * @brief Worker thread pool for parallel and background tasks
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace graphyne::core
+{
+
+/**
+ * @struct JobCounter
+ * @brief Tracks completion of a group of submitted jobs
+ */
+struct JobCounter
+{
+    std::atomic<uint32_t> pending{0};
+
+    /**
+     * @brief Check whether every job attached to this counter has finished
+     * @return True if no job is pending, false otherwise
+     */
+    bool isDone() const { return pending.load(std::memory_order_acquire) == 0; }
+};
+
+/**
+ * @class JobSystem
+ * @brief Fixed-size pool of worker threads consuming a shared job queue
+ *
+ * Workers take normal jobs before background ones, so long work like pipeline compiles and
+ * texture cooks does not delay jobs a frame waits for. A thread waiting on a counter only helps
+ * with the queued jobs of that counter, never with unrelated work.
+ *
+ * When the job system is not initialized, submitted jobs run inline on the
+ * calling thread, so code using it keeps working in tools and single-threaded setups.
+ */
+class JobSystem
+{
+public:
+    using Job = std::function<void()>;
+    using RangeJob = std::function<void(uint32_t begin, uint32_t end)>;
+    using ThreadCallback = std::function<void(uint32_t threadIndex)>;
+
+    /**
+     * @enum Priority
+     * @brief Order in which workers take queued jobs
+     */
+    enum class Priority
+    {
+        Normal,    // Work that is waited for soon, like frame recording
+        Background // Long work off the frame path, taken only when no normal job is queued
+    };
+
+    /**
+     * @brief Get singleton instance of the job system
+     * @return Reference to the job system instance
+     */
+    static JobSystem& getInstance();
+
+    /**
+     * @brief Start the worker threads
+     * @param workerCount Number of workers (0 uses one less than the hardware thread count)
+     * @param onWorkerStart Optional function each worker calls with its thread index before running jobs
+     * @return True if initialization succeeded, false otherwise
+     */
+    bool initialize(uint32_t workerCount = 0, const ThreadCallback& onWorkerStart = {});
+
+    /**
+     * @brief Finish all queued jobs and join the worker threads
+     */
+    void shutdown();
+
+    /**
+     * @brief Queue a job for execution on a worker thread
+     * @param job Job to run
+     * @param counter Optional counter incremented now and decremented when the job completes
+     * @param priority Queue the job goes to
+     */
+    void submit(Job job, JobCounter* counter = nullptr, Priority priority = Priority::Normal);
+
+    /**
+     * @brief Block until a counter reaches zero, running the queued jobs of that counter meanwhile
+     *
+     * Jobs of other counters are left to the workers, so the wait is bounded by the jobs it waits for.
+     *
+     * @param counter Counter to wait on
+     */
+    void wait(const JobCounter& counter);
+
+    /**
+     * @brief Split a range into batches and process them on all workers
+     * @param count Number of items in the range
+     * @param batchSize Number of items per job (0 picks a size based on the worker count)
+     * @param job Function called with each [begin, end) batch
+     */
+    void parallelFor(uint32_t count, uint32_t batchSize, const RangeJob& job);
+
+    /**
+     * @brief Get the number of worker threads
+     * @return Worker thread count (0 when not initialized)
+     */
+    uint32_t getWorkerCount() const;
+
+    /**
+     * @brief Get the index of the calling thread, to select per-thread resources
+     * @return 0 for threads outside of the pool, 1 + the worker index on worker threads
+     */
+    static uint32_t getCurrentThreadIndex();
+
+    /**
+     * @brief Check if the job system has been initialized
+     * @return True if worker threads are running, false otherwise
+     */
+    bool isInitialized() const { return m_initialized; }
+
+private:
+    // Private constructor for singleton
+    JobSystem() = default;
+
+    // Joins the workers if shutdown() was never called, destroying joinable threads would terminate
+    ~JobSystem();
+
+    // Deleted copy and move constructors and assignment operators
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    JobSystem(JobSystem&&) = delete;
+    JobSystem& operator=(JobSystem&&) = delete;
+
+    // Pop and run one queued job of a counter, returns false if none is queued
+    bool runPendingJob(const JobCounter& counter);
+
+    // Implementation details will be defined in the .cpp file
+    struct JobSystemImpl;
+    std::unique_ptr<JobSystemImpl> m_impl;
+    bool m_initialized = false;
+};
+
+} // namespace graphyne::core
@@ -4,6 +4,8 @@
  */
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
@@ -74,13 +76,34 @@ public:
      */
     void free(void* ptr, AllocationType type = AllocationType::General);
 
+    /**
+     * @brief Record memory allocated outside the pools, such as GPU memory, in the statistics
+     * @param size Size in bytes
+     * @param type Type of allocation
+     */
+    void trackExternalAllocation(size_t size, AllocationType type);
+
+    /**
+     * @brief Record the release of memory previously passed to trackExternalAllocation()
+     * @param size Size in bytes
+     * @param type Type of allocation
+     */
+    void trackExternalFree(size_t size, AllocationType type);
+
     /**
      * @brief Get memory usage statistics
      * @param type Type of allocation to get statistics for
-     * @return Total allocated bytes for the specified type
+     * @return Total allocated bytes for the specified type, including external allocations
      */
     size_t getAllocatedSize(AllocationType type) const;
 
+    /**
+     * @brief Get the bytes recorded with trackExternalAllocation()
+     * @param type Type of allocation to get statistics for
+     * @return Externally allocated bytes for the specified type
+     */
+    size_t getExternalSize(AllocationType type) const;
+
     /**
      * @brief Print memory usage statistics
      */
@@ -100,6 +123,10 @@ private:
     struct MemoryManagerImpl;
     std::unique_ptr<MemoryManagerImpl> m_impl;
     bool m_initialized = false;
+
+    // Tracked independently of the pools, so it also works before initialize()
+    static constexpr size_t ALLOCATION_TYPE_COUNT = static_cast<size_t>(AllocationType::Temp) + 1;
+    std::array<std::atomic<size_t>, ALLOCATION_TYPE_COUNT> m_externalSizes = {};
 };
 
 // Custom C++ allocator compatible with STL containers
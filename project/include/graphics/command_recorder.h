@@ -0,0 +1,96 @@
+/**
+ * @file command_recorder.h
+ * @brief Interface for recording draws, used by parallel command recording
+ */
+#pragma once
+
+#include "graphics/render_types.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace graphyne::graphics
+{
+
+/**
+ * @class CommandRecorder
+ * @brief Records binds and draws into one batch of commands
+ *
+ * A recorder starts with nothing bound and is only used by a single thread at a time.
+ */
+class CommandRecorder
+{
+public:
+    virtual ~CommandRecorder() = default;
+
+    /**
+     * @brief Bind the pipeline used by the following draws
+     * @param pipeline Pipeline to bind
+     */
+    virtual void bindPipeline(PipelineHandle pipeline) = 0;
+
+    /**
+     * @brief Bind the vertex buffer used by the following draws
+     * @param buffer Vertex buffer
+     * @param offset Byte offset of the first vertex
+     */
+    virtual void bindVertexBuffer(BufferHandle buffer, size_t offset = 0) = 0;
+
+    /**
+     * @brief Bind the index buffer used by the following indexed draws
+     * @param buffer Index buffer
+     * @param type Size of the indices
+     * @param offset Byte offset of the first index
+     */
+    virtual void bindIndexBuffer(BufferHandle buffer, IndexType type, size_t offset = 0) = 0;
+
+    /**
+     * @brief Set push constant data for the following draws
+     * @param data Source data
+     * @param size Number of bytes, at most the pipeline's push constant size
+     * @param offset Byte offset into the push constant range
+     */
+    virtual void pushConstants(const void* data, uint32_t size, uint32_t offset = 0) = 0;
+
+    /**
+     * @brief Draw non-indexed primitives
+     * @param vertexCount Number of vertices
+     * @param instanceCount Number of instances
+     * @param firstVertex Index of the first vertex
+     * @param firstInstance Index of the first instance
+     */
+    virtual void draw(uint32_t vertexCount,
+                      uint32_t instanceCount = 1,
+                      uint32_t firstVertex = 0,
+                      uint32_t firstInstance = 0) = 0;
+
+    /**
+     * @brief Draw indexed primitives
+     * @param indexCount Number of indices
+     * @param instanceCount Number of instances
+     * @param firstIndex Index of the first index
+     * @param vertexOffset Value added to each index
+     * @param firstInstance Index of the first instance
+     */
+    virtual void drawIndexed(uint32_t indexCount,
+                             uint32_t instanceCount = 1,
+                             uint32_t firstIndex = 0,
+                             int32_t vertexOffset = 0,
+                             uint32_t firstInstance = 0) = 0;
+
+    /**
+     * @brief Draw indexed primitives with arguments and a draw count read from buffers
+     * @param commands Buffer of DrawIndexedIndirectCommand, created with BufferUsage::Indirect
+     * @param offset Byte offset of the first command
+     * @param count Buffer holding the draw count as a uint32_t, created with BufferUsage::Indirect
+     * @param countOffset Byte offset of the draw count
+     * @param maxDrawCount Maximum number of draws, the draw count is clamped to it
+     */
+    virtual void drawIndexedIndirectCount(BufferHandle commands,
+                                          size_t offset,
+                                          BufferHandle count,
+                                          size_t countOffset,
+                                          uint32_t maxDrawCount) = 0;
+};
+
+} // namespace graphyne::graphics
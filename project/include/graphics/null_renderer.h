@@ -0,0 +1,235 @@
+/**
+ * @file null_renderer.h
+ * @brief Renderer backend that validates and counts work without a GPU
+ */
+#pragma once
+
+#include "graphics/renderer.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace graphyne::graphics {
+
+/**
+ * @class NullRenderer
+ * @brief Renderer implementation for machines without a display or GPU
+ *
+ * Every API call is checked for misuse (invalid handles, out of range uploads,
+ * draws outside of a frame...) and counted, but no data is copied and no GPU
+ * is touched. This isolates the CPU cost of render preparation in benchmarks.
+ */
+class NullRenderer : public Renderer
+{
+public:
+    /**
+     * @struct Counters
+     * @brief Work submitted through the renderer API
+     */
+    struct Counters
+    {
+        uint64_t frames = 0;
+        uint64_t drawCalls = 0;
+        uint64_t vertices = 0; // Vertices or indices submitted, per instance
+        uint64_t instances = 0;
+        uint64_t triangles = 0;         // Over all instances, from the topology of the bound pipeline
+        uint64_t indirectDrawCalls = 0; // Draw counts are read by the GPU, so their draws are not counted
+        uint64_t cullPasses = 0;
+        uint64_t cullObjects = 0; // Objects submitted to GPU culling
+        uint64_t bytesUploaded = 0;
+        uint64_t pipelineBinds = 0;
+        uint64_t vertexBufferBinds = 0;
+        uint64_t indexBufferBinds = 0;
+        uint64_t pushConstantUpdates = 0;
+        uint64_t redundantBinds = 0; // Binds of the resource that was already bound
+        uint64_t resourcesCreated = 0;
+        uint64_t resourcesDestroyed = 0;
+        uint64_t validationErrors = 0;
+
+        /**
+         * @brief Get the number of state changes (binds and push constant updates)
+         * @return State change count
+         */
+        uint64_t getStateChanges() const
+        {
+            return pipelineBinds + vertexBufferBinds + indexBufferBinds + pushConstantUpdates;
+        }
+    };
+
+    /**
+     * @brief Constructor
+     * @param window Window to render to, may be nullptr
+     * @param config Renderer configuration
+     */
+    NullRenderer(platform::Window* window, const Config& config = Config{});
+
+    /**
+     * @brief Destructor
+     */
+    ~NullRenderer() override;
+
+    /**
+     * @brief Initialize the null renderer
+     * @return Always true
+     */
+    bool initialize() override;
+
+    /**
+     * @brief Shutdown the null renderer
+     */
+    void shutdown() override;
+
+    /**
+     * @brief Begin a new frame
+     */
+    void beginFrame() override;
+
+    /**
+     * @brief End the current frame
+     */
+    void endFrame() override;
+
+    /**
+     * @brief Wait for the device to be idle, returns immediately
+     */
+    void waitIdle() override;
+
+    /**
+     * @brief Handle window resize events
+     * @param width New width in pixels
+     * @param height New height in pixels
+     */
+    void onResize(int width, int height) override;
+
+    BufferHandle createBuffer(const BufferDesc& desc, const void* initialData = nullptr) override;
+    void updateBuffer(BufferHandle buffer, const void* data, size_t size, size_t offset = 0) override;
+    void destroyBuffer(BufferHandle buffer) override;
+    TextureHandle createTexture(const TextureDesc& desc) override;
+    void updateTexture(TextureHandle texture, uint32_t mipLevel, const void* data, size_t size) override;
+    void destroyTexture(TextureHandle texture) override;
+    bool isBindless() const override { return m_config.bindless; }
+    uint32_t getBindlessIndex(TextureHandle texture) const override;
+    uint32_t getBindlessIndex(BufferHandle buffer) const override;
+    PipelineHandle createPipeline(const PipelineDesc& desc) override;
+    void destroyPipeline(PipelineHandle pipeline) override;
+    bool isPipelineReady(PipelineHandle pipeline) const override;
+    void bindPipeline(PipelineHandle pipeline) override;
+    void bindVertexBuffer(BufferHandle buffer, size_t offset = 0) override;
+    void bindIndexBuffer(BufferHandle buffer, IndexType type, size_t offset = 0) override;
+    void pushConstants(const void* data, uint32_t size, uint32_t offset = 0) override;
+    void draw(uint32_t vertexCount,
+              uint32_t instanceCount = 1,
+              uint32_t firstVertex = 0,
+              uint32_t firstInstance = 0) override;
+    void drawIndexed(uint32_t indexCount,
+                     uint32_t instanceCount = 1,
+                     uint32_t firstIndex = 0,
+                     int32_t vertexOffset = 0,
+                     uint32_t firstInstance = 0) override;
+    void drawIndexedIndirectCount(BufferHandle commands,
+                                  size_t offset,
+                                  BufferHandle count,
+                                  size_t countOffset,
+                                  uint32_t maxDrawCount) override;
+    bool supportsGpuCulling() const override { return true; }
+    void cullDraws(const GpuCullDesc& desc) override;
+
+    /**
+     * @brief Record the batches one after another on the calling thread
+     *
+     * Each batch is validated and counted like direct calls, starting with nothing bound.
+     *
+     * @param count Number of items
+     * @param batchSize Items per batch, 0 picks a size based on the worker count
+     * @param job Function recording one batch
+     */
+    void recordParallel(uint32_t count, uint32_t batchSize, const RecordJob& job) override;
+    const std::vector<GpuPassTiming>& getGpuTimings() const override { return m_gpuTimings; }
+    const RenderStats& getStats() const override { return m_stats; }
+
+    /**
+     * @brief Get the counters of the last completed frame
+     * @return Counters of the frame ended by the last endFrame() call
+     */
+    const Counters& getFrameCounters() const { return m_lastFrameCounters; }
+
+    /**
+     * @brief Get the counters accumulated over all completed frames
+     * @return Total counters, work submitted outside of a frame is included in the next frame
+     */
+    const Counters& getTotalCounters() const { return m_totalCounters; }
+
+    /**
+     * @brief Get the number of frames ended since initialization
+     * @return Frame count
+     */
+    uint64_t getFrameCount() const { return m_totalCounters.frames; }
+
+    /**
+     * @brief Reset all counters to zero
+     */
+    void resetCounters();
+
+private:
+    struct BufferInfo
+    {
+        size_t size = 0;
+        BufferUsage usage = BufferUsage::Vertex;
+        uint32_t bindlessIndex = INVALID_BINDLESS_INDEX;
+    };
+
+    struct TextureInfo
+    {
+        TextureDesc desc;
+        uint32_t bindlessIndex = INVALID_BINDLESS_INDEX;
+    };
+
+    // Bindless indices handed out like a backend would, freed indices are reused first
+    struct BindlessIndices
+    {
+        std::vector<uint32_t> freeIndices;
+        uint32_t nextIndex = 0;
+
+        uint32_t allocate();
+        void release(uint32_t index);
+    };
+
+    struct PipelineInfo
+    {
+        uint32_t vertexStride = 0;
+        uint32_t pushConstantSize = 0;
+        PrimitiveTopology topology = PrimitiveTopology::TriangleList;
+    };
+
+    bool validate(bool condition, const char* message);
+    bool validateInFrame(const char* call);
+    bool validateBufferRange(BufferHandle buffer, BufferUsage usage, size_t offset, size_t size, const char* message);
+    void resetBindings();
+
+    bool m_initialized = false;
+    bool m_inFrame = false;
+    uint32_t m_nextHandleId = 1;
+
+    std::unordered_map<uint32_t, BufferInfo> m_buffers;
+    std::unordered_map<uint32_t, TextureInfo> m_textures;
+    std::unordered_map<uint32_t, PipelineInfo> m_pipelines;
+    BindlessIndices m_bindlessTextures;
+    BindlessIndices m_bindlessBuffers;
+
+    // Currently bound state
+    PipelineHandle m_boundPipeline;
+    BufferHandle m_boundVertexBuffer;
+    BufferHandle m_boundIndexBuffer;
+    size_t m_boundVertexOffset = 0;
+    size_t m_boundIndexOffset = 0;
+
+    Counters m_frameCounters;
+    Counters m_lastFrameCounters;
+    Counters m_totalCounters;
+    RenderStats m_stats; // Mapped from m_lastFrameCounters
+
+    std::vector<GpuPassTiming> m_gpuTimings; // Always empty, nothing runs on a GPU
+};
+
+} // namespace graphyne::graphics
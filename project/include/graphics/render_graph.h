@@ -0,0 +1,378 @@
+/**
+ * @file render_graph.h
+ * @brief Frame graph scheduling passes, barriers and transient images of the Vulkan backend
+ */
+#pragma once
+
+#include "graphics/vulkan_allocator.h"
+#include "graphics/vulkan_deletion_queue.h"
+#include "graphics/vulkan_sync.h"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace graphyne::graphics
+{
+
+/**
+ * @enum ResourceUsage
+ * @brief How a pass accesses an image, determines its layout and the stages to synchronize
+ */
+enum class ResourceUsage : uint8_t
+{
+    None,            // Not accessed, only valid as initial or final usage of an imported image
+    ColorAttachment, // Written as a color attachment
+    DepthAttachment, // Depth tested and written
+    DepthRead,       // Depth tested without writes
+    ShaderRead,      // Sampled by vertex, fragment or compute shaders
+    StorageRead,     // Read as a storage image
+    StorageWrite,    // Written, and possibly read, as a storage image
+    TransferSrc,     // Source of a copy or blit
+    TransferDst,     // Destination of a copy, blit or clear
+    Present          // Handed to the presentation engine, only valid as final usage
+};
+
+/**
+ * @struct RenderGraphResource
+ * @brief Handle to an image of the current frame's graph
+ */
+struct RenderGraphResource
+{
+    uint32_t index = UINT32_MAX;
+
+    bool isValid() const { return index != UINT32_MAX; }
+};
+
+/**
+ * @struct TransientImageDesc
+ * @brief Description of an image owned by the graph, which only lives during one frame
+ */
+struct TransientImageDesc
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+};
+
+/**
+ * @struct ImportedImage
+ * @brief Image owned outside the graph, whose state before and after the frame is known
+ */
+struct ImportedImage
+{
+    VkImage image = VK_NULL_HANDLE;
+    VkImageView view = VK_NULL_HANDLE;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkExtent2D extent = {0, 0};
+    ResourceUsage initialUsage = ResourceUsage::None; // Last access before the frame, waited on by the first pass
+    ResourceUsage finalUsage = ResourceUsage::None;   // Transitioned to after the last pass, None leaves it as is
+    bool preserveContents = true;                     // False discards the contents at the first access
+};
+
+/**
+ * @struct RenderGraphStats
+ * @brief Result of the last compilation
+ */
+struct RenderGraphStats
+{
+    uint32_t passCount = 0;
+    uint32_t culledPassCount = 0;
+    uint32_t transientImageCount = 0;
+    uint32_t barrierCount = 0;        // Image barriers, batched into one pipeline barrier per pass
+    VkDeviceSize transientMemory = 0; // Device memory backing the transient images
+    VkDeviceSize unaliasedMemory = 0; // Memory the transient images would need without aliasing
+};
+
+/**
+ * @class RenderGraph
+ * @brief Orders the passes of a frame from the images they declare, and synchronizes them
+ *
+ * The graph is rebuilt every frame: reset(), declare images and passes, compile(), execute().
+ * A pass reading an image runs after every pass writing it, and passes writing the same image
+ * run in declaration order. Passes whose writes are never read, and don't reach an imported
+ * image, are culled unless they have side effects. Image layout transitions and barriers are
+ * derived from the declared usages, only where an access actually conflicts with a previous one,
+ * and each barrier only waits for the stages that accessed its own image.
+ *
+ * Passes writing attachments get a render pass and framebuffer begun for them. Their load op is
+ * CLEAR when a clear value was given, LOAD when earlier passes wrote the image and DONT_CARE
+ * otherwise, and contents never read later are not stored.
+ *
+ * Transient images whose lifetimes don't overlap share device memory. Images and memory are kept
+ * between frames, and are only recreated when the transient images or their lifetimes change.
+ */
+class RenderGraph
+{
+public:
+    using ExecuteFn = std::function<void(VkCommandBuffer commandBuffer, const RenderGraph& graph)>;
+
+    /**
+     * @class PassBuilder
+     * @brief Declares the images accessed by a pass
+     */
+    class PassBuilder
+    {
+    public:
+        /**
+         * @brief Declare an image read by the pass
+         * @param resource Image to read
+         * @param usage DepthRead, ShaderRead, StorageRead or TransferSrc
+         * @return This builder
+         */
+        PassBuilder& read(RenderGraphResource resource, ResourceUsage usage);
+
+        /**
+         * @brief Declare an image written by the pass
+         * @param resource Image to write
+         * @param usage ColorAttachment, DepthAttachment, StorageWrite or TransferDst
+         * @return This builder
+         */
+        PassBuilder& write(RenderGraphResource resource, ResourceUsage usage);
+
+        /**
+         * @brief Clear an attachment of the pass when its render pass begins
+         * @param resource Attachment written by the pass
+         * @param value Clear color or depth
+         * @return This builder
+         */
+        PassBuilder& clear(RenderGraphResource resource, const VkClearValue& value);
+
+        /**
+         * @brief Keep the pass even if nothing reads its writes, e.g. for readbacks
+         * @return This builder
+         */
+        PassBuilder& setSideEffects();
+
+        /**
+         * @brief Begin the pass's render pass for secondary command buffers instead of inline commands
+         * @return This builder
+         */
+        PassBuilder& setSecondaryContents();
+
+    private:
+        friend class RenderGraph;
+
+        PassBuilder(RenderGraph& graph, uint32_t pass) : m_graph(graph), m_pass(pass) {}
+
+        RenderGraph& m_graph;
+        uint32_t m_pass;
+    };
+
+    RenderGraph() = default;
+    ~RenderGraph();
+
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+    /**
+     * @brief Initialize the graph for a device
+     * @param device Device creating the images, render passes and framebuffers
+     * @param allocator Allocator backing the transient images
+     * @param sync Barrier functions of the device
+     * @param deletionQueue Destroys replaced transient images once the frames using them have executed
+     */
+    void initialize(VkDevice device,
+                    VulkanAllocator& allocator,
+                    const VulkanSync& sync,
+                    VulkanDeletionQueue& deletionQueue);
+
+    /**
+     * @brief Destroy every object owned by the graph, the device must be idle
+     *
+     * The transient images go through the deletion queue, which has to be flushed afterwards.
+     */
+    void shutdown();
+
+    /**
+     * @brief Remove all images and passes to declare a new frame
+     */
+    void reset();
+
+    /**
+     * @brief Declare an image owned by the graph
+     * @param name Name used in error messages
+     * @param desc Size and format, the usage flags are derived from the passes
+     * @return Handle to the image
+     */
+    RenderGraphResource createImage(std::string name, const TransientImageDesc& desc);
+
+    /**
+     * @brief Declare an image owned outside the graph
+     * @param name Name used in error messages
+     * @param image Image and its state before and after the frame
+     * @return Handle to the image
+     */
+    RenderGraphResource importImage(std::string name, const ImportedImage& image);
+
+    /**
+     * @brief Add a pass to the frame
+     * @param name Name used in error messages
+     * @param execute Records the pass, inside its render pass if it writes attachments
+     * @return Builder to declare the images accessed by the pass
+     */
+    PassBuilder addPass(std::string name, ExecuteFn execute);
+
+    /**
+     * @brief Order and cull the passes, allocate transient images and compute the barriers
+     * @return True if the graph is valid, false otherwise
+     */
+    bool compile();
+
+    /**
+     * @brief Record the compiled passes and their barriers
+     * @param commandBuffer Primary command buffer, outside of a render pass
+     */
+    void execute(VkCommandBuffer commandBuffer);
+
+    /**
+     * @brief Get the Vulkan image of a resource, valid from compile() until the next reset()
+     * @param resource Image of the current frame
+     * @return Image handle
+     */
+    VkImage getImage(RenderGraphResource resource) const;
+
+    /**
+     * @brief Get the view of a resource, valid from compile() until the next reset()
+     * @param resource Image of the current frame
+     * @return View covering the whole image
+     */
+    VkImageView getImageView(RenderGraphResource resource) const;
+
+    /**
+     * @brief Get the size of a resource
+     * @param resource Image of the current frame
+     * @return Width and height in pixels
+     */
+    VkExtent2D getExtent(RenderGraphResource resource) const;
+
+    /**
+     * @brief Destroy the cached framebuffers, must be called before imported image views are destroyed
+     */
+    void releaseFramebuffers();
+
+    /**
+     * @brief Hand the cached framebuffers over instead of destroying them
+     *
+     * For imported image views that are replaced while frames in flight still use them, the
+     * caller destroys the framebuffers together with the views once those frames have executed.
+     *
+     * @return Framebuffers created so far, new ones are created on demand
+     */
+    std::vector<VkFramebuffer> detachFramebuffers();
+
+    /**
+     * @brief Get statistics of the last compilation
+     * @return Statistics
+     */
+    const RenderGraphStats& getStats() const { return m_stats; }
+
+private:
+    // Synchronization state of an image while the barriers are computed
+    struct ResourceState
+    {
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags writeStages = 0; // Last write or layout transition
+        VkAccessFlags writeAccess = 0;
+        VkPipelineStageFlags readStages = 0;    // Reads since the last write
+        VkPipelineStageFlags visibleStages = 0; // Stages the last write was made visible to
+        VkAccessFlags visibleAccess = 0;
+        bool hasContents = false;
+    };
+
+    struct Access
+    {
+        uint32_t resource;
+        ResourceUsage usage;
+        bool write;
+    };
+
+    struct Resource
+    {
+        std::string name;
+        bool imported = false;
+        ImportedImage image; // Image and view of transient images are filled by compile()
+        VkImageUsageFlags usageFlags = 0;
+        uint32_t firstPass = UINT32_MAX; // Execution order of the first and last pass using the image
+        uint32_t lastPass = 0;
+        uint32_t lastWriter = UINT32_MAX; // Declaration order of the last pass writing the image
+        uint32_t transient = UINT32_MAX;  // Index into m_transientImages
+        ResourceState state;
+    };
+
+    struct Pass
+    {
+        std::string name;
+        ExecuteFn execute;
+        std::vector<Access> accesses;
+        std::vector<std::pair<uint32_t, VkClearValue>> clears;
+        bool sideEffects = false;
+        bool secondaryContents = false;
+        bool culled = false;
+
+        // Filled by compile()
+        uint32_t firstBarrier = 0;
+        uint32_t barrierCount = 0;
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+        VkFramebuffer framebuffer = VK_NULL_HANDLE;
+        VkExtent2D extent = {0, 0};
+        std::vector<VkClearValue> clearValues; // One per attachment
+    };
+
+    // Transient image kept between frames, recreated when its key changes
+    struct TransientImage
+    {
+        TransientImageDesc desc;
+        VkImageUsageFlags usageFlags = 0;
+        uint32_t firstPass = 0;
+        uint32_t lastPass = 0;
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        uint32_t slot = 0;
+    };
+
+    // Memory shared by transient images with disjoint lifetimes
+    struct MemorySlot
+    {
+        VkMemoryRequirements requirements = {};
+        uint32_t lastPass = 0;
+        VulkanAllocation allocation;
+        ResourceState state; // Last access of the last image in the slot, waited on by the next one
+    };
+
+    void addAccess(uint32_t pass, RenderGraphResource resource, ResourceUsage usage, bool write);
+    bool validate() const;
+    bool sortPasses();
+    void cullPasses();
+    bool realizeTransientImages();
+    bool createTransientImages();
+    void destroyTransientImages();
+    bool compilePasses();
+    bool createRenderPass(Pass& pass, uint32_t position);
+    void transition(Resource& resource, ResourceUsage usage, bool write);
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    VulkanAllocator* m_allocator = nullptr;
+    const VulkanSync* m_sync = nullptr;
+    VulkanDeletionQueue* m_deletionQueue = nullptr;
+
+    std::vector<Resource> m_resources;
+    std::vector<Pass> m_passes;
+    std::vector<uint32_t> m_order; // Passes to execute, in execution order
+    std::vector<VkImageMemoryBarrier2> m_barriers;
+    uint32_t m_finalBarrier = 0; // Barriers from m_finalBarrier on transition imported images to their final usage
+    bool m_valid = true; // Cleared when a pass declares an invalid access
+    bool m_compiled = false;
+
+    std::vector<TransientImage> m_transientImages;
+    std::vector<MemorySlot> m_memorySlots;
+    std::map<std::vector<uint32_t>, VkRenderPass> m_renderPasses;
+    std::map<std::vector<uint64_t>, VkFramebuffer> m_framebuffers;
+
+    RenderGraphStats m_stats;
+};
+
+} // namespace graphyne::graphics
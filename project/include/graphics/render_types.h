@@ -0,0 +1,288 @@
+/**
+ * @file render_types.h
+ * @brief Backend independent resource handles and descriptions used by the renderer API
+ */
+#pragma once
+
+#include "graphics/texture_format.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace graphyne::graphics
+{
+
+/**
+ * @struct BufferHandle
+ * @brief Opaque reference to a GPU buffer, id 0 is invalid
+ */
+struct BufferHandle
+{
+    uint32_t id = 0;
+
+    bool isValid() const { return id != 0; }
+    bool operator==(const BufferHandle& other) const { return id == other.id; }
+    bool operator!=(const BufferHandle& other) const { return id != other.id; }
+};
+
+/**
+ * @struct TextureHandle
+ * @brief Opaque reference to a GPU texture, id 0 is invalid
+ */
+struct TextureHandle
+{
+    uint32_t id = 0;
+
+    bool isValid() const { return id != 0; }
+    bool operator==(const TextureHandle& other) const { return id == other.id; }
+    bool operator!=(const TextureHandle& other) const { return id != other.id; }
+};
+
+/**
+ * @struct PipelineHandle
+ * @brief Opaque reference to a graphics pipeline, id 0 is invalid
+ */
+struct PipelineHandle
+{
+    uint32_t id = 0;
+
+    bool isValid() const { return id != 0; }
+    bool operator==(const PipelineHandle& other) const { return id == other.id; }
+    bool operator!=(const PipelineHandle& other) const { return id != other.id; }
+};
+
+/**
+ * @brief Bindless index of resources that are not in a bindless array
+ */
+constexpr uint32_t INVALID_BINDLESS_INDEX = UINT32_MAX;
+
+/**
+ * @brief Push constant bytes available to pipelines in bindless mode, which all share one layout
+ */
+constexpr uint32_t MAX_BINDLESS_PUSH_CONSTANT_SIZE = 128;
+
+/**
+ * @enum BufferUsage
+ * @brief How a buffer is going to be used, values can be combined
+ */
+enum class BufferUsage : uint32_t
+{
+    Vertex = 1 << 0,
+    Index = 1 << 1,
+    Uniform = 1 << 2,
+    Storage = 1 << 3,
+    Indirect = 1 << 4
+};
+
+constexpr BufferUsage operator|(BufferUsage a, BufferUsage b)
+{
+    return static_cast<BufferUsage>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+}
+
+constexpr bool hasUsage(BufferUsage usage, BufferUsage flag)
+{
+    return (static_cast<uint32_t>(usage) & static_cast<uint32_t>(flag)) != 0;
+}
+
+/**
+ * @enum IndexType
+ * @brief Size of the indices in an index buffer
+ */
+enum class IndexType
+{
+    Uint16,
+    Uint32
+};
+
+/**
+ * @enum PrimitiveTopology
+ * @brief How vertices are assembled into primitives
+ */
+enum class PrimitiveTopology
+{
+    TriangleList,
+    TriangleStrip,
+    LineList,
+    PointList
+};
+
+/**
+ * @brief Count the triangles a draw assembles
+ * @param topology Topology of the pipeline
+ * @param vertexCount Vertices or indices of one instance
+ * @return Triangles of one instance, 0 for lines and points
+ */
+constexpr uint64_t getTriangleCount(PrimitiveTopology topology, uint32_t vertexCount)
+{
+    switch (topology)
+    {
+        case PrimitiveTopology::TriangleList:
+            return vertexCount / 3;
+        case PrimitiveTopology::TriangleStrip:
+            return vertexCount > 2 ? vertexCount - 2 : 0;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @enum VertexFormat
+ * @brief Data format of a single vertex attribute
+ */
+enum class VertexFormat
+{
+    Float,
+    Float2,
+    Float3,
+    Float4,
+    Unorm8x4
+};
+
+/**
+ * @struct VertexAttribute
+ * @brief Layout of one attribute inside an interleaved vertex
+ */
+struct VertexAttribute
+{
+    uint32_t location = 0;
+    uint32_t offset = 0;
+    VertexFormat format = VertexFormat::Float3;
+};
+
+/**
+ * @struct BufferDesc
+ * @brief Description of a buffer to create
+ */
+struct BufferDesc
+{
+    size_t size = 0;
+    BufferUsage usage = BufferUsage::Vertex;
+    bool hostVisible = false; // Keep the buffer CPU-writable, for data updated every frame
+    std::string debugName;
+};
+
+/**
+ * @struct TextureDesc
+ * @brief Description of a sampled texture to create
+ */
+struct TextureDesc
+{
+    uint32_t width = 1;
+    uint32_t height = 1;
+    uint32_t mipLevels = 1;
+    TextureFormat format = TextureFormat::Rgba8Unorm;
+    std::string debugName;
+};
+
+/**
+ * @struct PipelineDesc
+ * @brief Description of a graphics pipeline to create
+ */
+struct PipelineDesc
+{
+    std::string debugName;
+    std::vector<uint32_t> vertexShader;   // SPIR-V
+    std::vector<uint32_t> fragmentShader; // SPIR-V
+    uint32_t vertexStride = 0;
+    std::vector<VertexAttribute> vertexAttributes;
+    PrimitiveTopology topology = PrimitiveTopology::TriangleList;
+    bool alphaBlend = false;
+    uint32_t pushConstantSize = 0; // At most MAX_BINDLESS_PUSH_CONSTANT_SIZE in bindless mode
+    PipelineHandle fallback; // Simpler pipeline drawn with while this one compiles, draws are skipped if invalid
+};
+
+/**
+ * @struct DrawIndexedIndirectCommand
+ * @brief Arguments of one indexed draw read from a buffer, laid out like VkDrawIndexedIndirectCommand
+ */
+struct DrawIndexedIndirectCommand
+{
+    uint32_t indexCount = 0;
+    uint32_t instanceCount = 0;
+    uint32_t firstIndex = 0;
+    int32_t vertexOffset = 0;
+    uint32_t firstInstance = 0;
+};
+
+/**
+ * @struct GpuCullObject
+ * @brief One object tested by GPU culling, stored in a storage buffer with std430 layout
+ */
+struct GpuCullObject
+{
+    float boundingSphere[4] = {0.0f, 0.0f, 0.0f, 0.0f}; // World space center and radius
+    uint32_t indexCount = 0;
+    uint32_t firstIndex = 0;
+    int32_t vertexOffset = 0;
+    uint32_t drawGroup = 0; // Indirect draw the object is compacted into, e.g. one group per pipeline
+};
+
+/**
+ * @struct GpuCullDesc
+ * @brief Buffers and view of one GPU culling pass
+ *
+ * Visible objects are written as one draw command each, with instanceCount 1 and the object's
+ * index as firstInstance, so vertex shaders find their per-object data through gl_InstanceIndex.
+ * Commands of group g start at element g * maxDrawsPerGroup of drawCommands, and the number of
+ * visible objects of group g is written to element g of drawCounts.
+ */
+struct GpuCullDesc
+{
+    BufferHandle objects;      // Storage buffer of objectCount GpuCullObject
+    BufferHandle drawCommands; // Storage and indirect buffer of groupCount * maxDrawsPerGroup commands
+    BufferHandle drawCounts;   // Storage and indirect buffer of groupCount uint32_t
+    uint32_t objectCount = 0;
+    uint32_t groupCount = 1;
+    uint32_t maxDrawsPerGroup = 0;  // Visible objects past this count are dropped
+    float frustumPlanes[6][4] = {}; // Normalized planes (a, b, c, d) facing inside, ax + by + cz + d >= 0
+};
+
+/**
+ * @struct PipelineStatistics
+ * @brief Shader invocations and primitives counted by the GPU over a frame
+ */
+struct PipelineStatistics
+{
+    bool available = false;  // Only measured with Renderer::Config::pipelineStatistics on a supporting device
+    uint64_t frameIndex = 0; // Frame the statistics were measured in
+    uint64_t inputPrimitives = 0;
+    uint64_t vertexInvocations = 0;
+    uint64_t clippedPrimitives = 0; // Primitives left after clipping
+    uint64_t fragmentInvocations = 0;
+    uint64_t computeInvocations = 0;
+};
+
+/**
+ * @struct RenderStats
+ * @brief Work recorded by the renderer in one frame
+ */
+struct RenderStats
+{
+    uint64_t frameIndex = 0; // Frames ended before this one
+    uint64_t drawCalls = 0;
+    uint64_t indirectDrawCalls = 0; // Draw counts are read by the GPU, so their draws are not counted
+    uint64_t dispatches = 0;
+    uint64_t triangles = 0; // Triangles of the draws counted in drawCalls, over all instances
+    uint64_t pipelineBinds = 0;
+    uint64_t descriptorBinds = 0; // Descriptor sets bound
+    uint64_t bytesUploaded = 0;   // Including uploads made outside of a frame since the previous one ended
+    uint64_t barriers = 0;        // Memory, buffer and image barriers
+
+    // From a recent frame, GPU results arrive once the frames in flight ahead of them have executed
+    PipelineStatistics pipelineStatistics;
+};
+
+/**
+ * @struct GpuPassTiming
+ * @brief GPU time of one measured scope of a frame, such as a render graph pass
+ */
+struct GpuPassTiming
+{
+    const char* name = nullptr; // Valid for the lifetime of the profiler
+    uint32_t depth = 0;         // Number of enclosing scopes, 0 for the whole frame
+    double milliseconds = 0.0;
+};
+
+} // namespace graphyne::graphics
@@ -4,8 +4,13 @@
  */
 #pragma once
 
+#include "graphics/command_recorder.h"
+#include "graphics/render_types.h"
+
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace graphyne::platform
 {
@@ -22,24 +27,56 @@ namespace graphyne::graphics
 class Renderer
 {
 public:
+    /**
+     * @enum Backend
+     * @brief Available rendering backends
+     */
+    enum class Backend
+    {
+        Vulkan, // Hardware rendering through Vulkan
+        Null    // No GPU work, for headless servers and CPU benchmarks
+    };
+
+    /**
+     * @enum PresentLatency
+     * @brief Present mode used when vsync is disabled, the other mode is the fallback if it is unsupported
+     */
+    enum class PresentLatency
+    {
+        LowLatency, // MAILBOX, the newest frame replaces queued ones without tearing
+        Uncapped    // IMMEDIATE, frames are shown as soon as they are rendered and may tear
+    };
+
     /**
      * @struct Config
      * @brief Configuration options for the renderer
      */
     struct Config
     {
+        Backend backend = Backend::Vulkan;
         std::string appName = "Graphyne Application";
         uint32_t appVersion = 1;
         bool enableValidation = true;
         bool enableVSync = true;
+        PresentLatency presentLatency = PresentLatency::LowLatency;
+        bool offscreen = false; // Render into offscreen images instead of a window swapchain
+        uint32_t width = 1280;  // Size of the offscreen render target
+        uint32_t height = 720;
+        uint32_t framesInFlight = 2;             // Frames the CPU may record ahead of the GPU
+        std::string pipelineCachePath;           // File the pipeline cache persists in, empty keeps it in memory
+        double pipelineCacheSaveInterval = 60.0; // Seconds between saves of new pipelines, 0 saves at shutdown only
+        bool asyncPipelineCompilation = true;    // Compile pipelines on worker threads instead of in createPipeline
+        bool bindless = false;                   // Index textures and storage buffers from shaders, if supported
+        size_t uploadBufferSize = 32 << 20;      // Staging ring of buffer and texture uploads, in bytes
+        bool pipelineStatistics = false;         // Count shader invocations on the GPU every frame, if supported
     };
 
     /**
      * @brief Constructor
-     * @param window Window to render to
+     * @param window Window to render to, or nullptr when running without a window
      * @param config Renderer configuration
      */
-    Renderer(platform::Window& window, const Config& config = Config{});
+    Renderer(platform::Window* window, const Config& config = Config{});
 
     /**
      * @brief Virtual destructor
@@ -85,16 +122,246 @@ public:
      */
     virtual void onResize(int width, int height) = 0;
 
+    /**
+     * @brief Create a buffer
+     * @param desc Buffer description
+     * @param initialData Optional data of desc.size bytes to upload
+     * @return Handle to the buffer, invalid on failure
+     */
+    virtual BufferHandle createBuffer(const BufferDesc& desc, const void* initialData = nullptr) = 0;
+
+    /**
+     * @brief Upload data into a buffer
+     * @param buffer Destination buffer
+     * @param data Source data
+     * @param size Number of bytes to upload
+     * @param offset Byte offset into the buffer
+     */
+    virtual void updateBuffer(BufferHandle buffer, const void* data, size_t size, size_t offset = 0) = 0;
+
+    /**
+     * @brief Destroy a buffer, frames already recorded may still use it
+     * @param buffer Buffer to destroy
+     */
+    virtual void destroyBuffer(BufferHandle buffer) = 0;
+
+    /**
+     * @brief Create a sampled texture
+     * @param desc Texture description
+     * @return Handle to the texture, invalid on failure
+     */
+    virtual TextureHandle createTexture(const TextureDesc& desc) = 0;
+
+    /**
+     * @brief Upload the contents of one mip level
+     * @param texture Destination texture
+     * @param mipLevel Mip level to fill
+     * @param data Tightly packed texel or block data
+     * @param size Number of bytes to upload
+     */
+    virtual void updateTexture(TextureHandle texture, uint32_t mipLevel, const void* data, size_t size) = 0;
+
+    /**
+     * @brief Destroy a texture, frames already recorded may still use it
+     * @param texture Texture to destroy
+     */
+    virtual void destroyTexture(TextureHandle texture) = 0;
+
+    /**
+     * @brief Check if textures and storage buffers are addressed by index from shaders
+     * @return True if bindless mode was requested and is supported, false otherwise
+     */
+    virtual bool isBindless() const = 0;
+
+    /**
+     * @brief Get the index of a texture in the bindless texture array
+     *
+     * Shaders read every texture through one array bound for the whole frame, so draws using
+     * different textures need no binds between them. The index is typically passed to shaders
+     * in push constants or a storage buffer, and stays valid until the texture is destroyed.
+     *
+     * @param texture Texture to look up
+     * @return Index into the texture array, INVALID_BINDLESS_INDEX outside of bindless mode
+     */
+    virtual uint32_t getBindlessIndex(TextureHandle texture) const = 0;
+
+    /**
+     * @brief Get the index of a storage buffer in the bindless buffer array
+     * @param buffer Buffer created with BufferUsage::Storage
+     * @return Index into the buffer array, INVALID_BINDLESS_INDEX outside of bindless mode or for other buffers
+     */
+    virtual uint32_t getBindlessIndex(BufferHandle buffer) const = 0;
+
+    /**
+     * @brief Create a graphics pipeline
+     *
+     * Backends may compile the pipeline in the background. Until it is ready, draws
+     * bound to it use PipelineDesc::fallback, or are skipped when there is none.
+     *
+     * @param desc Pipeline description
+     * @return Handle to the pipeline, invalid on failure
+     */
+    virtual PipelineHandle createPipeline(const PipelineDesc& desc) = 0;
+
+    /**
+     * @brief Destroy a graphics pipeline, frames already recorded may still use it
+     * @param pipeline Pipeline to destroy
+     */
+    virtual void destroyPipeline(PipelineHandle pipeline) = 0;
+
+    /**
+     * @brief Check if a pipeline has finished compiling
+     * @param pipeline Pipeline to check
+     * @return True if draws use the pipeline itself, false while compiling, after a failure or for invalid handles
+     */
+    virtual bool isPipelineReady(PipelineHandle pipeline) const = 0;
+
+    /**
+     * @brief Bind the pipeline used by the following draws
+     * @param pipeline Pipeline to bind
+     */
+    virtual void bindPipeline(PipelineHandle pipeline) = 0;
+
+    /**
+     * @brief Bind the vertex buffer used by the following draws
+     * @param buffer Vertex buffer
+     * @param offset Byte offset of the first vertex
+     */
+    virtual void bindVertexBuffer(BufferHandle buffer, size_t offset = 0) = 0;
+
+    /**
+     * @brief Bind the index buffer used by the following indexed draws
+     * @param buffer Index buffer
+     * @param type Size of the indices
+     * @param offset Byte offset of the first index
+     */
+    virtual void bindIndexBuffer(BufferHandle buffer, IndexType type, size_t offset = 0) = 0;
+
+    /**
+     * @brief Set push constant data for the following draws
+     * @param data Source data
+     * @param size Number of bytes, at most the pipeline's push constant size
+     * @param offset Byte offset into the push constant range
+     */
+    virtual void pushConstants(const void* data, uint32_t size, uint32_t offset = 0) = 0;
+
+    /**
+     * @brief Draw non-indexed primitives
+     * @param vertexCount Number of vertices
+     * @param instanceCount Number of instances
+     * @param firstVertex Index of the first vertex
+     * @param firstInstance Index of the first instance
+     */
+    virtual void draw(uint32_t vertexCount,
+                      uint32_t instanceCount = 1,
+                      uint32_t firstVertex = 0,
+                      uint32_t firstInstance = 0) = 0;
+
+    /**
+     * @brief Draw indexed primitives
+     * @param indexCount Number of indices
+     * @param instanceCount Number of instances
+     * @param firstIndex Index of the first index
+     * @param vertexOffset Value added to each index
+     * @param firstInstance Index of the first instance
+     */
+    virtual void drawIndexed(uint32_t indexCount,
+                             uint32_t instanceCount = 1,
+                             uint32_t firstIndex = 0,
+                             int32_t vertexOffset = 0,
+                             uint32_t firstInstance = 0) = 0;
+
+    /**
+     * @brief Draw indexed primitives with arguments and a draw count read from buffers
+     * @param commands Buffer of DrawIndexedIndirectCommand, created with BufferUsage::Indirect
+     * @param offset Byte offset of the first command
+     * @param count Buffer holding the draw count as a uint32_t, created with BufferUsage::Indirect
+     * @param countOffset Byte offset of the draw count
+     * @param maxDrawCount Maximum number of draws, the draw count is clamped to it
+     */
+    virtual void drawIndexedIndirectCount(BufferHandle commands,
+                                          size_t offset,
+                                          BufferHandle count,
+                                          size_t countOffset,
+                                          uint32_t maxDrawCount) = 0;
+
+    /**
+     * @brief Check if the backend can cull on the GPU and draw with indirect counts
+     * @return True if cullDraws() and drawIndexedIndirectCount() are supported, false otherwise
+     */
+    virtual bool supportsGpuCulling() const = 0;
+
+    /**
+     * @brief Cull objects against the view frustum on the GPU and write indirect draws for the visible ones
+     *
+     * The pass runs before every draw of the frame, and before the passes of its render graph,
+     * whichever call of the frame it is made from. Its results are consumed by issuing one
+     * drawIndexedIndirectCount() per draw group, which keeps the CPU cost of large scenes
+     * independent of their object count. Only valid between beginFrame() and endFrame().
+     *
+     * @param desc Objects, output buffers and view frustum
+     */
+    virtual void cullDraws(const GpuCullDesc& desc) = 0;
+
+    /**
+     * @brief Records the draws of items [begin, end) of a parallel recording
+     */
+    using RecordJob = std::function<void(CommandRecorder& recorder, uint32_t begin, uint32_t end)>;
+
+    /**
+     * @brief Record the draws of many items on the worker threads
+     *
+     * The items are split into batches recorded concurrently, each into its own recorder.
+     * Batches execute in item order, after the draws issued before this call and before
+     * the ones issued after it, which start again with nothing bound. Only valid between
+     * beginFrame() and endFrame(), and resources must not be created or destroyed meanwhile.
+     *
+     * The calling thread records batches as well. While it waits for the batches taken by the
+     * workers it runs no other jobs, so background compiles and cooks cannot extend the call.
+     *
+     * @param count Number of items
+     * @param batchSize Items per batch, 0 picks a size based on the worker count
+     * @param job Function recording one batch, called from several threads
+     */
+    virtual void recordParallel(uint32_t count, uint32_t batchSize, const RecordJob& job) = 0;
+
+    /**
+     * @brief Get the GPU time of the passes of a recent frame
+     *
+     * Timings are read back once the GPU finished a frame, so they lag the frame being
+     * recorded by the number of frames in flight. Scopes are only measured if the backend
+     * supports timestamps, and passes only if GRAPHYNE_ENABLE_PROFILING is on.
+     *
+     * @return Timings in the order the scopes began, empty if nothing was measured
+     */
+    virtual const std::vector<GpuPassTiming>& getGpuTimings() const = 0;
+
+    /**
+     * @brief Get the counters of the last ended frame
+     *
+     * Counters are collected in every build, at the cost of a few increments per call, so
+     * they can back overlays and automated checks of draw efficiency.
+     *
+     * @return Statistics of the frame ended by the last endFrame() call
+     */
+    virtual const RenderStats& getStats() const = 0;
+
+    /**
+     * @brief Get the renderer configuration
+     * @return Configuration the renderer was created with
+     */
+    const Config& getConfig() const { return m_config; }
+
     /**
      * @brief Create a concrete renderer instance based on the selected backend
-     * @param window Window to render to
-     * @param config Renderer configuration
-     * @return Unique pointer to the created renderer
+     * @param window Window to render to, or nullptr when running without a window
+     * @param config Renderer configuration, its backend field selects the implementation
+     * @return Unique pointer to the created renderer, initialize() still has to be called
      */
-    static std::unique_ptr<Renderer> create(platform::Window& window, const Config& config = Config{});
+    static std::unique_ptr<Renderer> create(platform::Window* window, const Config& config = Config{});
 
 protected:
-    platform::Window& m_window;
+    platform::Window* m_window;
     Config m_config;
 };
 
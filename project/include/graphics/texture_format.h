@@ -0,0 +1,111 @@
+/**
+ * @file texture_format.h
+ * @brief GPU texture formats and size helpers shared by the renderer and asset cookers
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace graphyne::graphics
+{
+
+/**
+ * @enum TextureFormat
+ * @brief Pixel formats a texture can be uploaded with
+ */
+enum class TextureFormat : uint32_t
+{
+    Rgba8Unorm,  // Uncompressed 8-bit RGBA
+    Rgba8Srgb,   // Uncompressed 8-bit RGBA, sRGB encoded color
+    Rgba16Float, // Uncompressed half-float RGBA for HDR content
+    Bc1Unorm,    // 4 bpp RGB
+    Bc1Srgb,     // 4 bpp RGB, sRGB encoded
+    Bc3Unorm,    // 8 bpp RGBA with interpolated alpha
+    Bc3Srgb,     // 8 bpp RGBA with interpolated alpha, sRGB encoded color
+    Bc5Unorm,    // 8 bpp two-channel, used for tangent-space normal maps
+    Bc7Unorm,    // 8 bpp high quality RGBA
+    Bc7Srgb      // 8 bpp high quality RGBA, sRGB encoded color
+};
+
+/**
+ * @brief Check if a format is block compressed
+ * @param format Format to check
+ * @return True for BC formats, false for uncompressed formats
+ */
+constexpr bool isCompressed(TextureFormat format)
+{
+    return format != TextureFormat::Rgba8Unorm && format != TextureFormat::Rgba8Srgb &&
+           format != TextureFormat::Rgba16Float;
+}
+
+/**
+ * @brief Check if a format stores sRGB encoded color
+ * @param format Format to check
+ * @return True if the GPU decodes the color channels from sRGB, false otherwise
+ */
+constexpr bool isSrgb(TextureFormat format)
+{
+    return format == TextureFormat::Rgba8Srgb || format == TextureFormat::Bc1Srgb ||
+           format == TextureFormat::Bc3Srgb || format == TextureFormat::Bc7Srgb;
+}
+
+/**
+ * @brief Get the size of one texel, or of one 4x4 block for compressed formats
+ * @param format Format to query
+ * @return Size in bytes
+ */
+constexpr size_t getBlockSize(TextureFormat format)
+{
+    switch (format)
+    {
+        case TextureFormat::Rgba8Unorm:
+        case TextureFormat::Rgba8Srgb:
+            return 4;
+        case TextureFormat::Rgba16Float:
+        case TextureFormat::Bc1Unorm:
+        case TextureFormat::Bc1Srgb:
+            return 8;
+        default:
+            return 16;
+    }
+}
+
+/**
+ * @brief Compute the number of bytes used by one mip level
+ * @param format Format of the texture
+ * @param width Width of the mip level in texels
+ * @param height Height of the mip level in texels
+ * @return Size in bytes
+ */
+constexpr size_t getMipSize(TextureFormat format, uint32_t width, uint32_t height)
+{
+    if (isCompressed(format))
+    {
+        size_t blocksX = std::max(1u, (width + 3) / 4);
+        size_t blocksY = std::max(1u, (height + 3) / 4);
+        return blocksX * blocksY * getBlockSize(format);
+    }
+    return static_cast<size_t>(width) * height * getBlockSize(format);
+}
+
+/**
+ * @brief Compute the length of a full mip chain
+ * @param width Width of the base level
+ * @param height Height of the base level
+ * @return Number of mip levels down to 1x1
+ */
+constexpr uint32_t getFullMipCount(uint32_t width, uint32_t height)
+{
+    uint32_t levels = 1;
+    uint32_t size = std::max(width, height);
+    while (size > 1)
+    {
+        size >>= 1;
+        ++levels;
+    }
+    return levels;
+}
+
+} // namespace graphyne::graphics
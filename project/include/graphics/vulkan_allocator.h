@@ -0,0 +1,215 @@
+/**
+ * @file vulkan_allocator.h
+ * @brief Device memory sub-allocator for the Vulkan backend
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace graphyne::graphics
+{
+
+/**
+ * @enum MemoryUsage
+ * @brief Intended access pattern of an allocation, used to pick the memory type
+ */
+enum class MemoryUsage
+{
+    GpuOnly,  // Device local, written through transfers
+    CpuToGpu, // Host visible and persistently mapped, written by the CPU every frame or used for staging
+    GpuToCpu  // Host visible and cached when possible, for readbacks
+};
+
+/**
+ * @struct VulkanAllocation
+ * @brief Range of device memory backing one buffer or image
+ */
+struct VulkanAllocation
+{
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+    void* mapped = nullptr; // Persistent mapping of the range, null for device local memory
+    uint32_t memoryType = 0;
+    uint32_t block = 0; // Index of the owning block, DEDICATED_BLOCK for dedicated allocations
+    uint32_t chunk = 0; // Sub-allocation inside the block
+
+    static constexpr uint32_t DEDICATED_BLOCK = UINT32_MAX;
+
+    bool isValid() const { return memory != VK_NULL_HANDLE; }
+    bool isDedicated() const { return block == DEDICATED_BLOCK; }
+};
+
+/**
+ * @struct HeapStats
+ * @brief Memory usage of one memory heap
+ */
+struct HeapStats
+{
+    VkDeviceSize heapSize = 0;
+    VkDeviceSize allocatedBytes = 0; // Device memory allocated from the driver
+    VkDeviceSize usedBytes = 0;      // Bytes handed out to resources
+    uint32_t blockCount = 0;
+    uint32_t dedicatedCount = 0;
+    uint32_t allocationCount = 0;
+    bool deviceLocal = false;
+};
+
+/**
+ * @class VulkanAllocator
+ * @brief Allocates large device memory blocks per memory type and sub-allocates resources from them
+ *
+ * Each block is managed with a two-level segregated fit (TLSF) allocator, so allocation and
+ * free are O(1) and keep fragmentation low. Resources larger than half a block get a dedicated
+ * VkDeviceMemory. When bufferImageGranularity is above 1, linear resources (buffers) and
+ * optimal tiling images come from separate blocks so they never share a granularity page.
+ * Host visible blocks are mapped once when they are created and stay mapped.
+ *
+ * Device memory in use is reported to the MemoryManager as AllocationType::Graphics.
+ * All functions are thread-safe.
+ */
+class VulkanAllocator
+{
+public:
+    VulkanAllocator();
+    ~VulkanAllocator();
+
+    VulkanAllocator(const VulkanAllocator&) = delete;
+    VulkanAllocator& operator=(const VulkanAllocator&) = delete;
+
+    /**
+     * @brief Initialize the allocator for a device
+     * @param physicalDevice Physical device to query memory properties from
+     * @param device Device to allocate memory from
+     * @param blockSize Size of the blocks, smaller heaps use an eighth of the heap size instead
+     * @return True if initialization succeeded, false otherwise
+     */
+    bool initialize(VkPhysicalDevice physicalDevice, VkDevice device, VkDeviceSize blockSize = 64 * 1024 * 1024);
+
+    /**
+     * @brief Free all device memory, every allocation must have been freed before
+     */
+    void shutdown();
+
+    /**
+     * @brief Create a buffer and bind memory to it
+     * @param createInfo Buffer description
+     * @param usage Intended access pattern
+     * @param buffer Receives the created buffer
+     * @param allocation Receives the memory bound to the buffer
+     * @return True if the buffer was created, false otherwise
+     */
+    bool createBuffer(const VkBufferCreateInfo& createInfo,
+                      MemoryUsage usage,
+                      VkBuffer& buffer,
+                      VulkanAllocation& allocation);
+
+    /**
+     * @brief Destroy a buffer created with createBuffer() and free its memory
+     * @param buffer Buffer to destroy
+     * @param allocation Memory bound to the buffer, reset on return
+     */
+    void destroyBuffer(VkBuffer buffer, VulkanAllocation& allocation);
+
+    /**
+     * @brief Create an image and bind memory to it
+     * @param createInfo Image description
+     * @param usage Intended access pattern
+     * @param image Receives the created image
+     * @param allocation Receives the memory bound to the image
+     * @return True if the image was created, false otherwise
+     */
+    bool createImage(const VkImageCreateInfo& createInfo,
+                     MemoryUsage usage,
+                     VkImage& image,
+                     VulkanAllocation& allocation);
+
+    /**
+     * @brief Destroy an image created with createImage() and free its memory
+     * @param image Image to destroy
+     * @param allocation Memory bound to the image, reset on return
+     */
+    void destroyImage(VkImage image, VulkanAllocation& allocation);
+
+    /**
+     * @brief Allocate memory for custom resources
+     * @param requirements Size, alignment and allowed memory types
+     * @param usage Intended access pattern
+     * @param linear True for buffers and linear images, false for optimal tiling images
+     * @param allocation Receives the allocated range
+     * @return True if the memory was allocated, false otherwise
+     */
+    bool allocate(const VkMemoryRequirements& requirements,
+                  MemoryUsage usage,
+                  bool linear,
+                  VulkanAllocation& allocation);
+
+    /**
+     * @brief Free memory returned by allocate()
+     * @param allocation Allocation to free, reset on return
+     */
+    void free(VulkanAllocation& allocation);
+
+    /**
+     * @brief Make host writes to a mapped allocation visible to the device, a no-op for coherent memory
+     * @param allocation Allocation that was written
+     * @param offset Offset of the written range inside the allocation
+     * @param size Size of the written range, VK_WHOLE_SIZE for the rest of the allocation
+     */
+    void flush(const VulkanAllocation& allocation, VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+
+    /**
+     * @brief Make device writes to a mapped allocation visible to the host, a no-op for coherent memory
+     * @param allocation Allocation to read
+     * @param offset Offset of the range inside the allocation
+     * @param size Size of the range, VK_WHOLE_SIZE for the rest of the allocation
+     */
+    void invalidate(const VulkanAllocation& allocation, VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+
+    /**
+     * @brief Get the usage of every memory heap
+     * @return One entry per heap of the physical device
+     */
+    std::vector<HeapStats> getHeapStats() const;
+
+    /**
+     * @brief Log the usage of every memory heap
+     */
+    void logStatistics() const;
+
+private:
+    class Block;
+
+    bool findMemoryTypes(uint32_t typeBits, MemoryUsage usage, std::vector<uint32_t>& types) const;
+    bool allocateFromType(uint32_t memoryType,
+                          const VkMemoryRequirements& requirements,
+                          bool linear,
+                          VulkanAllocation& allocation);
+    bool allocateDedicated(uint32_t memoryType, VkDeviceSize size, VulkanAllocation& allocation);
+    VkResult allocateDeviceMemory(uint32_t memoryType, VkDeviceSize size, VkDeviceMemory& memory, void*& mapped);
+    void freeDeviceMemory(uint32_t memoryType, VkDeviceSize size, VkDeviceMemory memory);
+    VkMappedMemoryRange getMappedRange(const VulkanAllocation& allocation, VkDeviceSize offset, VkDeviceSize size) const;
+    VkDeviceSize getBlockSize(uint32_t memoryType) const;
+    bool isHostVisible(uint32_t memoryType) const;
+    bool isCoherent(uint32_t memoryType) const;
+    uint32_t getHeapIndex(uint32_t memoryType) const;
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    VkPhysicalDeviceMemoryProperties m_memoryProperties = {};
+    VkDeviceSize m_blockSize = 0;
+    VkDeviceSize m_bufferImageGranularity = 1;
+    VkDeviceSize m_nonCoherentAtomSize = 1;
+    uint32_t m_maxAllocationCount = 0;
+
+    mutable std::mutex m_mutex;
+    std::array<std::vector<std::unique_ptr<Block>>, VK_MAX_MEMORY_TYPES> m_blocks; // Freed blocks leave a null entry
+    std::array<HeapStats, VK_MAX_MEMORY_HEAPS> m_heapStats = {};
+    uint32_t m_deviceAllocationCount = 0;
+};
+
+} // namespace graphyne::graphics
@@ -0,0 +1,115 @@
+/**
+ * @file vulkan_bindless.h
+ * @brief Descriptor set holding every texture and storage buffer, indexed from shaders
+ */
+#pragma once
+
+#include "graphics/render_types.h"
+
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace graphyne::graphics
+{
+
+/**
+ * @class VulkanBindlessHeap
+ * @brief One update-after-bind descriptor set with large arrays of textures and storage buffers
+ *
+ * The set is bound once per command buffer and every resource is addressed by its array index,
+ * so draws using different resources need no descriptor binds between them. Shaders declare:
+ *
+ *     layout(set = 0, binding = 0) uniform sampler2D textures[];
+ *     layout(set = 0, binding = 1) buffer Buffers { uint data[]; } buffers[];
+ *
+ * and index them with nonuniformEXT() when the index is not dynamically uniform. The arrays are
+ * partially bound, only slots handed out by add*() may be accessed. Slots are written while the
+ * set is bound by pending command buffers, which update-after-bind allows as long as the slot is
+ * not used by them, so an index must not be released before the GPU stopped using it.
+ */
+class VulkanBindlessHeap
+{
+public:
+    static constexpr uint32_t TEXTURE_BINDING = 0;
+    static constexpr uint32_t BUFFER_BINDING = 1;
+
+    VulkanBindlessHeap() = default;
+    ~VulkanBindlessHeap();
+
+    VulkanBindlessHeap(const VulkanBindlessHeap&) = delete;
+    VulkanBindlessHeap& operator=(const VulkanBindlessHeap&) = delete;
+
+    /**
+     * @brief Create the descriptor set, sized to the device's update-after-bind limits
+     * @param physicalDevice Physical device, descriptor indexing must be enabled on the device
+     * @param device Device to create the descriptor set on
+     * @return True if the descriptor set was created, false otherwise
+     */
+    bool initialize(VkPhysicalDevice physicalDevice, VkDevice device);
+
+    /**
+     * @brief Destroy the descriptor set, the device must be idle
+     */
+    void shutdown();
+
+    /**
+     * @brief Write a texture into a free slot of the texture array
+     * @param view View of the texture, in SHADER_READ_ONLY_OPTIMAL layout when sampled
+     * @return Slot index, INVALID_BINDLESS_INDEX if the array is full
+     */
+    uint32_t addTexture(VkImageView view);
+
+    /**
+     * @brief Write a storage buffer into a free slot of the buffer array
+     * @param buffer Buffer created with VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+     * @return Slot index, INVALID_BINDLESS_INDEX if the array is full
+     */
+    uint32_t addBuffer(VkBuffer buffer);
+
+    /**
+     * @brief Free a texture slot, no pending command buffer may still access it
+     * @param index Slot returned by addTexture(), INVALID_BINDLESS_INDEX is ignored
+     */
+    void removeTexture(uint32_t index);
+
+    /**
+     * @brief Free a buffer slot, no pending command buffer may still access it
+     * @param index Slot returned by addBuffer(), INVALID_BINDLESS_INDEX is ignored
+     */
+    void removeBuffer(uint32_t index);
+
+    /**
+     * @brief Get the layout of the descriptor set, set 0 of every bindless pipeline layout
+     * @return Descriptor set layout
+     */
+    VkDescriptorSetLayout getLayout() const { return m_layout; }
+
+    /**
+     * @brief Get the descriptor set to bind
+     * @return Descriptor set
+     */
+    VkDescriptorSet getSet() const { return m_set; }
+
+private:
+    // Slots of one array, freed slots are reused before the array grows
+    struct SlotAllocator
+    {
+        uint32_t capacity = 0;
+        uint32_t nextSlot = 0;
+        std::vector<uint32_t> freeSlots;
+
+        uint32_t allocate();
+        void release(uint32_t slot);
+    };
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    VkDescriptorSetLayout m_layout = VK_NULL_HANDLE;
+    VkDescriptorPool m_pool = VK_NULL_HANDLE;
+    VkDescriptorSet m_set = VK_NULL_HANDLE;
+    VkSampler m_sampler = VK_NULL_HANDLE; // Trilinear repeat sampler combined with every texture
+    SlotAllocator m_textures;
+    SlotAllocator m_buffers;
+};
+
+} // namespace graphyne::graphics
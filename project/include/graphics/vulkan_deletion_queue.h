@@ -0,0 +1,165 @@
+/**
+ * @file vulkan_deletion_queue.h
+ * @brief Deferred destruction of Vulkan objects that frames in flight may still use
+ */
+#pragma once
+
+#include "graphics/vulkan_allocator.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <utility>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace graphyne::graphics
+{
+
+/**
+ * @class VulkanDeletionQueue
+ * @brief Holds released objects until the GPU has executed every submission that may use them
+ *
+ * Objects are tagged with the retire value set by the owner, the timeline value signaled by the
+ * last submission that can reference them, and destroyed by collect() once the timeline reached
+ * it. Releasing a resource therefore never waits for the device, no matter how many frames are
+ * in flight. Retire values never decrease, so objects are kept in buckets in release order and
+ * collect() only looks at the oldest ones.
+ *
+ * Within a bucket, objects are destroyed before the objects they may reference: framebuffers
+ * before image views, image views before images, and images before aliased memory. Callbacks
+ * run last, for releases that are not Vulkan objects, like bindless descriptor slots.
+ */
+class VulkanDeletionQueue
+{
+public:
+    VulkanDeletionQueue() = default;
+    ~VulkanDeletionQueue();
+
+    VulkanDeletionQueue(const VulkanDeletionQueue&) = delete;
+    VulkanDeletionQueue& operator=(const VulkanDeletionQueue&) = delete;
+
+    /**
+     * @brief Initialize the queue for a device
+     * @param device Device owning the objects
+     * @param allocator Allocator the memory of buffers and images is returned to
+     */
+    void initialize(VkDevice device, VulkanAllocator& allocator);
+
+    /**
+     * @brief Destroy every pending object, the device must be idle
+     */
+    void shutdown();
+
+    /**
+     * @brief Set the timeline value tagged on objects released from now on
+     * @param value Value signaled by the last submission that may use them, never lower than before
+     */
+    void setRetireValue(uint64_t value);
+
+    /**
+     * @brief Get the timeline value tagged on released objects
+     * @return Retire value
+     */
+    uint64_t getRetireValue() const { return m_retireValue; }
+
+    /**
+     * @brief Release a buffer created with VulkanAllocator::createBuffer()
+     * @param buffer Buffer to destroy
+     * @param allocation Memory bound to the buffer, reset on return
+     */
+    void destroyBuffer(VkBuffer buffer, VulkanAllocation& allocation);
+
+    /**
+     * @brief Release an image, with its memory if it was created with VulkanAllocator::createImage()
+     * @param image Image to destroy
+     * @param allocation Memory bound to the image, reset on return, invalid for aliased memory
+     */
+    void destroyImage(VkImage image, VulkanAllocation& allocation);
+
+    /**
+     * @brief Release memory returned by VulkanAllocator::allocate()
+     * @param allocation Allocation to free, reset on return
+     */
+    void free(VulkanAllocation& allocation);
+
+    /**
+     * @brief Release an image view
+     * @param imageView Image view to destroy
+     */
+    void destroyImageView(VkImageView imageView);
+
+    /**
+     * @brief Release a framebuffer
+     * @param framebuffer Framebuffer to destroy
+     */
+    void destroyFramebuffer(VkFramebuffer framebuffer);
+
+    /**
+     * @brief Release a pipeline
+     * @param pipeline Pipeline to destroy
+     */
+    void destroyPipeline(VkPipeline pipeline);
+
+    /**
+     * @brief Release a pipeline layout
+     * @param pipelineLayout Pipeline layout to destroy
+     */
+    void destroyPipelineLayout(VkPipelineLayout pipelineLayout);
+
+    /**
+     * @brief Release a descriptor pool and the sets allocated from it
+     * @param descriptorPool Descriptor pool to destroy
+     */
+    void destroyDescriptorPool(VkDescriptorPool descriptorPool);
+
+    /**
+     * @brief Run a function once the GPU is done with the current retire value
+     * @param release Function releasing something the submissions may still use
+     */
+    void defer(std::function<void()> release);
+
+    /**
+     * @brief Destroy the objects whose retire value the GPU has reached
+     * @param completedValue Current value of the timeline
+     */
+    void collect(uint64_t completedValue);
+
+    /**
+     * @brief Destroy every pending object, the device must be idle
+     */
+    void flush() { collect(UINT64_MAX); }
+
+    /**
+     * @brief Get the number of objects and callbacks waiting for the GPU
+     * @return Pending releases
+     */
+    uint32_t getPendingCount() const { return m_pendingCount; }
+
+private:
+    struct Bucket
+    {
+        uint64_t value = 0;
+        std::vector<std::pair<VkBuffer, VulkanAllocation>> buffers;
+        std::vector<std::pair<VkImage, VulkanAllocation>> images;
+        std::vector<VulkanAllocation> allocations;
+        std::vector<VkImageView> imageViews;
+        std::vector<VkFramebuffer> framebuffers;
+        std::vector<VkPipeline> pipelines;
+        std::vector<VkPipelineLayout> pipelineLayouts;
+        std::vector<VkDescriptorPool> descriptorPools;
+        std::vector<std::function<void()>> callbacks;
+    };
+
+    Bucket& currentBucket();
+    void destroy(Bucket& bucket);
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    VulkanAllocator* m_allocator = nullptr;
+    uint64_t m_retireValue = 0;
+    uint32_t m_pendingCount = 0;
+    std::deque<Bucket> m_buckets;      // Pending, in release order
+    std::vector<Bucket> m_freeBuckets; // Destroyed, their vectors keep their capacity
+};
+
+} // namespace graphyne::graphics
@@ -0,0 +1,85 @@
+/**
+ * @file vulkan_gpu_culler.h
+ * @brief Compute pass culling objects into indirect draw commands
+ */
+#pragma once
+
+#include "graphics/render_types.h"
+#include "graphics/vulkan_sync.h"
+
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace graphyne::graphics
+{
+
+/**
+ * @class VulkanGpuCuller
+ * @brief Records the frustum culling compute pass behind Renderer::cullDraws()
+ *
+ * The pass clears the draw counts, tests one object per invocation against the frustum planes
+ * and appends each visible object to the commands of its draw group with an atomic counter, so
+ * the commands of a group are tightly packed but in no particular order. Barriers before the
+ * pass wait for earlier indirect draws reading the output buffers, and barriers after it make
+ * the commands and counts visible to the indirect draws that follow.
+ */
+class VulkanGpuCuller
+{
+public:
+    VulkanGpuCuller() = default;
+    ~VulkanGpuCuller();
+
+    VulkanGpuCuller(const VulkanGpuCuller&) = delete;
+    VulkanGpuCuller& operator=(const VulkanGpuCuller&) = delete;
+
+    /**
+     * @brief Create the culling pipeline and the descriptor pools of each frame in flight
+     * @param device Device to create the pipeline on
+     * @param sync Barrier functions of the device
+     * @param pipelineCache Cache the pipeline is compiled through
+     * @param framesInFlight Number of frames recorded ahead of the GPU
+     * @return True if the pipeline was created, false otherwise
+     */
+    bool initialize(VkDevice device, const VulkanSync& sync, VkPipelineCache pipelineCache, uint32_t framesInFlight);
+
+    /**
+     * @brief Destroy the pipeline and descriptor pools, the device must be idle
+     */
+    void shutdown();
+
+    /**
+     * @brief Recycle the descriptor sets of a frame, once the GPU finished it
+     * @param frame Index of the frame in flight
+     */
+    void beginFrame(uint32_t frame);
+
+    /**
+     * @brief Record a culling pass
+     * @param commandBuffer Primary command buffer, outside of a render pass
+     * @param frame Index of the frame in flight the command buffer belongs to
+     * @param objects Buffer of desc.objectCount GpuCullObject
+     * @param drawCommands Buffer receiving the draw commands
+     * @param drawCounts Buffer receiving the draw count of each group
+     * @param desc Counts and frustum of the pass, its buffer handles are ignored
+     * @param stats Frame statistics the recorded dispatch, binds and barriers are added to
+     * @return True if the pass was recorded, false if the frame ran out of descriptor sets
+     */
+    bool record(VkCommandBuffer commandBuffer,
+                uint32_t frame,
+                VkBuffer objects,
+                VkBuffer drawCommands,
+                VkBuffer drawCounts,
+                const GpuCullDesc& desc,
+                RenderStats& stats);
+
+private:
+    VkDevice m_device = VK_NULL_HANDLE;
+    const VulkanSync* m_sync = nullptr;
+    VkDescriptorSetLayout m_setLayout = VK_NULL_HANDLE;
+    VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline m_pipeline = VK_NULL_HANDLE;
+    std::vector<VkDescriptorPool> m_descriptorPools; // One per frame in flight, reset as a whole
+};
+
+} // namespace graphyne::graphics
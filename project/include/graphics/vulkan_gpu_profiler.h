@@ -0,0 +1,172 @@
+/**
+ * @file vulkan_gpu_profiler.h
+ * @brief GPU timestamp queries around the passes of each frame
+ */
+#pragma once
+
+#include "graphics/render_types.h"
+#include "utils/profiler.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace graphyne::graphics
+{
+
+/**
+ * @class VulkanGpuProfiler
+ * @brief Measures the GPU time of scopes recorded into the primary command buffer of each frame
+ *
+ * Each frame in flight owns a timestamp query pool. Scopes write a timestamp when they begin
+ * and end, and the results of a frame are read back when its slot is reused, after the frame
+ * was waited on, so reading them never stalls. Timestamps are converted to
+ * nanoseconds with the timestampPeriod of the device and shifted onto the steady clock of
+ * utils::Profiler, using an offset measured once at initialization, so that the scopes show
+ * up on a "GPU" track of the CPU trace while profiling is enabled.
+ *
+ * Scopes may only be recorded by the thread recording the primary command buffer, outside of
+ * render passes whose contents are secondary command buffers.
+ */
+class VulkanGpuProfiler
+{
+public:
+    VulkanGpuProfiler() = default;
+    ~VulkanGpuProfiler();
+
+    VulkanGpuProfiler(const VulkanGpuProfiler&) = delete;
+    VulkanGpuProfiler& operator=(const VulkanGpuProfiler&) = delete;
+
+    /**
+     * @brief Create the query pools and calibrate GPU timestamps against the CPU clock
+     * @param physicalDevice Physical device, for the timestamp period and valid bits
+     * @param device Device to create the query pools on
+     * @param queue Queue the frames are submitted to, used once for the calibration
+     * @param queueFamily Family of the queue
+     * @param framesInFlight Number of frames recorded ahead of the GPU
+     * @return True if the queue supports timestamps and the pools were created, false otherwise
+     */
+    bool initialize(VkPhysicalDevice physicalDevice,
+                    VkDevice device,
+                    VkQueue queue,
+                    uint32_t queueFamily,
+                    uint32_t framesInFlight);
+
+    /**
+     * @brief Destroy the query pools, the device must be idle
+     */
+    void shutdown();
+
+    /**
+     * @brief Check if the profiler was initialized
+     * @return True if scopes are measured, false otherwise
+     */
+    bool isInitialized() const { return !m_frames.empty(); }
+
+    /**
+     * @brief Read back the timings of the last use of a frame slot and start recording it again
+     * @param commandBuffer Primary command buffer of the frame, in the recording state
+     * @param frame Index of the frame in flight, whose last submission has executed
+     */
+    void beginFrame(VkCommandBuffer commandBuffer, uint32_t frame);
+
+    /**
+     * @brief Write the timestamp beginning a scope
+     * @param commandBuffer Primary command buffer of the current frame
+     * @param name Scope name with static lifetime, see utils::Profiler::internName()
+     */
+    void beginScope(VkCommandBuffer commandBuffer, const char* name);
+
+    /**
+     * @brief Write the timestamp ending the innermost open scope
+     * @param commandBuffer Primary command buffer of the current frame
+     */
+    void endScope(VkCommandBuffer commandBuffer);
+
+    /**
+     * @brief Get the scope timings of the most recent frame read back
+     * @return Scopes in the order they began, nested scopes follow their parent
+     */
+    const std::vector<GpuPassTiming>& getTimings() const { return m_timings; }
+
+    /**
+     * @brief Set the profiler used by GN_GPU_SCOPE
+     * @param profiler Profiler of the renderer recording frames, nullptr disables GN_GPU_SCOPE
+     */
+    static void setActive(VulkanGpuProfiler* profiler) { s_active = profiler; }
+
+    /**
+     * @brief Get the profiler used by GN_GPU_SCOPE
+     * @return Active profiler, or nullptr if none is set
+     */
+    static VulkanGpuProfiler* getActive() { return s_active; }
+
+private:
+    static constexpr uint32_t INVALID_QUERY = ~0u;
+
+    struct Scope
+    {
+        const char* name = nullptr;
+        uint32_t query = 0; // Begin timestamp, the end timestamp follows it
+        uint32_t depth = 0; // Number of enclosing scopes
+    };
+
+    struct Frame
+    {
+        VkQueryPool queryPool = VK_NULL_HANDLE;
+        std::vector<Scope> scopes; // In the order they began
+        uint32_t queryCount = 0;
+    };
+
+    bool calibrate(VkQueue queue, uint32_t queueFamily);
+    void resolve(Frame& frame);
+    uint64_t toProfilerTime(uint64_t timestamp) const;
+
+    static VulkanGpuProfiler* s_active;
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    std::vector<Frame> m_frames;
+    Frame* m_current = nullptr;
+    std::vector<uint32_t> m_openScopes; // Indices into the scopes of the current frame, INVALID_QUERY if dropped
+    bool m_overflowReported = false;
+
+    double m_timestampPeriod = 1.0; // Nanoseconds per tick
+    uint64_t m_timestampMask = ~0ull;
+    uint64_t m_calibrationTimestamp = 0; // GPU ticks at the calibration
+    uint64_t m_calibrationTime = 0;      // Profiler time matching m_calibrationTimestamp
+    uint64_t m_lastTime = 0;             // Latest profiler time written to the GPU track
+    uint32_t m_track = 0;
+
+    std::vector<uint64_t> m_results;
+    std::vector<GpuPassTiming> m_timings;
+};
+
+/**
+ * @class GpuProfileScope
+ * @brief Measures the GPU time of the commands recorded during its lifetime, use through GN_GPU_SCOPE
+ */
+class GpuProfileScope
+{
+public:
+    GpuProfileScope(VkCommandBuffer commandBuffer, const char* name);
+    GpuProfileScope(VkCommandBuffer commandBuffer, const std::string& name);
+    ~GpuProfileScope();
+
+    GpuProfileScope(const GpuProfileScope&) = delete;
+    GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+private:
+    VkCommandBuffer m_commandBuffer;
+    VulkanGpuProfiler* m_profiler;
+};
+
+} // namespace graphyne::graphics
+
+// GPU instrumentation, compiled out with the CPU instrumentation when GRAPHYNE_ENABLE_PROFILING is 0
+#if defined(GRAPHYNE_ENABLE_PROFILING) && GRAPHYNE_ENABLE_PROFILING
+#define GN_GPU_SCOPE(commandBuffer, name)                                                                             \
+    ::graphyne::graphics::GpuProfileScope GN_PROFILE_CONCAT(gnGpuScope, __LINE__)(commandBuffer, name)
+#else
+#define GN_GPU_SCOPE(commandBuffer, name) ((void)0)
+#endif
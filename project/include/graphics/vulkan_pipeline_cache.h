@@ -0,0 +1,88 @@
+/**
+ * @file vulkan_pipeline_cache.h
+ * @brief VkPipelineCache persisted on disk between runs
+ */
+#pragma once
+
+#include "core/job_system.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace graphyne::graphics
+{
+
+/**
+ * @class VulkanPipelineCache
+ * @brief Pipeline cache seeded from a file at startup and written back when pipelines were compiled
+ *
+ * The file is only used if its header matches the vendor, device and pipeline cache UUID of the
+ * physical device, and if its checksum is valid, otherwise the cache starts empty. Saves write a
+ * temporary file and rename it into place, so an interrupted save never corrupts the previous one.
+ * Pipelines may be created with the cache from any thread.
+ */
+class VulkanPipelineCache
+{
+public:
+    VulkanPipelineCache() = default;
+    ~VulkanPipelineCache();
+
+    VulkanPipelineCache(const VulkanPipelineCache&) = delete;
+    VulkanPipelineCache& operator=(const VulkanPipelineCache&) = delete;
+
+    /**
+     * @brief Create the pipeline cache, seeded from the file if it is valid for this device
+     * @param physicalDevice Physical device the cached pipelines were compiled for
+     * @param device Device to create the cache on
+     * @param path File to load from and save to, empty keeps the cache in memory only
+     * @return True if the cache was created, false otherwise
+     */
+    bool initialize(VkPhysicalDevice physicalDevice, VkDevice device, std::string path);
+
+    /**
+     * @brief Save the cache if it changed and destroy it
+     */
+    void shutdown();
+
+    /**
+     * @brief Write the cache to disk if pipelines were compiled since the last save
+     * @param async Write the file on a worker thread, the cache data is still retrieved on the calling thread
+     * @return True if the cache was up to date or written, false on failure
+     */
+    bool save(bool async = false);
+
+    /**
+     * @brief Save if pipelines were compiled, the interval has elapsed and no earlier write is in progress
+     * @param interval Minimum time between two saves
+     */
+    void saveIfDue(std::chrono::steady_clock::duration interval);
+
+    /**
+     * @brief Record that a pipeline was compiled with the cache, so it needs to be saved again
+     */
+    void markDirty() { m_dirty.store(true, std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the Vulkan pipeline cache to pass to pipeline creation
+     * @return Pipeline cache handle, null before initialization
+     */
+    VkPipelineCache getHandle() const { return m_cache; }
+
+private:
+    bool loadFile(std::vector<uint8_t>& data) const;
+    bool isCompatible(const std::vector<uint8_t>& data) const;
+    static bool writeFile(const std::string& path, const std::vector<uint8_t>& data);
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    VkPipelineCache m_cache = VK_NULL_HANDLE;
+    VkPhysicalDeviceProperties m_deviceProperties = {};
+    std::string m_path;
+    std::atomic<bool> m_dirty{false};
+    std::chrono::steady_clock::time_point m_lastSave;
+    core::JobCounter m_pendingWrites; // Asynchronous writes still in progress
+};
+
+} // namespace graphyne::graphics
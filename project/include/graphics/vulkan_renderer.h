@@ -4,8 +4,23 @@
  */
 #pragma once
 
+#include "core/job_system.h"
+#include "graphics/render_graph.h"
 #include "graphics/renderer.h"
+#include "graphics/vulkan_allocator.h"
+#include "graphics/vulkan_bindless.h"
+#include "graphics/vulkan_deletion_queue.h"
+#include "graphics/vulkan_gpu_culler.h"
+#include "graphics/vulkan_gpu_profiler.h"
+#include "graphics/vulkan_pipeline_cache.h"
+#include "graphics/vulkan_sync.h"
+#include "graphics/vulkan_uploader.h"
 
+#include <array>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <unordered_map>
 #include <vector>
 #include <vulkan/vulkan.h>
 
@@ -23,7 +38,7 @@ public:
      * @param window Window to render to
      * @param config Renderer configuration
      */
-    VulkanRenderer(platform::Window& window, const Config& config = Config{});
+    VulkanRenderer(platform::Window* window, const Config& config = Config{});
 
     /**
      * @brief Destructor
@@ -63,6 +78,84 @@ public:
      */
     void onResize(int width, int height) override;
 
+    /**
+     * @brief Copy the offscreen image of the current frame back to host memory
+     *
+     * The copy is recorded at the end of the frame and completes asynchronously,
+     * use pollReadback() to retrieve the pixels. Only available in offscreen mode.
+     *
+     * @return True if a readback slot was available, false otherwise
+     */
+    bool requestReadback();
+
+    /**
+     * @brief Retrieve the oldest finished readback without blocking
+     * @param pixels Receives tightly packed RGBA8 pixels
+     * @param width Receives the image width
+     * @param height Receives the image height
+     * @return True if a readback completed, false if none is ready yet
+     */
+    bool pollReadback(std::vector<uint8_t>& pixels, uint32_t& width, uint32_t& height);
+
+    /**
+     * @brief Check if the renderer draws into offscreen images
+     * @return True in offscreen mode, false when presenting to a window
+     */
+    bool isOffscreen() const { return m_config.offscreen; }
+
+    /**
+     * @brief Get the render graph of the current frame
+     *
+     * beginFrame() resets the graph, imports the backbuffer and adds the scene pass, which draws
+     * everything recorded through the Renderer API into the backbuffer. Passes added before
+     * endFrame() are ordered around it by the images they access.
+     *
+     * @return Render graph compiled and executed by endFrame()
+     */
+    RenderGraph& getRenderGraph() { return m_renderGraph; }
+
+    /**
+     * @brief Get the image presented, or read back in offscreen mode, at the end of the frame
+     * @return Backbuffer of the current frame's render graph
+     */
+    RenderGraphResource getBackbuffer() const { return m_backbuffer; }
+
+    BufferHandle createBuffer(const BufferDesc& desc, const void* initialData = nullptr) override;
+    void updateBuffer(BufferHandle buffer, const void* data, size_t size, size_t offset = 0) override;
+    void destroyBuffer(BufferHandle buffer) override;
+    TextureHandle createTexture(const TextureDesc& desc) override;
+    void updateTexture(TextureHandle texture, uint32_t mipLevel, const void* data, size_t size) override;
+    void destroyTexture(TextureHandle texture) override;
+    bool isBindless() const override { return m_bindless; }
+    uint32_t getBindlessIndex(TextureHandle texture) const override;
+    uint32_t getBindlessIndex(BufferHandle buffer) const override;
+    PipelineHandle createPipeline(const PipelineDesc& desc) override;
+    void destroyPipeline(PipelineHandle pipeline) override;
+    bool isPipelineReady(PipelineHandle pipeline) const override;
+    void bindPipeline(PipelineHandle pipeline) override;
+    void bindVertexBuffer(BufferHandle buffer, size_t offset = 0) override;
+    void bindIndexBuffer(BufferHandle buffer, IndexType type, size_t offset = 0) override;
+    void pushConstants(const void* data, uint32_t size, uint32_t offset = 0) override;
+    void draw(uint32_t vertexCount,
+              uint32_t instanceCount = 1,
+              uint32_t firstVertex = 0,
+              uint32_t firstInstance = 0) override;
+    void drawIndexed(uint32_t indexCount,
+                     uint32_t instanceCount = 1,
+                     uint32_t firstIndex = 0,
+                     int32_t vertexOffset = 0,
+                     uint32_t firstInstance = 0) override;
+    void drawIndexedIndirectCount(BufferHandle commands,
+                                  size_t offset,
+                                  BufferHandle count,
+                                  size_t countOffset,
+                                  uint32_t maxDrawCount) override;
+    bool supportsGpuCulling() const override { return m_gpuCulling; }
+    void cullDraws(const GpuCullDesc& desc) override;
+    void recordParallel(uint32_t count, uint32_t batchSize, const RecordJob& job) override;
+    const std::vector<GpuPassTiming>& getGpuTimings() const override { return m_gpuProfiler.getTimings(); }
+    const RenderStats& getStats() const override { return m_stats; }
+
 private:
     // Vulkan instance and debugging
     bool createInstance();
@@ -71,15 +164,67 @@ private:
     std::vector<const char*> getRequiredExtensions();
 
     // Device selection and creation
+    struct QueueFamilyIndices
+    {
+        std::optional<uint32_t> graphics; // Preferably able to present too
+        std::optional<uint32_t> present;
+        std::optional<uint32_t> transfer; // Transfer family without graphics, preferably without compute too
+    };
+
     bool pickPhysicalDevice();
-    bool isDeviceSuitable(VkPhysicalDevice device);
+    uint64_t rateDevice(VkPhysicalDevice device);
+    QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device);
     bool createLogicalDevice();
+    bool isDeviceExtensionSupported(VkPhysicalDevice device, const char* extension);
+    bool enableDescriptorIndexing(VkPhysicalDeviceDescriptorIndexingFeatures& features,
+                                  std::vector<const char*>& extensions);
+    bool supportsTimelineSemaphores(VkPhysicalDevice device, uint32_t apiVersion);
+    bool enableSynchronization2(VkPhysicalDeviceSynchronization2Features& features,
+                                std::vector<const char*>& extensions);
+    bool createBindlessLayout();
 
     // Swapchain
     bool createSurface();
-    bool createSwapChain();
+    bool createSwapChain(VkSwapchainKHR oldSwapChain = VK_NULL_HANDLE);
+    VkPresentModeKHR choosePresentMode(const std::vector<VkPresentModeKHR>& supported) const;
     void cleanupSwapChain();
     bool recreateSwapChain();
+    void recoverFromFailedSubmit(uint32_t frameIndex);
+    void destroyRetiredSwapChains(bool all);
+    VkExtent2D getRenderExtent() const;
+
+    // Offscreen rendering
+    bool createOffscreenTarget();
+    void destroyOffscreenTarget();
+    bool createReadbackBuffers();
+    void destroyReadbackBuffers();
+    void recordReadback(VkCommandBuffer commandBuffer, uint32_t slot);
+
+    // Resource uploads
+    bool initializeUploader();
+    void waitForFramesUsing(uint64_t createdFrame);
+
+    // Pipelines
+    struct PipelineData;
+    bool compilePipeline(const PipelineDesc& desc, PipelineData& data);
+    const PipelineData* resolvePipeline(PipelineHandle pipeline) const;
+    void destroyPipelineLayout(VkPipelineLayout layout);
+    VkShaderModule createShaderModule(const std::vector<uint32_t>& code);
+
+    // Command recording
+    class SecondaryRecorder;
+    VkCommandBuffer beginSecondaryCommandBuffer();
+    SecondaryRecorder* getImmediateRecorder();
+    void closeImmediateRecorder();
+
+    // Frame resources
+    bool createRenderPass();
+    void addScenePass();
+    void resolvePipelineStatistics(uint32_t frameIndex);
+    void finishFrameStats();
+    uint64_t getCompletedFrames() const;
+    bool createFrameResources();
+    void destroyFrameResources();
 
     // Vulkan resources
     VkInstance m_instance = VK_NULL_HANDLE;
@@ -94,10 +239,192 @@ private:
     std::vector<VkImageView> m_swapChainImageViews;
     VkFormat m_swapChainImageFormat = VK_FORMAT_UNDEFINED;
     VkExtent2D m_swapChainExtent = {0, 0};
+    std::vector<VkSemaphore> m_renderFinishedSemaphores; // One per swapchain image, waited on by present
+    uint32_t m_imageIndex = 0;                           // Swapchain image of the current frame
+    uint32_t m_graphicsQueueFamily = 0;
+    uint32_t m_presentQueueFamily = 0;
+    uint32_t m_apiVersion = VK_API_VERSION_1_0; // Highest version supported by both the instance and the device
+    VkPhysicalDeviceFeatures m_enabledFeatures = {};
+    VulkanSync m_sync;
+    VkRenderPass m_renderPass = VK_NULL_HANDLE; // Compatible with the scene pass, for pipelines and secondary buffers
+    VulkanAllocator m_allocator;                // Backs every buffer and image created by the renderer
+    VulkanDeletionQueue m_deletionQueue;        // Destroys released resources once the frames using them executed
+    VulkanPipelineCache m_pipelineCache;
+    RenderGraph m_renderGraph;
+    RenderGraphResource m_backbuffer;
+
+    // Swapchain replaced by a recreation, destroyed once the frames submitted before have executed
+    struct RetiredSwapChain
+    {
+        VkSwapchainKHR swapChain = VK_NULL_HANDLE;
+        std::vector<VkImageView> imageViews;
+        std::vector<VkSemaphore> renderFinishedSemaphores;
+        std::vector<VkFramebuffer> framebuffers;
+        uint64_t frameIndex = 0; // m_frameIndex at retirement
+    };
+    std::vector<RetiredSwapChain> m_retiredSwapChains;
+
+    // Offscreen render target
+    VkImage m_offscreenImage = VK_NULL_HANDLE;
+    VulkanAllocation m_offscreenMemory;
+    VkImageView m_offscreenImageView = VK_NULL_HANDLE;
+    static constexpr VkFormat OFFSCREEN_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+
+    // Host-visible copies of the offscreen image, filled asynchronously
+    struct Readback
+    {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VulkanAllocation memory; // Persistently mapped
+        bool pending = false;
+        uint64_t frameIndex = 0; // Frame recording the copy, it is done once the frame has executed
+    };
+    std::array<Readback, 2> m_readbacks;
+    bool m_readbackRequested = false;
+
+    // Secondary command buffers recorded by one thread, padded so threads never share a cache line
+    struct alignas(64) ThreadCommandPool
+    {
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> commandBuffers; // Allocated on demand and reused every frame
+        uint32_t usedCount = 0;
+    };
+
+    // Resources of one frame in flight, reused once m_frameTimeline reached the value of its last submission
+    struct FrameData
+    {
+        VkCommandPool commandPool = VK_NULL_HANDLE; // Reset as a whole at the start of the frame
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        uint64_t timelineValue = 0;                           // Signaled when the GPU finished the frame, 0 if unused
+        VkSemaphore imageAvailable = VK_NULL_HANDLE;          // Signaled when the acquired swapchain image is ready
+        std::vector<ThreadCommandPool> threadPools;           // Indexed by JobSystem::getCurrentThreadIndex()
+        std::vector<VkCommandBuffer> secondaryCommandBuffers; // Executed in this order inside the render pass
+        VkQueryPool statisticsQuery = VK_NULL_HANDLE;         // Pipeline statistics over the whole frame
+        bool statisticsPending = false;                       // The query was submitted and not read back yet
+        uint64_t statisticsFrame = 0;                         // Value of m_frameIndex the query was submitted in
+    };
+
+    enum class PipelineState
+    {
+        Compiling,
+        Ready,
+        Failed
+    };
+
+    // Written by the compile job, only read once the state is Ready
+    struct PipelineData
+    {
+        std::atomic<PipelineState> state{PipelineState::Compiling};
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        VkPipelineLayout layout = VK_NULL_HANDLE;
+        uint32_t pushConstantSize = 0;
+        PrimitiveTopology topology = PrimitiveTopology::TriangleList;
+        PipelineHandle fallback;
+        core::JobCounter compileJob;
+    };
+
+    struct BufferData
+    {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VulkanAllocation allocation; // Persistently mapped for host visible buffers
+        size_t size = 0;
+        BufferUsage usage = BufferUsage::Vertex;
+        uint32_t bindlessIndex = INVALID_BINDLESS_INDEX;
+        uint64_t createdFrame = 0; // Value of m_frameIndex at creation, earlier frames never used the buffer
+    };
+
+    struct TextureData
+    {
+        VkImage image = VK_NULL_HANDLE;
+        VulkanAllocation allocation;
+        VkImageView view = VK_NULL_HANDLE;
+        TextureDesc desc;
+        uint32_t bindlessIndex = INVALID_BINDLESS_INDEX;
+        uint64_t createdFrame = 0;
+    };
+
+    // Resources created through the renderer API
+    uint32_t m_nextHandleId = 1;
+    std::unordered_map<uint32_t, BufferData> m_buffers;
+    std::unordered_map<uint32_t, TextureData> m_textures;
+    std::unordered_map<uint32_t, std::unique_ptr<PipelineData>> m_pipelines;
+
+    // Bindless mode, every pipeline shares one layout so the descriptor set survives pipeline binds
+    bool m_bindless = false; // Requested by the config and supported by the device
+    VulkanBindlessHeap m_bindlessHeap;
+    VkPipelineLayout m_bindlessPipelineLayout = VK_NULL_HANDLE;
+
+    // GPU culling, needs VK_KHR_draw_indirect_count and the drawIndirectFirstInstance feature
+    bool m_gpuCulling = false;
+    VulkanGpuCuller m_gpuCuller;
+    PFN_vkCmdDrawIndexedIndirectCountKHR m_cmdDrawIndexedIndirectCount = nullptr;
+
+    // GPU pass timings, disabled if the graphics queue has no timestamps
+    VulkanGpuProfiler m_gpuProfiler;
+
+    // Counters of the frame being recorded, copied to m_stats when it ends
+    RenderStats m_frameStats;
+    RenderStats m_stats;
+    UploadStats m_lastUploadStats;     // Uploader totals when the previous frame ended
+    bool m_pipelineStatistics = false; // Requested by the config and supported by the device
+
+    // Uploads, on a dedicated transfer queue when the device has one
+    VulkanUploader m_uploader;
+    VkQueue m_transferQueue = VK_NULL_HANDLE;
+    uint32_t m_transferQueueFamily = 0;
+
+    // Records into one secondary command buffer, used by the immediate API and by each parallel batch
+    class SecondaryRecorder : public CommandRecorder
+    {
+    public:
+        SecondaryRecorder(const VulkanRenderer& renderer, VkCommandBuffer commandBuffer)
+            : m_renderer(renderer), m_commandBuffer(commandBuffer)
+        {
+            // beginSecondaryCommandBuffer() bound the bindless set
+            m_stats.descriptorBinds = renderer.m_bindless ? 1 : 0;
+        }
+
+        void bindPipeline(PipelineHandle pipeline) override;
+        void bindVertexBuffer(BufferHandle buffer, size_t offset = 0) override;
+        void bindIndexBuffer(BufferHandle buffer, IndexType type, size_t offset = 0) override;
+        void pushConstants(const void* data, uint32_t size, uint32_t offset = 0) override;
+        void draw(uint32_t vertexCount,
+                  uint32_t instanceCount = 1,
+                  uint32_t firstVertex = 0,
+                  uint32_t firstInstance = 0) override;
+        void drawIndexed(uint32_t indexCount,
+                         uint32_t instanceCount = 1,
+                         uint32_t firstIndex = 0,
+                         int32_t vertexOffset = 0,
+                         uint32_t firstInstance = 0) override;
+        void drawIndexedIndirectCount(BufferHandle commands,
+                                      size_t offset,
+                                      BufferHandle count,
+                                      size_t countOffset,
+                                      uint32_t maxDrawCount) override;
+
+        VkCommandBuffer getCommandBuffer() const { return m_commandBuffer; }
+        const RenderStats& getStats() const { return m_stats; }
+        void resetBindings();
+
+    private:
+        const VulkanRenderer& m_renderer;
+        VkCommandBuffer m_commandBuffer;
+        RenderStats m_stats; // Commands of this recorder only, merged into the frame when it closes
+        PipelineHandle m_boundPipeline;
+        const PipelineData* m_activePipeline = nullptr; // m_boundPipeline, or its fallback while compiling
+    };
+
+    // Open between immediate API calls, closed when a parallel recording or the frame ends
+    std::optional<SecondaryRecorder> m_immediateRecorder;
 
     // Frame management
-    uint32_t m_currentFrame = 0;
+    std::vector<FrameData> m_frames;
+    VkSemaphore m_frameTimeline = VK_NULL_HANDLE; // Signaled with m_frameIndex + 1 when a frame has executed
+    bool m_frameStarted = false;
+    uint64_t m_frameIndex = 0;   // Frames submitted since initialization
+    uint32_t m_currentFrame = 0; // Index into m_frames
     bool m_framebufferResized = false;
+    bool m_deviceLost = false; // Set when the device is lost, or a failed frame left it unable to render
 
     // Validation layers
     const std::vector<const char*> m_validationLayers = {
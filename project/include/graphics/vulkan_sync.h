@@ -0,0 +1,112 @@
+/**
+ * @file vulkan_sync.h
+ * @brief Timeline semaphores, synchronization2 barriers and queue submissions of the Vulkan backend
+ */
+#pragma once
+
+#include <cstdint>
+#include <vulkan/vulkan.h>
+
+namespace graphyne::graphics
+{
+
+/**
+ * @class VulkanSync
+ * @brief Device entry points for timeline semaphores and synchronization2
+ *
+ * Barriers and submissions are described with the synchronization2 structures, so every barrier
+ * carries its own stages and every semaphore its own stage and timeline value. They are recorded
+ * as they are when VK_KHR_synchronization2 is enabled, otherwise they are translated to
+ * vkCmdPipelineBarrier and vkQueueSubmit, so stages and accesses are limited to the flags of the
+ * original API. Barriers of one dependency then share the union of their stages.
+ *
+ * Timeline semaphores are core in Vulkan 1.2 and come from VK_KHR_timeline_semaphore on 1.1,
+ * their entry points are loaded under the name the device exposes. A semaphore counts the
+ * submissions that have executed, so checking if the GPU is done with something is a compare
+ * of the value it was submitted with against getValue().
+ */
+class VulkanSync
+{
+public:
+    /**
+     * @brief Load the entry points of a device
+     * @param device Device created with the timelineSemaphore feature
+     * @param apiVersion Vulkan version of the device
+     * @param synchronization2 True if VK_KHR_synchronization2 and its feature are enabled
+     * @return True if the timeline semaphore entry points were found, false otherwise
+     */
+    bool initialize(VkDevice device, uint32_t apiVersion, bool synchronization2);
+
+    /**
+     * @brief Check if barriers and submissions are recorded with VK_KHR_synchronization2
+     * @return True if they are passed to the device as they are, false if they are translated
+     */
+    bool hasSynchronization2() const { return m_cmdPipelineBarrier2 != nullptr; }
+
+    /**
+     * @brief Create a timeline semaphore starting at 0
+     * @return Semaphore, or VK_NULL_HANDLE on failure
+     */
+    VkSemaphore createTimelineSemaphore() const;
+
+    /**
+     * @brief Get the current value of a timeline semaphore without blocking
+     * @param semaphore Timeline semaphore
+     * @return Highest value signaled so far, 0 if the query failed
+     */
+    uint64_t getValue(VkSemaphore semaphore) const;
+
+    /**
+     * @brief Block until a timeline semaphore reached a value
+     * @param semaphore Timeline semaphore
+     * @param value Value to wait for, 0 returns immediately
+     * @return True once the value was reached, false on device loss
+     */
+    bool wait(VkSemaphore semaphore, uint64_t value) const;
+
+    /**
+     * @brief Record a pipeline barrier
+     * @param commandBuffer Command buffer in the recording state
+     * @param dependency Barriers with their own stages and accesses
+     */
+    void pipelineBarrier(VkCommandBuffer commandBuffer, const VkDependencyInfo& dependency) const;
+
+    /**
+     * @brief Record a global memory barrier
+     * @param commandBuffer Command buffer in the recording state
+     * @param srcStages Stages to wait for
+     * @param srcAccess Writes to make available
+     * @param dstStages Stages that wait
+     * @param dstAccess Accesses the writes are made visible to
+     */
+    void memoryBarrier(VkCommandBuffer commandBuffer,
+                       VkPipelineStageFlags2 srcStages,
+                       VkAccessFlags2 srcAccess,
+                       VkPipelineStageFlags2 dstStages,
+                       VkAccessFlags2 dstAccess) const;
+
+    /**
+     * @brief Record image barriers as one pipeline barrier
+     * @param commandBuffer Command buffer in the recording state
+     * @param count Number of barriers
+     * @param barriers Image barriers with their own stages
+     */
+    void imageBarriers(VkCommandBuffer commandBuffer, uint32_t count, const VkImageMemoryBarrier2* barriers) const;
+
+    /**
+     * @brief Submit one batch of command buffers to a queue
+     * @param queue Queue to submit to
+     * @param submitInfo Command buffers and semaphores, values of binary semaphores are ignored
+     * @return Result of the submission
+     */
+    VkResult submit(VkQueue queue, const VkSubmitInfo2& submitInfo) const;
+
+private:
+    VkDevice m_device = VK_NULL_HANDLE;
+    PFN_vkWaitSemaphores m_waitSemaphores = nullptr;
+    PFN_vkGetSemaphoreCounterValue m_getSemaphoreCounterValue = nullptr;
+    PFN_vkCmdPipelineBarrier2 m_cmdPipelineBarrier2 = nullptr; // Null without VK_KHR_synchronization2
+    PFN_vkQueueSubmit2 m_queueSubmit2 = nullptr;
+};
+
+} // namespace graphyne::graphics
@@ -0,0 +1,214 @@
+/**
+ * @file vulkan_uploader.h
+ * @brief Asynchronous buffer and texture uploads through a persistently mapped staging ring
+ */
+#pragma once
+
+#include "graphics/vulkan_allocator.h"
+#include "graphics/vulkan_sync.h"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace graphyne::graphics
+{
+
+/**
+ * @struct UploadStats
+ * @brief Upload work since initialization
+ */
+struct UploadStats
+{
+    uint64_t batches = 0;          // Command buffers submitted
+    uint64_t copies = 0;           // Buffer and image copies recorded
+    uint64_t bytes = 0;            // Bytes copied through staging memory
+    uint64_t dedicatedStaging = 0; // Uploads too large for the ring, staged through their own buffer
+    uint64_t ringStalls = 0;       // Times the CPU waited for the GPU to free ring space
+    uint64_t barriers = 0;         // Pipeline barriers recorded into the batches
+};
+
+/**
+ * @class VulkanUploader
+ * @brief Stages uploads through one mapped ring buffer and submits their copies in batches
+ *
+ * Data is copied into the ring right away and the copies are recorded into the open batch,
+ * which is submitted by flush(), or earlier once it holds a quarter of the ring, so uploads
+ * never wait for the GPU unless the whole ring is in flight. Each batch signals the next value
+ * of a timeline semaphore, and ring space is reclaimed when collect() sees the semaphore reach
+ * the value of a batch.
+ *
+ * Batches run on a dedicated transfer queue when the device has one, so that copies overlap
+ * rendering. The graphics queue then waits on the timeline semaphore before using the uploaded
+ * data, and resources must be shared concurrently by both queue families. Otherwise batches run
+ * on the graphics queue, ordered with the frames by submission order.
+ *
+ * Textures stay in SHADER_READ_ONLY_OPTIMAL layout outside of the copies into them.
+ */
+class VulkanUploader
+{
+public:
+    /**
+     * @struct QueueInfo
+     * @brief Queue the batches are submitted to
+     */
+    struct QueueInfo
+    {
+        VkQueue queue = VK_NULL_HANDLE;
+        uint32_t family = 0;
+        bool dedicated = false; // A transfer queue separate from the graphics queue
+    };
+
+    VulkanUploader() = default;
+    ~VulkanUploader();
+
+    VulkanUploader(const VulkanUploader&) = delete;
+    VulkanUploader& operator=(const VulkanUploader&) = delete;
+
+    /**
+     * @brief Create the staging ring, the command pool and the timeline semaphore
+     * @param device Device to upload to
+     * @param allocator Allocator of the staging memory
+     * @param sync Timeline semaphore and barrier functions of the device
+     * @param queue Queue the batches are submitted to
+     * @param ringSize Size of the staging ring in bytes
+     * @return True if the uploader was created, false otherwise
+     */
+    bool initialize(VkDevice device,
+                    VulkanAllocator& allocator,
+                    const VulkanSync& sync,
+                    const QueueInfo& queue,
+                    VkDeviceSize ringSize);
+
+    /**
+     * @brief Wait for all batches and destroy the uploader
+     */
+    void shutdown();
+
+    /**
+     * @brief Copy data into a range of a buffer
+     * @param buffer Destination buffer, created with VK_BUFFER_USAGE_TRANSFER_DST_BIT
+     * @param offset Byte offset into the buffer
+     * @param data Source data, copied before the call returns
+     * @param size Number of bytes
+     * @return True if the copy was recorded, false otherwise
+     */
+    bool uploadBuffer(VkBuffer buffer, VkDeviceSize offset, const void* data, VkDeviceSize size);
+
+    /**
+     * @brief Copy data into one mip level of a 2D texture
+     * @param image Destination image, in SHADER_READ_ONLY_OPTIMAL layout
+     * @param mipLevel Mip level to fill
+     * @param extent Size of the mip level in texels
+     * @param data Tightly packed texel or block data, copied before the call returns
+     * @param size Number of bytes
+     * @return True if the copy was recorded, false otherwise
+     */
+    bool uploadImage(VkImage image, uint32_t mipLevel, VkExtent3D extent, const void* data, VkDeviceSize size);
+
+    /**
+     * @brief Transition every mip level of a new texture to SHADER_READ_ONLY_OPTIMAL
+     * @param image Image in UNDEFINED layout
+     * @param mipLevels Number of mip levels
+     * @return True if the transition was recorded, false otherwise
+     */
+    bool initializeImage(VkImage image, uint32_t mipLevels);
+
+    /**
+     * @brief Delay the open batch until the graphics queue reached a timeline value
+     *
+     * Only needed on a dedicated transfer queue, when the upload overwrites data that
+     * frames submitted earlier may still read.
+     *
+     * @param semaphore Timeline semaphore signaled by the graphics queue
+     * @param value Value to wait for
+     */
+    void waitForGraphics(VkSemaphore semaphore, uint64_t value);
+
+    /**
+     * @brief Submit the open batch
+     * @return Timeline value signaled by the last submitted batch, 0 if none was submitted
+     */
+    uint64_t flush();
+
+    /**
+     * @brief Reclaim the staging memory of the batches the GPU has finished
+     */
+    void collect();
+
+    /**
+     * @brief Flush and block until every batch has executed
+     */
+    void waitIdle();
+
+    /**
+     * @brief Check if batches run on a dedicated transfer queue
+     * @return True if the graphics queue has to wait on getSemaphore()
+     */
+    bool isDedicated() const { return m_queue.dedicated; }
+
+    /**
+     * @brief Get the timeline semaphore signaled by each batch
+     * @return Semaphore whose value is the number of batches executed
+     */
+    VkSemaphore getSemaphore() const { return m_semaphore; }
+
+    /**
+     * @brief Get the timeline value of the last submitted batch
+     * @return Value the graphics queue waits for to see every flushed upload
+     */
+    uint64_t getSubmittedValue() const { return m_submittedValue; }
+
+    /**
+     * @brief Get upload statistics
+     * @return Statistics since initialization
+     */
+    const UploadStats& getStats() const { return m_stats; }
+
+private:
+    struct StagingBuffer
+    {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VulkanAllocation allocation;
+    };
+
+    struct Batch
+    {
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        uint64_t value = 0;     // Timeline value signaled once the batch has executed
+        uint64_t ringHead = 0;  // Ring position after the last staged byte, reclaimed when the batch retires
+        VkDeviceSize bytes = 0; // Bytes staged in the ring
+        std::vector<StagingBuffer> dedicatedStaging;
+        VkSemaphore graphicsSemaphore = VK_NULL_HANDLE;
+        uint64_t graphicsValue = 0;
+    };
+
+    Batch* openBatch();
+    bool stage(const void* data, VkDeviceSize size, VkBuffer& buffer, VkDeviceSize& offset);
+    bool allocateRing(VkDeviceSize size, VkDeviceSize& offset);
+    void retire(Batch& batch);
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    VulkanAllocator* m_allocator = nullptr;
+    const VulkanSync* m_sync = nullptr;
+    QueueInfo m_queue;
+    VkCommandPool m_commandPool = VK_NULL_HANDLE;
+    VkSemaphore m_semaphore = VK_NULL_HANDLE;
+    uint64_t m_submittedValue = 0;
+
+    // Ring positions grow monotonically, the byte offset of a position is position % m_ringSize
+    StagingBuffer m_ring;
+    VkDeviceSize m_ringSize = 0;
+    uint64_t m_ringHead = 0; // Next free position
+    uint64_t m_ringTail = 0; // Oldest position still read by a batch in flight
+
+    bool m_batchOpen = false;
+    Batch m_openBatch;
+    std::deque<Batch> m_pendingBatches; // Submitted, in submission order
+    std::vector<Batch> m_freeBatches;   // Retired, their command buffer is reused
+
+    UploadStats m_stats;
+};
+
+} // namespace graphyne::graphics
@@ -0,0 +1,65 @@
+/**
+ * @file file_watcher.h
+ * @brief Non-blocking file change notifications
+ */
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace graphyne::platform
+{
+
+/**
+ * @class FileWatcher
+ * @brief Reports files that were written or moved into watched directories
+ *
+ * Uses inotify on Linux. On other platforms initialize() fails and the
+ * watcher stays inactive.
+ */
+class FileWatcher
+{
+public:
+    FileWatcher() = default;
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /**
+     * @brief Open the platform notification handle
+     * @return True if file watching is available, false otherwise
+     */
+    bool initialize();
+
+    /**
+     * @brief Stop watching and release the notification handle
+     */
+    void shutdown();
+
+    /**
+     * @brief Start watching a directory, watching the same directory twice is a no-op
+     * @param directory Directory to watch (not recursive)
+     * @return True if the directory is watched, false otherwise
+     */
+    bool watchDirectory(const std::string& directory);
+
+    /**
+     * @brief Collect the files changed since the last call, never blocks
+     * @param changedFiles Receives the normalized paths of changed files, without duplicates
+     */
+    void poll(std::vector<std::string>& changedFiles);
+
+    /**
+     * @brief Check if the watcher is active
+     * @return True if initialized, false otherwise
+     */
+    bool isInitialized() const { return m_handle >= 0; }
+
+private:
+    int m_handle = -1;
+    std::unordered_map<int, std::string> m_watches; // Watch descriptor to directory
+};
+
+} // namespace graphyne::platform
@@ -0,0 +1,146 @@
+/**
+ * @file perf_counters.h
+ * @brief Hardware performance counters of a set of threads
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace graphyne::platform
+{
+
+/**
+ * @struct PerfCounterValues
+ * @brief Hardware counter and wall time values, either absolute or accumulated over a region
+ */
+struct PerfCounterValues
+{
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t cacheMisses = 0; // Last level cache misses
+    uint64_t branchMisses = 0;
+    uint64_t wallTime = 0; // Nanoseconds
+
+    PerfCounterValues& operator+=(const PerfCounterValues& other);
+    PerfCounterValues operator-(const PerfCounterValues& other) const;
+
+    /**
+     * @brief Get the instructions retired per cycle, low values point at memory bound code
+     * @return Instructions per cycle, 0 if no cycles were counted
+     */
+    double getInstructionsPerCycle() const;
+
+    /**
+     * @brief Get the cache misses per thousand instructions
+     * @return Misses per kilo instruction, 0 if no instructions were counted
+     */
+    double getCacheMissesPerKiloInstruction() const;
+};
+
+/**
+ * @class PerfCounters
+ * @brief Counts cycles, instructions, cache misses and branch misses of a set of threads
+ *
+ * Uses perf_event_open on Linux, with one counter group per thread: the thread that called
+ * initialize() and every thread that called addCurrentThread(), like the job system workers.
+ * read() returns the sum over all of them, so a region measured on the main thread also
+ * includes whatever the workers ran meanwhile, background jobs included. Counters the CPU or
+ * the kernel does not provide (virtual machines, perf_event_paranoid) read as 0.
+ * On other platforms initialize() fails and only wall time is reported.
+ */
+class PerfCounters
+{
+public:
+    PerfCounters() = default;
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /**
+     * @brief Open and start the counters for the calling thread
+     * @return True if at least the cycle counter is available, false otherwise
+     */
+    bool initialize();
+
+    /**
+     * @brief Open and start counters for the calling thread as well, summed into read()
+     * @return True if the cycle counter could be opened for the thread, false otherwise
+     */
+    bool addCurrentThread();
+
+    /**
+     * @brief Stop and close the counters of every thread
+     */
+    void shutdown();
+
+    /**
+     * @brief Read the counts since each thread was added, scaled when the kernel multiplexed the counters
+     * @param values Receives the counts summed over the threads and the wall time
+     * @return True if the counters were read, false if only wall time is valid
+     */
+    bool read(PerfCounterValues& values) const;
+
+    /**
+     * @brief Check if the counters are open
+     * @return True if initialized, false otherwise
+     */
+    bool isInitialized() const { return m_initialized; }
+
+    /**
+     * @brief Get the number of threads whose counters are summed
+     * @return Thread count, 0 if not initialized
+     */
+    uint32_t getThreadCount() const;
+
+private:
+    enum Counter
+    {
+        Cycles,
+        Instructions,
+        CacheMisses,
+        BranchMisses,
+        CounterCount
+    };
+
+    struct Group
+    {
+        std::array<int, CounterCount> descriptors = {-1, -1, -1, -1}; // Cycles is the group leader
+        std::array<Counter, CounterCount> readOrder = {};             // Counter of each value in a group read
+        uint32_t openCount = 0;
+    };
+
+    static bool openGroup(Group& group, bool logErrors);
+    static void closeGroup(Group& group);
+    static bool readGroup(const Group& group, PerfCounterValues& values);
+
+    bool m_initialized = false;
+    mutable std::mutex m_mutex; // Guards m_groups, workers add their group while the main thread reads
+    std::vector<Group> m_groups;
+};
+
+/**
+ * @class PerfCounterScope
+ * @brief Adds the counter deltas of its lifetime to a total, for timing subsystems or profiler scopes
+ *
+ * With a null or uninitialized PerfCounters only wall time is accumulated.
+ */
+class PerfCounterScope
+{
+public:
+    PerfCounterScope(const PerfCounters* counters, PerfCounterValues& total);
+    ~PerfCounterScope();
+
+    PerfCounterScope(const PerfCounterScope&) = delete;
+    PerfCounterScope& operator=(const PerfCounterScope&) = delete;
+
+private:
+    const PerfCounters* m_counters;
+    PerfCounterValues& m_total;
+    PerfCounterValues m_start;
+};
+
+} // namespace graphyne::platform
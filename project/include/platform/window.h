@@ -17,6 +17,9 @@ public:
     void shutdown();
     void processEvents();
 
+    // Blocks until at least one event arrived, then processes all pending events
+    void waitEvents();
+
     SDL_Window* getSDLWindow() const
     {
         return m_window;
@@ -33,6 +36,10 @@ public:
     {
         return m_height;
     }
+    bool isMinimized() const
+    {
+        return m_minimized;
+    }
 
     std::vector<const char*> getRequiredExtensions() const;
 
@@ -42,6 +49,9 @@ private:
     int m_height;
     std::string m_title;
     bool m_shouldClose;
+    bool m_minimized = false;
+
+    void handleEvent(const SDL_Event& event);
 };
 
 } // namespace graphyne::platform
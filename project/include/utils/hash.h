@@ -0,0 +1,38 @@
+/**
+ * @file hash.h
+ * @brief Fast non-cryptographic hashing for content keys
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace graphyne::utils
+{
+
+/**
+ * @brief Hash a block of memory with XXH64
+ * @param data Pointer to the data
+ * @param size Size of the data in bytes
+ * @param seed Seed value
+ * @return 64-bit hash
+ */
+uint64_t hash64(const void* data, size_t size, uint64_t seed = 0);
+
+/**
+ * @brief Mix a value into an existing hash
+ * @param seed Hash to extend
+ * @param value Value to mix in
+ * @return Combined hash
+ */
+uint64_t hashCombine(uint64_t seed, uint64_t value);
+
+/**
+ * @brief Format a hash as a fixed-width lowercase hexadecimal string
+ * @param hash Hash to format
+ * @return 16 character string
+ */
+std::string hashToString(uint64_t hash);
+
+} // namespace graphyne::utils
@@ -0,0 +1,201 @@
+/**
+ * @file profiler.h
+ * @brief Scoped CPU profiler with Chrome trace and Perfetto export
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace graphyne::utils
+{
+
+/**
+ * @enum ProfileEventType
+ * @brief Kind of a recorded profiler event
+ */
+enum class ProfileEventType : uint8_t
+{
+    Begin,
+    End,
+    Frame
+};
+
+/**
+ * @struct ProfileEvent
+ * @brief Single timestamped event in a thread buffer
+ */
+struct ProfileEvent
+{
+    const char* name = nullptr; // Must have static lifetime, typically a string literal
+    uint64_t timestamp = 0;     // Nanoseconds on the steady clock
+    uint32_t frameIndex = 0;    // Only used by frame markers
+    ProfileEventType type = ProfileEventType::Begin;
+};
+
+/**
+ * @class Profiler
+ * @brief Records scope begin/end events into per-thread buffers and exports them as traces
+ *
+ * Each thread appends to its own buffer without locking, the only synchronization on the
+ * recording path is a release store publishing the new event count. Buffers grow in fixed
+ * size chunks up to a per-thread limit, events past the limit are dropped and counted.
+ * Recording is off until setEnabled(true) is called.
+ */
+class Profiler
+{
+public:
+    /**
+     * @brief Get singleton instance of the profiler
+     * @return Reference to the profiler instance
+     */
+    static Profiler& getInstance();
+
+    /**
+     * @brief Start or stop recording events
+     * @param enabled True to record, false to ignore all events
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief Check if events are currently recorded
+     * @return True if recording, false otherwise
+     */
+    bool isEnabled() const;
+
+    /**
+     * @brief Name the calling thread in exported traces
+     * @param name Thread name, copied
+     */
+    void setThreadName(const std::string& name);
+
+    /**
+     * @brief Record the start of a scope on the calling thread
+     * @param name Scope name with static lifetime
+     */
+    void beginScope(const char* name);
+
+    /**
+     * @brief Record the end of the innermost open scope on the calling thread
+     * @param name Scope name with static lifetime, must match beginScope()
+     */
+    void endScope(const char* name);
+
+    /**
+     * @brief Record the start of a frame
+     * @param frameIndex Index of the frame that starts
+     */
+    void markFrame(uint64_t frameIndex);
+
+    /**
+     * @brief Create a track for events not recorded by a thread, such as GPU work
+     * @param name Track name, shown like a thread name in exported traces
+     * @return Track identifier for recordTrackEvent()
+     */
+    uint32_t createTrack(const std::string& name);
+
+    /**
+     * @brief Record an event with an explicit timestamp on a track
+     *
+     * Events of one track must be recorded by one thread at a time, in timestamp order.
+     *
+     * @param track Track returned by createTrack()
+     * @param name Scope name with static lifetime
+     * @param type Begin or End
+     * @param timestamp Nanoseconds on the steady clock
+     */
+    void recordTrackEvent(uint32_t track, const char* name, ProfileEventType type, uint64_t timestamp);
+
+    /**
+     * @brief Get a copy of a string that lives as long as the profiler, for names built at runtime
+     * @param name String to copy, equal strings share one copy
+     * @return Pointer usable as a scope name
+     */
+    const char* internName(const std::string& name);
+
+    /**
+     * @brief Discard all recorded events
+     *
+     * Must not be called while other threads may be recording.
+     */
+    void clear();
+
+    /**
+     * @brief Get the number of events dropped because a thread buffer was full
+     * @return Dropped event count
+     */
+    uint64_t getDroppedEventCount() const;
+
+    /**
+     * @brief Write the recorded events as Chrome trace event JSON (chrome://tracing, ui.perfetto.dev)
+     * @param path Output file path
+     * @return True if the file was written, false otherwise
+     */
+    bool exportChromeTrace(const std::string& path) const;
+
+    /**
+     * @brief Write the recorded events as a Perfetto protobuf trace (ui.perfetto.dev, trace_processor)
+     * @param path Output file path
+     * @return True if the file was written, false otherwise
+     */
+    bool exportPerfettoTrace(const std::string& path) const;
+
+    /**
+     * @brief Write the recorded events, choosing the format from the extension
+     * @param path Output file path, ".json" selects Chrome trace JSON, anything else Perfetto
+     * @return True if the file was written, false otherwise
+     */
+    bool exportTrace(const std::string& path) const;
+
+    /**
+     * @brief Get the current profiler timestamp
+     * @return Nanoseconds on the steady clock
+     */
+    static uint64_t now();
+
+private:
+    // Private constructor for singleton
+    Profiler();
+    ~Profiler();
+
+    // Deleted copy and move constructors and assignment operators
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+    Profiler(Profiler&&) = delete;
+    Profiler& operator=(Profiler&&) = delete;
+
+    struct ProfilerImpl;
+    std::unique_ptr<ProfilerImpl> m_impl;
+};
+
+/**
+ * @class ProfileScope
+ * @brief Records a scope for the lifetime of the object, use through GN_PROFILE_SCOPE
+ */
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char* name) : m_name(name) { Profiler::getInstance().beginScope(name); }
+    ~ProfileScope() { Profiler::getInstance().endScope(m_name); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* m_name;
+};
+
+// Instrumentation macros, compiled out entirely when GRAPHYNE_ENABLE_PROFILING is 0
+#define GN_PROFILE_CONCAT_IMPL(a, b) a##b
+#define GN_PROFILE_CONCAT(a, b) GN_PROFILE_CONCAT_IMPL(a, b)
+
+#if defined(GRAPHYNE_ENABLE_PROFILING) && GRAPHYNE_ENABLE_PROFILING
+#define GN_PROFILE_SCOPE(name) ::graphyne::utils::ProfileScope GN_PROFILE_CONCAT(gnProfileScope, __LINE__)(name)
+#define GN_PROFILE_FRAME(frameIndex) ::graphyne::utils::Profiler::getInstance().markFrame(frameIndex)
+#else
+#define GN_PROFILE_SCOPE(name) ((void)0)
+#define GN_PROFILE_FRAME(frameIndex) ((void)0)
+#endif
+
+} // namespace graphyne::utils
@@ -0,0 +1,262 @@
+#include "assets/asset_cache.h"
+#include "utils/hash.h"
+#include "utils/logger.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace graphyne::assets
+{
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+constexpr const char* ENTRY_EXTENSION = ".bin";
+constexpr const char* TEMP_EXTENSION = ".tmp";
+
+int64_t toTicks(fs::file_time_type time)
+{
+    return static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+} // namespace
+
+AssetCache::AssetCache(std::string directory, uint64_t maxSize) : m_directory(std::move(directory)), m_maxSize(maxSize)
+{
+}
+
+bool AssetCache::initialize()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::error_code error;
+    fs::create_directories(m_directory, error);
+    if (error)
+    {
+        GN_ERROR("Failed to create asset cache directory {}: {}", m_directory, error.message());
+        return false;
+    }
+
+    m_entries.clear();
+    m_totalSize = 0;
+
+    for (auto it = fs::recursive_directory_iterator(m_directory, error); !error && it != fs::recursive_directory_iterator();
+         it.increment(error))
+    {
+        if (!it->is_regular_file(error))
+        {
+            continue;
+        }
+
+        const fs::path& path = it->path();
+        if (path.extension() == TEMP_EXTENSION)
+        {
+            // Leftover from an interrupted write
+            fs::remove(path, error);
+            continue;
+        }
+
+        std::string stem = path.stem().string();
+        if (path.extension() != ENTRY_EXTENSION || stem.size() != 16)
+        {
+            continue;
+        }
+
+        // The key must round-trip to this exact path, or trimming would delete another file
+        uint64_t key = 0;
+        const char* stemEnd = stem.data() + stem.size();
+        auto [parsedEnd, parseError] = std::from_chars(stem.data(), stemEnd, key, 16);
+        if (parseError != std::errc() || parsedEnd != stemEnd || fs::path(getEntryPath(key)) != path)
+        {
+            GN_WARNING("Ignoring unexpected file in asset cache: {}", path.string());
+            continue;
+        }
+
+        Entry entry;
+        entry.size = static_cast<uint64_t>(it->file_size(error));
+        entry.lastAccess = toTicks(it->last_write_time(error));
+        m_entries[key] = entry;
+        m_totalSize += entry.size;
+    }
+
+    if (error)
+    {
+        GN_WARNING("Asset cache scan stopped early: {}", error.message());
+    }
+
+    GN_INFO("Asset cache initialized at {}: {} entries, {} bytes", m_directory, m_entries.size(), m_totalSize);
+    trimLocked();
+    return true;
+}
+
+bool AssetCache::load(uint64_t key, std::vector<uint8_t>& data)
+{
+    std::string path = getEntryPath(key);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_entries.find(key) == m_entries.end())
+        {
+            return false;
+        }
+    }
+
+    // Read outside of the lock so concurrent loads don't serialize on disk I/O
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        removeLocked(key);
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    file.close();
+
+    std::error_code error;
+    auto now = fs::file_time_type::clock::now();
+    fs::last_write_time(path, now, error);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(key);
+    if (it != m_entries.end())
+    {
+        it->second.lastAccess = toTicks(now);
+    }
+    return true;
+}
+
+bool AssetCache::store(uint64_t key, const std::vector<uint8_t>& data)
+{
+    static std::atomic<uint64_t> tempCounter{0};
+
+    if (contains(key))
+    {
+        // Same key means same content, nothing to write
+        return true;
+    }
+
+    fs::path path = getEntryPath(key);
+    fs::path tempPath = path;
+    tempPath += "." + std::to_string(tempCounter.fetch_add(1)) + TEMP_EXTENSION;
+
+    std::error_code error;
+    fs::create_directories(path.parent_path(), error);
+
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            GN_ERROR("Failed to open asset cache entry for writing: {}", tempPath.string());
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!file.good())
+        {
+            file.close();
+            fs::remove(tempPath, error);
+            GN_ERROR("Failed to write asset cache entry: {}", tempPath.string());
+            return false;
+        }
+    }
+
+    fs::rename(tempPath, path, error);
+    if (error)
+    {
+        fs::remove(tempPath, error);
+        GN_ERROR("Failed to commit asset cache entry: {}", path.string());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry& entry = m_entries[key];
+    m_totalSize -= entry.size;
+    entry.size = data.size();
+    entry.lastAccess = toTicks(fs::file_time_type::clock::now());
+    m_totalSize += entry.size;
+    trimLocked();
+    return true;
+}
+
+bool AssetCache::contains(uint64_t key) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.find(key) != m_entries.end();
+}
+
+void AssetCache::remove(uint64_t key)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    removeLocked(key);
+}
+
+void AssetCache::trim()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    trimLocked();
+}
+
+uint64_t AssetCache::getSize() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_totalSize;
+}
+
+std::string AssetCache::getEntryPath(uint64_t key) const
+{
+    // Shard by the first byte of the key to keep directories small
+    std::string name = utils::hashToString(key);
+    return (fs::path(m_directory) / name.substr(0, 2) / (name + ENTRY_EXTENSION)).string();
+}
+
+void AssetCache::removeLocked(uint64_t key)
+{
+    auto it = m_entries.find(key);
+    if (it == m_entries.end())
+    {
+        return;
+    }
+
+    std::error_code error;
+    fs::remove(getEntryPath(key), error);
+    m_totalSize -= it->second.size;
+    m_entries.erase(it);
+}
+
+void AssetCache::trimLocked()
+{
+    if (m_totalSize <= m_maxSize)
+    {
+        return;
+    }
+
+    // Trim below the limit so that the next few stores don't trigger another pass
+    uint64_t targetSize = m_maxSize - m_maxSize / 10;
+
+    std::vector<std::pair<int64_t, uint64_t>> byAge;
+    byAge.reserve(m_entries.size());
+    for (const auto& [key, entry] : m_entries)
+    {
+        byAge.emplace_back(entry.lastAccess, key);
+    }
+    std::sort(byAge.begin(), byAge.end());
+
+    size_t evicted = 0;
+    for (const auto& [lastAccess, key] : byAge)
+    {
+        if (m_totalSize <= targetSize)
+        {
+            break;
+        }
+
+        removeLocked(key);
+        ++evicted;
+    }
+
+    GN_INFO("Asset cache trimmed {} entries, {} bytes remaining", evicted, m_totalSize);
+}
+
+} // namespace graphyne::assets
@@ -0,0 +1,123 @@
+#include "assets/asset_pipeline.h"
+#include "core/job_system.h"
+#include "utils/hash.h"
+#include "utils/logger.h"
+#include <fstream>
+#include <iterator>
+
+namespace graphyne::assets
+{
+
+namespace
+{
+
+// Distinguishes cache keys of different asset types cooked from identical bytes
+constexpr uint64_t TEXTURE_KEY_SEED = 0x54455854; // "TEXT"
+
+bool readFile(const std::string& path, std::vector<uint8_t>& data)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+} // namespace
+
+AssetPipeline::AssetPipeline(const AssetPipelineConfig& config) : m_config(config) {}
+
+bool AssetPipeline::initialize()
+{
+    if (!m_config.enableCache)
+    {
+        GN_INFO("Asset cache disabled");
+        return true;
+    }
+
+    m_cache = std::make_unique<AssetCache>(m_config.cacheDirectory, m_config.cacheSizeLimit);
+    if (!m_cache->initialize())
+    {
+        // The pipeline still works without a cache, it just cooks everything
+        GN_WARNING("Failed to initialize asset cache, assets will be cooked on every load");
+        m_cache.reset();
+    }
+    return true;
+}
+
+void AssetPipeline::shutdown()
+{
+    m_cache.reset();
+}
+
+bool AssetPipeline::loadTexture(const std::string& path, const TextureCookSettings& settings, CookedTexture& texture)
+{
+    std::vector<uint8_t> source;
+    if (!readFile(path, source))
+    {
+        GN_ERROR("Failed to read texture source: {}", path);
+        return false;
+    }
+
+    uint64_t key = computeTextureKey(source, settings);
+    if (m_cache)
+    {
+        std::vector<uint8_t> cooked;
+        if (m_cache->load(key, cooked))
+        {
+            if (TextureCooker::deserialize(cooked, texture))
+            {
+                GN_DEBUG("Texture cache hit: {} ({})", path, utils::hashToString(key));
+                return true;
+            }
+            // Removed so that the fresh cook below replaces it, store() skips keys already in the cache
+            GN_WARNING("Discarding corrupt cache entry for {}", path);
+            m_cache->remove(key);
+        }
+    }
+
+    if (!m_textureCooker.cookMemory(source, settings, texture))
+    {
+        GN_ERROR("Failed to cook texture: {}", path);
+        return false;
+    }
+
+    if (m_cache)
+    {
+        std::vector<uint8_t> cooked;
+        TextureCooker::serialize(texture, cooked);
+        m_cache->store(key, cooked);
+    }
+
+    GN_DEBUG("Texture cooked: {} ({})", path, utils::hashToString(key));
+    return true;
+}
+
+void AssetPipeline::loadTextureAsync(const std::string& path,
+                                     const TextureCookSettings& settings,
+                                     TextureCallback callback,
+                                     core::JobCounter* counter)
+{
+    core::JobSystem::getInstance().submit(
+        [this, path, settings, callback = std::move(callback)]() {
+            CookedTexture texture;
+            bool success = loadTexture(path, settings, texture);
+            callback(success, std::move(texture));
+        },
+        counter,
+        core::JobSystem::Priority::Background);
+}
+
+uint64_t AssetPipeline::computeTextureKey(const std::vector<uint8_t>& source, const TextureCookSettings& settings)
+{
+    uint64_t key = utils::hash64(source.data(), source.size(), TEXTURE_KEY_SEED);
+    key = utils::hashCombine(key, TextureCooker::COOKER_VERSION);
+    key = utils::hashCombine(key, static_cast<uint64_t>(settings.format));
+    key = utils::hashCombine(key, settings.generateMips ? 1 : 0);
+    key = utils::hashCombine(key, settings.maxMipLevels);
+    return key;
+}
+
+} // namespace graphyne::assets
@@ -0,0 +1,386 @@
+#include "assets/block_compression.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace graphyne::assets
+{
+
+namespace
+{
+
+constexpr int TEXELS_PER_BLOCK = 16;
+
+// Find the dominant direction of a texel cloud using power iteration on its covariance matrix
+template <int Channels>
+void computePrincipalAxis(const uint8_t* texels, float* mean, float* axis)
+{
+    for (int c = 0; c < Channels; ++c)
+    {
+        mean[c] = 0.0f;
+        for (int i = 0; i < TEXELS_PER_BLOCK; ++i)
+        {
+            mean[c] += texels[i * 4 + c];
+        }
+        mean[c] /= TEXELS_PER_BLOCK;
+    }
+
+    float covariance[Channels][Channels] = {};
+    for (int i = 0; i < TEXELS_PER_BLOCK; ++i)
+    {
+        float delta[Channels];
+        for (int c = 0; c < Channels; ++c)
+        {
+            delta[c] = texels[i * 4 + c] - mean[c];
+        }
+        for (int a = 0; a < Channels; ++a)
+        {
+            for (int b = 0; b < Channels; ++b)
+            {
+                covariance[a][b] += delta[a] * delta[b];
+            }
+        }
+    }
+
+    for (int c = 0; c < Channels; ++c)
+    {
+        axis[c] = 1.0f;
+    }
+
+    for (int iteration = 0; iteration < 8; ++iteration)
+    {
+        float next[Channels] = {};
+        for (int a = 0; a < Channels; ++a)
+        {
+            for (int b = 0; b < Channels; ++b)
+            {
+                next[a] += covariance[a][b] * axis[b];
+            }
+        }
+
+        float length = 0.0f;
+        for (int c = 0; c < Channels; ++c)
+        {
+            length += next[c] * next[c];
+        }
+        length = std::sqrt(length);
+
+        if (length < 1e-6f)
+        {
+            // Flat block, any axis works
+            break;
+        }
+
+        for (int c = 0; c < Channels; ++c)
+        {
+            axis[c] = next[c] / length;
+        }
+    }
+}
+
+// Compute the extreme points of the texels projected on an axis
+template <int Channels>
+void computeEndpoints(const uint8_t* texels, const float* mean, const float* axis, float* minPoint, float* maxPoint)
+{
+    float minT = 0.0f;
+    float maxT = 0.0f;
+    for (int i = 0; i < TEXELS_PER_BLOCK; ++i)
+    {
+        float t = 0.0f;
+        for (int c = 0; c < Channels; ++c)
+        {
+            t += (texels[i * 4 + c] - mean[c]) * axis[c];
+        }
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+
+    for (int c = 0; c < Channels; ++c)
+    {
+        minPoint[c] = std::clamp(mean[c] + axis[c] * minT, 0.0f, 255.0f);
+        maxPoint[c] = std::clamp(mean[c] + axis[c] * maxT, 0.0f, 255.0f);
+    }
+}
+
+uint16_t packRgb565(const float* color)
+{
+    auto r = static_cast<uint16_t>(std::lround(color[0] * 31.0f / 255.0f));
+    auto g = static_cast<uint16_t>(std::lround(color[1] * 63.0f / 255.0f));
+    auto b = static_cast<uint16_t>(std::lround(color[2] * 31.0f / 255.0f));
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+void unpackRgb565(uint16_t packed, int* color)
+{
+    int r = (packed >> 11) & 0x1F;
+    int g = (packed >> 5) & 0x3F;
+    int b = packed & 0x1F;
+    color[0] = (r << 3) | (r >> 2);
+    color[1] = (g << 2) | (g >> 4);
+    color[2] = (b << 3) | (b >> 2);
+}
+
+void writeLittleEndian16(uint8_t* output, uint16_t value)
+{
+    output[0] = static_cast<uint8_t>(value & 0xFF);
+    output[1] = static_cast<uint8_t>(value >> 8);
+}
+
+// Color part of BC1/BC3, always uses the four color mode
+void encodeColorBlock(const uint8_t* texels, uint8_t* output)
+{
+    float mean[3];
+    float axis[3];
+    float minColor[3];
+    float maxColor[3];
+    computePrincipalAxis<3>(texels, mean, axis);
+    computeEndpoints<3>(texels, mean, axis, minColor, maxColor);
+
+    uint16_t color0 = packRgb565(maxColor);
+    uint16_t color1 = packRgb565(minColor);
+    if (color0 < color1)
+    {
+        std::swap(color0, color1);
+    }
+
+    writeLittleEndian16(output, color0);
+    writeLittleEndian16(output + 2, color1);
+
+    uint32_t indices = 0;
+    if (color0 != color1)
+    {
+        int palette[4][3];
+        unpackRgb565(color0, palette[0]);
+        unpackRgb565(color1, palette[1]);
+        for (int c = 0; c < 3; ++c)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        for (int i = 0; i < TEXELS_PER_BLOCK; ++i)
+        {
+            uint32_t bestIndex = 0;
+            int bestError = 0x7FFFFFFF;
+            for (uint32_t p = 0; p < 4; ++p)
+            {
+                int error = 0;
+                for (int c = 0; c < 3; ++c)
+                {
+                    int delta = texels[i * 4 + c] - palette[p][c];
+                    error += delta * delta;
+                }
+                if (error < bestError)
+                {
+                    bestError = error;
+                    bestIndex = p;
+                }
+            }
+            indices |= bestIndex << (i * 2);
+        }
+    }
+
+    for (int i = 0; i < 4; ++i)
+    {
+        output[4 + i] = static_cast<uint8_t>((indices >> (i * 8)) & 0xFF);
+    }
+}
+
+// Single channel block used for BC3 alpha and both BC5 channels
+void encodeSingleChannelBlock(const uint8_t* texels, int channel, uint8_t* output)
+{
+    int minValue = 255;
+    int maxValue = 0;
+    for (int i = 0; i < TEXELS_PER_BLOCK; ++i)
+    {
+        int value = texels[i * 4 + channel];
+        minValue = std::min(minValue, value);
+        maxValue = std::max(maxValue, value);
+    }
+
+    output[0] = static_cast<uint8_t>(maxValue);
+    output[1] = static_cast<uint8_t>(minValue);
+
+    uint64_t indices = 0;
+    if (maxValue != minValue)
+    {
+        // Eight value mode: endpoint 0 > endpoint 1
+        int palette[8];
+        palette[0] = maxValue;
+        palette[1] = minValue;
+        for (int i = 2; i < 8; ++i)
+        {
+            palette[i] = ((8 - i) * maxValue + (i - 1) * minValue) / 7;
+        }
+
+        for (int i = 0; i < TEXELS_PER_BLOCK; ++i)
+        {
+            int value = texels[i * 4 + channel];
+            uint64_t bestIndex = 0;
+            int bestError = 256;
+            for (int p = 0; p < 8; ++p)
+            {
+                int error = std::abs(value - palette[p]);
+                if (error < bestError)
+                {
+                    bestError = error;
+                    bestIndex = static_cast<uint64_t>(p);
+                }
+            }
+            indices |= bestIndex << (i * 3);
+        }
+    }
+
+    for (int i = 0; i < 6; ++i)
+    {
+        output[2 + i] = static_cast<uint8_t>((indices >> (i * 8)) & 0xFF);
+    }
+}
+
+/**
+ * @class BitWriter
+ * @brief Writes bit fields LSB first into a 128-bit block
+ */
+class BitWriter
+{
+public:
+    explicit BitWriter(uint8_t* output) : m_output(output) { std::memset(m_output, 0, 16); }
+
+    void write(uint32_t value, int bitCount)
+    {
+        for (int i = 0; i < bitCount; ++i)
+        {
+            if ((value >> i) & 1u)
+            {
+                m_output[m_position >> 3] |= static_cast<uint8_t>(1u << (m_position & 7));
+            }
+            ++m_position;
+        }
+    }
+
+private:
+    uint8_t* m_output;
+    int m_position = 0;
+};
+
+constexpr int BC7_WEIGHTS_4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+// Quantize an endpoint to 7 bits per channel plus a shared p-bit, picking the p-bit with the lower error
+void quantizeBc7Endpoint(const float* endpoint, uint32_t* quantized, uint32_t& pBit)
+{
+    float bestError = 0.0f;
+    for (uint32_t p = 0; p < 2; ++p)
+    {
+        uint32_t candidate[4];
+        float error = 0.0f;
+        for (int c = 0; c < 4; ++c)
+        {
+            float value = std::round((endpoint[c] - static_cast<float>(p)) * 0.5f);
+            candidate[c] = static_cast<uint32_t>(std::clamp(value, 0.0f, 127.0f));
+            float delta = static_cast<float>((candidate[c] << 1) | p) - endpoint[c];
+            error += delta * delta;
+        }
+
+        if (p == 0 || error < bestError)
+        {
+            bestError = error;
+            pBit = p;
+            std::copy(candidate, candidate + 4, quantized);
+        }
+    }
+}
+
+} // namespace
+
+void encodeBc1Block(const uint8_t* texels, uint8_t* output)
+{
+    encodeColorBlock(texels, output);
+}
+
+void encodeBc3Block(const uint8_t* texels, uint8_t* output)
+{
+    encodeSingleChannelBlock(texels, 3, output);
+    encodeColorBlock(texels, output + 8);
+}
+
+void encodeBc5Block(const uint8_t* texels, uint8_t* output)
+{
+    encodeSingleChannelBlock(texels, 0, output);
+    encodeSingleChannelBlock(texels, 1, output + 8);
+}
+
+void encodeBc7Block(const uint8_t* texels, uint8_t* output)
+{
+    float mean[4];
+    float axis[4];
+    float minPoint[4];
+    float maxPoint[4];
+    computePrincipalAxis<4>(texels, mean, axis);
+    computeEndpoints<4>(texels, mean, axis, minPoint, maxPoint);
+
+    uint32_t endpoints[2][4];
+    uint32_t pBits[2] = {0, 0};
+    quantizeBc7Endpoint(minPoint, endpoints[0], pBits[0]);
+    quantizeBc7Endpoint(maxPoint, endpoints[1], pBits[1]);
+
+    int palette[16][4];
+    for (int c = 0; c < 4; ++c)
+    {
+        int e0 = static_cast<int>((endpoints[0][c] << 1) | pBits[0]);
+        int e1 = static_cast<int>((endpoints[1][c] << 1) | pBits[1]);
+        for (int i = 0; i < 16; ++i)
+        {
+            palette[i][c] = ((64 - BC7_WEIGHTS_4[i]) * e0 + BC7_WEIGHTS_4[i] * e1 + 32) >> 6;
+        }
+    }
+
+    uint32_t indices[TEXELS_PER_BLOCK];
+    for (int i = 0; i < TEXELS_PER_BLOCK; ++i)
+    {
+        uint32_t bestIndex = 0;
+        int bestError = 0x7FFFFFFF;
+        for (uint32_t p = 0; p < 16; ++p)
+        {
+            int error = 0;
+            for (int c = 0; c < 4; ++c)
+            {
+                int delta = texels[i * 4 + c] - palette[p][c];
+                error += delta * delta;
+            }
+            if (error < bestError)
+            {
+                bestError = error;
+                bestIndex = p;
+            }
+        }
+        indices[i] = bestIndex;
+    }
+
+    // The anchor index is stored with an implicit zero MSB, swap the endpoints if needed
+    if (indices[0] & 0x8)
+    {
+        std::swap(endpoints[0], endpoints[1]);
+        std::swap(pBits[0], pBits[1]);
+        for (uint32_t& index : indices)
+        {
+            index = 15 - index;
+        }
+    }
+
+    BitWriter writer(output);
+    writer.write(1u << 6, 7); // Mode 6
+    for (int c = 0; c < 4; ++c)
+    {
+        writer.write(endpoints[0][c], 7);
+        writer.write(endpoints[1][c], 7);
+    }
+    writer.write(pBits[0], 1);
+    writer.write(pBits[1], 1);
+    writer.write(indices[0], 3);
+    for (int i = 1; i < TEXELS_PER_BLOCK; ++i)
+    {
+        writer.write(indices[i], 4);
+    }
+}
+
+} // namespace graphyne::assets
@@ -0,0 +1,181 @@
+#include "assets/hot_reloader.h"
+#include "assets/asset_pipeline.h"
+#include "utils/logger.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+
+namespace graphyne::assets
+{
+
+namespace
+{
+
+std::string normalizePath(const std::string& path)
+{
+    return std::filesystem::path(path).lexically_normal().string();
+}
+
+} // namespace
+
+HotReloader::HotReloader(AssetPipeline& pipeline, uint32_t retireLatency, uint32_t maxSwapsPerFrame)
+    : m_pipeline(pipeline), m_retireLatency(retireLatency), m_maxSwapsPerFrame(maxSwapsPerFrame)
+{
+}
+
+HotReloader::~HotReloader()
+{
+    shutdown();
+}
+
+bool HotReloader::initialize()
+{
+    if (!m_watcher.initialize())
+    {
+        GN_WARNING("Hot reload unavailable, file watcher failed to initialize");
+        return false;
+    }
+
+    GN_INFO("Hot reload enabled");
+    return true;
+}
+
+void HotReloader::shutdown()
+{
+    // Jobs reference this object, they have to finish before anything is torn down
+    core::JobSystem::getInstance().wait(m_cookJobs);
+
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_pendingSwaps.clear();
+    }
+
+    // The caller guarantees the GPU is idle at this point
+    for (RetiredResource& resource : m_retired)
+    {
+        resource.retire();
+    }
+    m_retired.clear();
+
+    m_files.clear();
+    m_watcher.shutdown();
+}
+
+void HotReloader::watch(const std::string& path, CookFunction cook)
+{
+    std::string normalized = normalizePath(path);
+    m_files[normalized].cook = std::move(cook);
+
+    std::filesystem::path directory = std::filesystem::path(normalized).parent_path();
+    m_watcher.watchDirectory(directory.empty() ? "." : directory.string());
+}
+
+void HotReloader::watchTexture(const std::string& path,
+                               const TextureCookSettings& settings,
+                               std::function<RetireFunction(CookedTexture&& texture)> swap)
+{
+    watch(path, [this, settings, swap = std::move(swap)](const std::string& changedPath) -> SwapFunction {
+        auto texture = std::make_shared<CookedTexture>();
+        if (!m_pipeline.loadTexture(changedPath, settings, *texture))
+        {
+            return {};
+        }
+        return [swap, texture]() { return swap(std::move(*texture)); };
+    });
+}
+
+void HotReloader::watchFile(const std::string& path, std::function<RetireFunction(std::vector<uint8_t>&& data)> swap)
+{
+    watch(path, [swap = std::move(swap)](const std::string& changedPath) -> SwapFunction {
+        std::ifstream file(changedPath, std::ios::binary);
+        if (!file.is_open())
+        {
+            GN_ERROR("Failed to read changed file: {}", changedPath);
+            return {};
+        }
+
+        auto data = std::make_shared<std::vector<uint8_t>>((std::istreambuf_iterator<char>(file)),
+                                                           std::istreambuf_iterator<char>());
+        return [swap, data]() { return swap(std::move(*data)); };
+    });
+}
+
+void HotReloader::update()
+{
+    if (!m_watcher.isInitialized())
+    {
+        return;
+    }
+
+    m_watcher.poll(m_changedFiles);
+    for (const std::string& path : m_changedFiles)
+    {
+        auto it = m_files.find(path);
+        if (it != m_files.end())
+        {
+            startCook(path, it->second);
+        }
+    }
+}
+
+void HotReloader::applyPendingSwaps(uint64_t frameIndex)
+{
+    // Release resources no in-flight frame can reference anymore
+    while (!m_retired.empty() && m_retired.front().frameIndex + m_retireLatency <= frameIndex)
+    {
+        m_retired.front().retire();
+        m_retired.pop_front();
+    }
+
+    std::vector<PendingSwap> swaps;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        while (!m_pendingSwaps.empty() && swaps.size() < m_maxSwapsPerFrame)
+        {
+            swaps.push_back(std::move(m_pendingSwaps.front()));
+            m_pendingSwaps.pop_front();
+        }
+    }
+
+    for (PendingSwap& pending : swaps)
+    {
+        auto it = m_files.find(pending.path);
+        if (it == m_files.end() || it->second.generation != pending.generation)
+        {
+            // A newer cook of the same file is on its way
+            continue;
+        }
+
+        RetireFunction retire = pending.swap();
+        if (retire)
+        {
+            m_retired.push_back({frameIndex, std::move(retire)});
+        }
+        GN_INFO("Hot reloaded: {}", pending.path);
+    }
+}
+
+void HotReloader::startCook(const std::string& path, WatchedFile& file)
+{
+    uint64_t generation = ++file.generation;
+    CookFunction cook = file.cook;
+
+    // Background priority, a cook and its block compression must never run inside a frame's wait
+    core::JobSystem::getInstance().submit(
+        [this, path, generation, cook]() {
+            SwapFunction swap = cook(path);
+            if (!swap)
+            {
+                GN_WARNING("Hot reload of {} failed, keeping the previous version", path);
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            m_pendingSwaps.push_back({path, generation, std::move(swap)});
+        },
+        &m_cookJobs,
+        core::JobSystem::Priority::Background);
+}
+
+} // namespace graphyne::assets
@@ -0,0 +1,465 @@
+#include "assets/texture_cooker.h"
+#include "assets/block_compression.h"
+#include "core/job_system.h"
+#include "utils/logger.h"
+#include "utils/profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_PNG
+#define STBI_ONLY_TGA
+#define STBI_ONLY_HDR
+#include <stb_image.h>
+
+namespace graphyne::assets
+{
+
+using graphics::TextureFormat;
+
+namespace
+{
+
+constexpr uint32_t COOKED_TEXTURE_MAGIC = 0x58544E47; // "GNTX"
+
+// Serialized size of one mip: width, height, data offset and data size
+constexpr size_t MIP_RECORD_SIZE = 2 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+
+// Last TextureFormat enumerator, anything above it comes from a corrupt entry
+constexpr uint32_t LAST_TEXTURE_FORMAT = static_cast<uint32_t>(TextureFormat::Bc7Srgb);
+
+// Rows of texels or blocks handed to a single job
+constexpr uint32_t ROWS_PER_JOB = 8;
+
+float srgbToLinear(float value)
+{
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+float linearToSrgb(float value)
+{
+    return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+uint8_t toUnorm8(float value)
+{
+    return static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+}
+
+uint16_t floatToHalf(float value)
+{
+    uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    auto sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    uint32_t rawExponent = (bits >> 23) & 0xFF;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    if (rawExponent == 0xFF)
+    {
+        // Infinity or NaN
+        return static_cast<uint16_t>(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+    }
+
+    int32_t exponent = static_cast<int32_t>(rawExponent) - 127 + 15;
+    if (exponent >= 31)
+    {
+        return static_cast<uint16_t>(sign | 0x7C00);
+    }
+
+    if (exponent <= 0)
+    {
+        if (exponent < -10)
+        {
+            return sign;
+        }
+
+        // Denormalized half
+        mantissa |= 0x800000;
+        auto shift = static_cast<uint32_t>(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        if ((mantissa >> (shift - 1)) & 1)
+        {
+            ++half;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    uint32_t half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    if (mantissa & 0x1000)
+    {
+        // Round to nearest, a carry into the exponent is still correct
+        ++half;
+    }
+    return static_cast<uint16_t>(sign | half);
+}
+
+template <typename T>
+void appendValue(std::vector<uint8_t>& output, T value)
+{
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+    output.insert(output.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+bool readValue(const std::vector<uint8_t>& input, size_t& offset, T& value)
+{
+    if (offset + sizeof(T) > input.size())
+    {
+        return false;
+    }
+    std::memcpy(&value, input.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+} // namespace
+
+bool TextureCooker::cookFile(const std::string& path,
+                             const TextureCookSettings& settings,
+                             CookedTexture& output) const
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        GN_ERROR("Failed to open texture source: {}", path);
+        return false;
+    }
+
+    std::vector<uint8_t> source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (!cookMemory(source, settings, output))
+    {
+        GN_ERROR("Failed to cook texture: {}", path);
+        return false;
+    }
+    return true;
+}
+
+bool TextureCooker::cookMemory(const std::vector<uint8_t>& source,
+                               const TextureCookSettings& settings,
+                               CookedTexture& output) const
+{
+    GN_PROFILE_SCOPE("TextureCooker::cookMemory");
+
+    LinearImage image;
+    if (!decode(source, graphics::isSrgb(settings.format), image))
+    {
+        return false;
+    }
+
+    uint32_t mipCount = 1;
+    if (settings.generateMips)
+    {
+        mipCount = graphics::getFullMipCount(image.width, image.height);
+        if (settings.maxMipLevels > 0)
+        {
+            mipCount = std::min(mipCount, settings.maxMipLevels);
+        }
+    }
+
+    output.format = settings.format;
+    output.width = image.width;
+    output.height = image.height;
+    output.mips.resize(mipCount);
+
+    size_t totalSize = 0;
+    for (uint32_t level = 0; level < mipCount; ++level)
+    {
+        CookedMip& mip = output.mips[level];
+        mip.width = std::max(1u, image.width >> level);
+        mip.height = std::max(1u, image.height >> level);
+        mip.offset = totalSize;
+        mip.size = graphics::getMipSize(settings.format, mip.width, mip.height);
+        totalSize += mip.size;
+    }
+    output.data.assign(totalSize, 0);
+
+    LinearImage nextLevel;
+    for (uint32_t level = 0; level < mipCount; ++level)
+    {
+        encode(image, settings.format, output.data.data() + output.mips[level].offset);
+
+        if (level + 1 < mipCount)
+        {
+            downsample(image, nextLevel);
+            std::swap(image, nextLevel);
+        }
+    }
+
+    return true;
+}
+
+void TextureCooker::serialize(const CookedTexture& texture, std::vector<uint8_t>& output)
+{
+    output.clear();
+    output.reserve(texture.data.size() + 64 + texture.mips.size() * 24);
+
+    appendValue(output, COOKED_TEXTURE_MAGIC);
+    appendValue(output, COOKER_VERSION);
+    appendValue(output, static_cast<uint32_t>(texture.format));
+    appendValue(output, texture.width);
+    appendValue(output, texture.height);
+    appendValue(output, static_cast<uint32_t>(texture.mips.size()));
+    for (const CookedMip& mip : texture.mips)
+    {
+        appendValue(output, mip.width);
+        appendValue(output, mip.height);
+        appendValue(output, static_cast<uint64_t>(mip.offset));
+        appendValue(output, static_cast<uint64_t>(mip.size));
+    }
+    appendValue(output, static_cast<uint64_t>(texture.data.size()));
+    output.insert(output.end(), texture.data.begin(), texture.data.end());
+}
+
+bool TextureCooker::deserialize(const std::vector<uint8_t>& input, CookedTexture& texture)
+{
+    size_t offset = 0;
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint32_t format = 0;
+    uint32_t mipCount = 0;
+
+    if (!readValue(input, offset, magic) || magic != COOKED_TEXTURE_MAGIC || !readValue(input, offset, version) ||
+        version != COOKER_VERSION || !readValue(input, offset, format) || !readValue(input, offset, texture.width) ||
+        !readValue(input, offset, texture.height) || !readValue(input, offset, mipCount))
+    {
+        return false;
+    }
+
+    // Validated before allocating, the entry may be corrupt or crafted
+    if (format > LAST_TEXTURE_FORMAT || mipCount == 0 ||
+        mipCount > graphics::getFullMipCount(texture.width, texture.height) ||
+        mipCount > (input.size() - offset) / MIP_RECORD_SIZE)
+    {
+        return false;
+    }
+
+    texture.format = static_cast<TextureFormat>(format);
+    texture.mips.resize(mipCount);
+    for (CookedMip& mip : texture.mips)
+    {
+        uint64_t mipOffset = 0;
+        uint64_t mipSize = 0;
+        if (!readValue(input, offset, mip.width) || !readValue(input, offset, mip.height) ||
+            !readValue(input, offset, mipOffset) || !readValue(input, offset, mipSize))
+        {
+            return false;
+        }
+        mip.offset = static_cast<size_t>(mipOffset);
+        mip.size = static_cast<size_t>(mipSize);
+    }
+
+    uint64_t dataSize = 0;
+    if (!readValue(input, offset, dataSize) || dataSize != input.size() - offset)
+    {
+        return false;
+    }
+
+    for (const CookedMip& mip : texture.mips)
+    {
+        if (mip.offset > dataSize || mip.size > dataSize - mip.offset)
+        {
+            return false;
+        }
+    }
+
+    texture.data.assign(input.begin() + static_cast<std::ptrdiff_t>(offset), input.end());
+    return true;
+}
+
+bool TextureCooker::decode(const std::vector<uint8_t>& source, bool srgb, LinearImage& image) const
+{
+    if (source.empty())
+    {
+        GN_ERROR("Texture source is empty");
+        return false;
+    }
+
+    const auto* bytes = source.data();
+    auto length = static_cast<int>(source.size());
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+
+    if (stbi_is_hdr_from_memory(bytes, length))
+    {
+        // Radiance HDR is already linear
+        float* pixels = stbi_loadf_from_memory(bytes, length, &width, &height, &channels, 4);
+        if (!pixels)
+        {
+            GN_ERROR("Failed to decode HDR image: {}", stbi_failure_reason());
+            return false;
+        }
+
+        image.width = static_cast<uint32_t>(width);
+        image.height = static_cast<uint32_t>(height);
+        image.pixels.assign(pixels, pixels + static_cast<size_t>(width) * static_cast<size_t>(height) * 4);
+        stbi_image_free(pixels);
+        return true;
+    }
+
+    stbi_uc* pixels = stbi_load_from_memory(bytes, length, &width, &height, &channels, 4);
+    if (!pixels)
+    {
+        GN_ERROR("Failed to decode image: {}", stbi_failure_reason());
+        return false;
+    }
+
+    // Filtering has to happen on linear values, decode sRGB color through a lookup table
+    float colorTable[256];
+    for (int i = 0; i < 256; ++i)
+    {
+        float value = static_cast<float>(i) / 255.0f;
+        colorTable[i] = srgb ? srgbToLinear(value) : value;
+    }
+
+    image.width = static_cast<uint32_t>(width);
+    image.height = static_cast<uint32_t>(height);
+    image.pixels.resize(static_cast<size_t>(width) * static_cast<size_t>(height) * 4);
+
+    core::JobSystem::getInstance().parallelFor(
+        image.height, ROWS_PER_JOB, [&image, pixels, &colorTable](uint32_t begin, uint32_t end) {
+            for (size_t i = static_cast<size_t>(begin) * image.width * 4; i < static_cast<size_t>(end) * image.width * 4;
+                 i += 4)
+            {
+                image.pixels[i + 0] = colorTable[pixels[i + 0]];
+                image.pixels[i + 1] = colorTable[pixels[i + 1]];
+                image.pixels[i + 2] = colorTable[pixels[i + 2]];
+                image.pixels[i + 3] = static_cast<float>(pixels[i + 3]) / 255.0f;
+            }
+        });
+
+    stbi_image_free(pixels);
+    return true;
+}
+
+void TextureCooker::downsample(const LinearImage& source, LinearImage& destination) const
+{
+    destination.width = std::max(1u, source.width / 2);
+    destination.height = std::max(1u, source.height / 2);
+    destination.pixels.resize(static_cast<size_t>(destination.width) * destination.height * 4);
+
+    core::JobSystem::getInstance().parallelFor(
+        destination.height, ROWS_PER_JOB, [&source, &destination](uint32_t begin, uint32_t end) {
+            for (uint32_t y = begin; y < end; ++y)
+            {
+                uint32_t y0 = std::min(y * 2, source.height - 1);
+                uint32_t y1 = std::min(y * 2 + 1, source.height - 1);
+                for (uint32_t x = 0; x < destination.width; ++x)
+                {
+                    uint32_t x0 = std::min(x * 2, source.width - 1);
+                    uint32_t x1 = std::min(x * 2 + 1, source.width - 1);
+
+                    const float* p00 = &source.pixels[(static_cast<size_t>(y0) * source.width + x0) * 4];
+                    const float* p01 = &source.pixels[(static_cast<size_t>(y0) * source.width + x1) * 4];
+                    const float* p10 = &source.pixels[(static_cast<size_t>(y1) * source.width + x0) * 4];
+                    const float* p11 = &source.pixels[(static_cast<size_t>(y1) * source.width + x1) * 4];
+                    float* out = &destination.pixels[(static_cast<size_t>(y) * destination.width + x) * 4];
+
+                    for (int c = 0; c < 4; ++c)
+                    {
+                        out[c] = (p00[c] + p01[c] + p10[c] + p11[c]) * 0.25f;
+                    }
+                }
+            }
+        });
+}
+
+void TextureCooker::encode(const LinearImage& image, TextureFormat format, uint8_t* output) const
+{
+    auto& jobSystem = core::JobSystem::getInstance();
+    size_t texelCount = static_cast<size_t>(image.width) * image.height;
+
+    if (format == TextureFormat::Rgba16Float)
+    {
+        auto* halfs = reinterpret_cast<uint16_t*>(output);
+        jobSystem.parallelFor(image.height, ROWS_PER_JOB, [&image, halfs](uint32_t begin, uint32_t end) {
+            for (size_t i = static_cast<size_t>(begin) * image.width * 4; i < static_cast<size_t>(end) * image.width * 4;
+                 ++i)
+            {
+                halfs[i] = floatToHalf(image.pixels[i]);
+            }
+        });
+        return;
+    }
+
+    // Quantize to 8 bits first, sRGB formats are encoded back to gamma space
+    bool srgb = graphics::isSrgb(format);
+    std::vector<uint8_t> texels;
+    uint8_t* rgba8 = output;
+    if (graphics::isCompressed(format))
+    {
+        texels.resize(texelCount * 4);
+        rgba8 = texels.data();
+    }
+
+    jobSystem.parallelFor(image.height, ROWS_PER_JOB, [&image, rgba8, srgb](uint32_t begin, uint32_t end) {
+        for (size_t i = static_cast<size_t>(begin) * image.width * 4; i < static_cast<size_t>(end) * image.width * 4;
+             i += 4)
+        {
+            for (size_t c = 0; c < 3; ++c)
+            {
+                float value = image.pixels[i + c];
+                rgba8[i + c] = toUnorm8(srgb ? linearToSrgb(std::clamp(value, 0.0f, 1.0f)) : value);
+            }
+            rgba8[i + 3] = toUnorm8(image.pixels[i + 3]);
+        }
+    });
+
+    if (!graphics::isCompressed(format))
+    {
+        return;
+    }
+
+    void (*encodeBlock)(const uint8_t*, uint8_t*) = nullptr;
+    switch (format)
+    {
+        case TextureFormat::Bc1Unorm:
+        case TextureFormat::Bc1Srgb:
+            encodeBlock = encodeBc1Block;
+            break;
+        case TextureFormat::Bc3Unorm:
+        case TextureFormat::Bc3Srgb:
+            encodeBlock = encodeBc3Block;
+            break;
+        case TextureFormat::Bc5Unorm:
+            encodeBlock = encodeBc5Block;
+            break;
+        default:
+            encodeBlock = encodeBc7Block;
+            break;
+    }
+
+    uint32_t blocksX = std::max(1u, (image.width + 3) / 4);
+    uint32_t blocksY = std::max(1u, (image.height + 3) / 4);
+    size_t blockSize = graphics::getBlockSize(format);
+
+    jobSystem.parallelFor(
+        blocksY, ROWS_PER_JOB, [&image, &texels, output, encodeBlock, blocksX, blockSize](uint32_t begin, uint32_t end) {
+            uint8_t block[64];
+            for (uint32_t by = begin; by < end; ++by)
+            {
+                for (uint32_t bx = 0; bx < blocksX; ++bx)
+                {
+                    // Replicate edge texels for blocks hanging over the image border
+                    for (uint32_t ty = 0; ty < 4; ++ty)
+                    {
+                        uint32_t y = std::min(by * 4 + ty, image.height - 1);
+                        for (uint32_t tx = 0; tx < 4; ++tx)
+                        {
+                            uint32_t x = std::min(bx * 4 + tx, image.width - 1);
+                            std::memcpy(&block[(ty * 4 + tx) * 4],
+                                        &texels[(static_cast<size_t>(y) * image.width + x) * 4],
+                                        4);
+                        }
+                    }
+                    encodeBlock(block, output + (static_cast<size_t>(by) * blocksX + bx) * blockSize);
+                }
+            }
+        });
+}
+
+} // namespace graphyne::assets
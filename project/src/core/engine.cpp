@@ -1,12 +1,32 @@
 #include "core/engine.h"
+#include "assets/asset_pipeline.h"
+#include "assets/hot_reloader.h"
+#include "core/job_system.h"
 #include "graphics/renderer.h"
 #include "platform/window.h"
 #include "utils/logger.h"
+#include "utils/profiler.h"
 
 namespace graphyne
 {
 
-Engine::Engine(const Config& config) : m_config(config) {}
+namespace
+{
+
+// Delta time of the first frame, before any frame has been measured
+constexpr float INITIAL_DELTA_TIME = 1.0f / 60.0f;
+
+double getMilliseconds(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+{
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+} // namespace
+
+Engine::Engine(const Config& config)
+    : m_config(config), m_frameStats(config.frameStatsWindow, config.hitchThreshold)
+{
+}
 
 Engine::~Engine()
 {
@@ -30,27 +50,101 @@ bool Engine::initialize()
 
     GN_INFO("Initializing Graphyne Engine");
 
-    // Create window
-    m_window = std::make_unique<platform::Window>(m_config.windowWidth, m_config.windowHeight, m_config.appName);
-    if (!m_window->initialize())
+    if (m_config.enableProfiling)
+    {
+        utils::Profiler::getInstance().setThreadName("Main");
+        utils::Profiler::getInstance().setEnabled(true);
+    }
+
+    if (m_config.enablePerfCounters)
     {
-        GN_ERROR("Failed to initialize window");
+        // Not fatal, the phases are then reported with wall time only
+        m_perfCounters = std::make_unique<platform::PerfCounters>();
+        if (!m_perfCounters->initialize())
+        {
+            m_perfCounters.reset();
+        }
+    }
+
+    // Workers count into the phases they run jobs for, like parallel recording during render
+    core::JobSystem::ThreadCallback onWorkerStart;
+    if (m_perfCounters)
+    {
+        onWorkerStart = [counters = m_perfCounters.get()](uint32_t) { counters->addCurrentThread(); };
+    }
+
+    if (!core::JobSystem::getInstance().initialize(m_config.workerThreadCount, onWorkerStart))
+    {
+        GN_ERROR("Failed to initialize job system");
+        return false;
+    }
+
+    // Create asset pipeline
+    assets::AssetPipelineConfig assetConfig;
+    assetConfig.enableCache = m_config.enableAssetCache;
+    assetConfig.cacheDirectory = m_config.assetCacheDirectory;
+
+    m_assetPipeline = std::make_unique<assets::AssetPipeline>(assetConfig);
+    if (!m_assetPipeline->initialize())
+    {
+        GN_ERROR("Failed to initialize asset pipeline");
+        destroySubsystems();
         return false;
     }
 
+    // Create window, headless mode runs without one
+    if (m_config.headless)
+    {
+        GN_INFO("Running headless, no window will be created");
+    }
+    else
+    {
+        m_window = std::make_unique<platform::Window>(m_config.windowWidth, m_config.windowHeight, m_config.appName);
+        if (!m_window->initialize())
+        {
+            GN_ERROR("Failed to initialize window");
+            destroySubsystems();
+            return false;
+        }
+    }
+
     // Create renderer
     graphics::Renderer::Config rendererConfig;
+    bool useNullRenderer = m_config.headless && !m_config.offscreenRendering;
+    rendererConfig.backend = useNullRenderer ? graphics::Renderer::Backend::Null : graphics::Renderer::Backend::Vulkan;
     rendererConfig.appName = m_config.appName;
     rendererConfig.enableValidation = m_config.enableValidation;
     rendererConfig.enableVSync = m_config.enableVSync;
+    rendererConfig.presentLatency = m_config.uncappedPresent ? graphics::Renderer::PresentLatency::Uncapped
+                                                             : graphics::Renderer::PresentLatency::LowLatency;
+    rendererConfig.framesInFlight = m_config.framesInFlight;
+    rendererConfig.offscreen = m_config.headless && m_config.offscreenRendering;
+    rendererConfig.width = m_config.windowWidth;
+    rendererConfig.height = m_config.windowHeight;
+    rendererConfig.pipelineCachePath = m_config.pipelineCachePath;
+    rendererConfig.bindless = m_config.bindless;
+    rendererConfig.pipelineStatistics = m_config.pipelineStatistics;
 
-    m_renderer = graphics::Renderer::create(*m_window, rendererConfig);
+    m_renderer = graphics::Renderer::create(m_window.get(), rendererConfig);
     if (!m_renderer || !m_renderer->initialize())
     {
         GN_ERROR("Failed to initialize renderer");
+        destroySubsystems();
         return false;
     }
 
+    if (m_config.enableHotReload)
+    {
+        // Old resources are kept alive for as long as the renderer may still be processing them after a swap
+        uint32_t retireLatency = m_renderer->getConfig().framesInFlight;
+        m_hotReloader = std::make_unique<assets::HotReloader>(*m_assetPipeline, retireLatency);
+        if (!m_hotReloader->initialize())
+        {
+            // Not fatal, the engine simply runs without hot reload
+            m_hotReloader.reset();
+        }
+    }
+
     m_initialized = true;
     GN_INFO("Engine initialized successfully");
     return true;
@@ -65,6 +159,31 @@ void Engine::shutdown()
 
     GN_INFO("Shutting down Graphyne Engine");
 
+    destroySubsystems();
+
+    if (m_config.enableProfiling && !m_config.profileTracePath.empty())
+    {
+        utils::Profiler::getInstance().setEnabled(false);
+        utils::Profiler::getInstance().exportTrace(m_config.profileTracePath);
+    }
+
+    m_initialized = false;
+    GN_INFO("Engine shutdown complete");
+}
+
+void Engine::destroySubsystems()
+{
+    if (m_hotReloader)
+    {
+        // Retired resources are released right away, the GPU must not use them anymore
+        if (m_renderer)
+        {
+            m_renderer->waitIdle();
+        }
+        m_hotReloader->shutdown();
+        m_hotReloader.reset();
+    }
+
     if (m_renderer)
     {
         m_renderer->shutdown();
@@ -77,8 +196,16 @@ void Engine::shutdown()
         m_window.reset();
     }
 
-    m_initialized = false;
-    GN_INFO("Engine shutdown complete");
+    // Workers may still be cooking into the asset pipeline
+    core::JobSystem::getInstance().shutdown();
+
+    if (m_assetPipeline)
+    {
+        m_assetPipeline->shutdown();
+        m_assetPipeline.reset();
+    }
+
+    m_perfCounters.reset();
 }
 
 int Engine::run()
@@ -89,14 +216,74 @@ int Engine::run()
         return -1;
     }
 
+    using Clock = std::chrono::steady_clock;
+
     m_running = true;
+    m_lastStatsLog = Clock::now();
     GN_INFO("Starting engine main loop");
 
+    float deltaTime = m_config.fixedDeltaTime > 0.0f ? m_config.fixedDeltaTime : INITIAL_DELTA_TIME;
     while (m_running)
     {
-        processEvents();
-        update(0.016f); // TODO: Implement proper delta time calculation
-        render();
+        // A minimized window has no swapchain to render to, sleep until an event restores it instead of
+        // spinning through empty frames. Not counted as a frame, so the statistics and delta time skip the pause
+        if (m_window && m_window->isMinimized())
+        {
+            m_window->waitEvents();
+            m_running = m_running && !m_window->shouldClose();
+            continue;
+        }
+
+        GN_PROFILE_FRAME(m_frameIndex);
+
+        core::FrameTiming timing;
+        Clock::time_point frameStart = Clock::now();
+
+        {
+            platform::PerfCounterScope counterScope(m_perfCounters.get(), m_phaseCounters.processEvents);
+            processEvents();
+        }
+        Clock::time_point eventsEnd = Clock::now();
+        timing.processEvents = getMilliseconds(frameStart, eventsEnd);
+
+        {
+            platform::PerfCounterScope counterScope(m_perfCounters.get(), m_phaseCounters.update);
+            update(deltaTime);
+        }
+        Clock::time_point updateEnd = Clock::now();
+        timing.update = getMilliseconds(eventsEnd, updateEnd);
+
+        {
+            platform::PerfCounterScope counterScope(m_perfCounters.get(), m_phaseCounters.render);
+            render();
+        }
+        Clock::time_point renderEnd = Clock::now();
+        timing.render = getMilliseconds(updateEnd, renderEnd);
+
+        ++m_frameIndex;
+
+        // Frame boundary, swap in hot reloaded assets
+        if (m_hotReloader)
+        {
+            GN_PROFILE_SCOPE("HotReloader::applyPendingSwaps");
+            m_hotReloader->applyPendingSwaps(m_frameIndex);
+        }
+
+        timing.frame = getMilliseconds(frameStart, Clock::now());
+        recordFrameTiming(timing);
+        deltaTime =
+            m_config.fixedDeltaTime > 0.0f ? m_config.fixedDeltaTime : static_cast<float>(timing.frame / 1000.0);
+
+        if (m_config.maxFrames > 0 && m_frameIndex >= m_config.maxFrames)
+        {
+            GN_INFO("Reached frame limit of {}", m_config.maxFrames);
+            m_running = false;
+        }
+    }
+
+    if (m_frameStats.getTotalFrameCount() > 0)
+    {
+        logFrameStats();
     }
 
     return 0;
@@ -104,19 +291,136 @@ int Engine::run()
 
 void Engine::processEvents()
 {
-    m_window->processEvents();
+    GN_PROFILE_SCOPE("Engine::processEvents");
+
+    if (m_window)
+    {
+        m_window->processEvents();
+        if (m_window->shouldClose())
+        {
+            m_running = false;
+        }
+    }
+
+    if (m_hotReloader)
+    {
+        m_hotReloader->update();
+    }
 }
 
 void Engine::update(float deltaTime)
 {
-    // TODO: Implement game logic update
+    GN_PROFILE_SCOPE("Engine::update");
+
+    if (m_updateCallback)
+    {
+        m_updateCallback(deltaTime);
+    }
 }
 
 void Engine::render()
 {
+    GN_PROFILE_SCOPE("Engine::render");
+
     m_renderer->beginFrame();
-    // TODO: Implement actual rendering
+    if (m_renderCallback)
+    {
+        m_renderCallback(*m_renderer);
+    }
     m_renderer->endFrame();
 }
 
+void Engine::recordFrameTiming(const core::FrameTiming& timing)
+{
+    if (m_frameStats.addFrame(timing))
+    {
+        GN_DEBUG("Hitch in frame {}: {:.2f} ms (events {:.2f} ms, update {:.2f} ms, render {:.2f} ms)",
+                 m_frameIndex,
+                 timing.frame,
+                 timing.processEvents,
+                 timing.update,
+                 timing.render);
+    }
+
+    if (m_config.statsLogInterval <= 0.0)
+    {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (std::chrono::duration<double>(now - m_lastStatsLog).count() >= m_config.statsLogInterval)
+    {
+        logFrameStats();
+        m_lastStatsLog = now;
+    }
+}
+
+void Engine::logFrameStats()
+{
+    core::FrameStatsSummary summary = m_frameStats.computeSummary();
+    const core::TimingSummary& frame = summary.frame;
+
+    GN_INFO("Frame time over {} frames: avg {:.2f} ms ({:.1f} FPS), p50 {:.2f}, p95 {:.2f}, p99 {:.2f}, max {:.2f} ms, "
+            "{} hitches above {:.1f} ms",
+            summary.frameCount,
+            frame.average,
+            frame.average > 0.0 ? 1000.0 / frame.average : 0.0,
+            frame.p50,
+            frame.p95,
+            frame.p99,
+            frame.max,
+            summary.hitchCount,
+            m_frameStats.getHitchThreshold());
+    GN_INFO("  p99/max: events {:.2f}/{:.2f} ms, update {:.2f}/{:.2f} ms, render {:.2f}/{:.2f} ms",
+            summary.processEvents.p99,
+            summary.processEvents.max,
+            summary.update.p99,
+            summary.update.max,
+            summary.render.p99,
+            summary.render.max);
+
+    const graphics::RenderStats& renderStats = m_renderer->getStats();
+    GN_INFO("  last frame: {} draws ({} indirect), {} dispatches, {} triangles, {} pipeline and {} descriptor binds, "
+            "{} barriers, {} KiB uploaded",
+            renderStats.drawCalls,
+            renderStats.indirectDrawCalls,
+            renderStats.dispatches,
+            renderStats.triangles,
+            renderStats.pipelineBinds,
+            renderStats.descriptorBinds,
+            renderStats.barriers,
+            renderStats.bytesUploaded / 1024);
+    const graphics::PipelineStatistics& pipelineStatistics = renderStats.pipelineStatistics;
+    if (pipelineStatistics.available)
+    {
+        GN_INFO("  GPU frame {}: {} primitives, {} after clipping, {} vertex, {} fragment, {} compute invocations",
+                pipelineStatistics.frameIndex,
+                pipelineStatistics.inputPrimitives,
+                pipelineStatistics.clippedPrimitives,
+                pipelineStatistics.vertexInvocations,
+                pipelineStatistics.fragmentInvocations,
+                pipelineStatistics.computeInvocations);
+    }
+
+    uint64_t frameCount = m_frameStats.getTotalFrameCount() - m_loggedFrameCount;
+    if (m_perfCounters && frameCount > 0)
+    {
+        auto logPhase = [frameCount](const char* name, const platform::PerfCounterValues& values) {
+            GN_INFO("  {}: IPC {:.2f}, {:.2f} cache misses per 1k instructions, per frame {} cycles, {} branch misses",
+                    name,
+                    values.getInstructionsPerCycle(),
+                    values.getCacheMissesPerKiloInstruction(),
+                    values.cycles / frameCount,
+                    values.branchMisses / frameCount);
+        };
+
+        logPhase("events", m_phaseCounters.processEvents - m_loggedPhaseCounters.processEvents);
+        logPhase("update", m_phaseCounters.update - m_loggedPhaseCounters.update);
+        logPhase("render", m_phaseCounters.render - m_loggedPhaseCounters.render);
+    }
+
+    m_loggedPhaseCounters = m_phaseCounters;
+    m_loggedFrameCount = m_frameStats.getTotalFrameCount();
+}
+
 } // namespace graphyne
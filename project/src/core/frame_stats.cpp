@@ -0,0 +1,113 @@
+#include "core/frame_stats.h"
+#include <algorithm>
+#include <cmath>
+
+namespace graphyne::core
+{
+
+namespace
+{
+
+// Nearest-rank percentile of sorted values
+double percentile(const std::vector<double>& sorted, double fraction)
+{
+    size_t rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+TimingSummary summarize(std::vector<double>& values)
+{
+    TimingSummary summary;
+    if (values.empty())
+    {
+        return summary;
+    }
+
+    std::sort(values.begin(), values.end());
+
+    double sum = 0.0;
+    for (double value : values)
+    {
+        sum += value;
+    }
+
+    summary.average = sum / static_cast<double>(values.size());
+    summary.p50 = percentile(values, 0.50);
+    summary.p95 = percentile(values, 0.95);
+    summary.p99 = percentile(values, 0.99);
+    summary.max = values.back();
+    return summary;
+}
+
+} // namespace
+
+FrameStats::FrameStats(uint32_t windowSize, double hitchThreshold)
+    : m_windowSize(std::max(1u, windowSize)), m_hitchThreshold(hitchThreshold)
+{
+    m_samples.reserve(m_windowSize);
+}
+
+bool FrameStats::addFrame(const FrameTiming& timing)
+{
+    Sample sample;
+    sample.timing = timing;
+    sample.hitch = timing.frame > m_hitchThreshold;
+
+    if (m_samples.size() < m_windowSize)
+    {
+        m_samples.push_back(sample);
+    }
+    else
+    {
+        m_samples[m_nextSample] = sample;
+    }
+    m_nextSample = (m_nextSample + 1) % m_windowSize;
+
+    m_lastFrame = timing;
+    ++m_totalFrames;
+    if (sample.hitch)
+    {
+        ++m_totalHitches;
+    }
+    return sample.hitch;
+}
+
+FrameStatsSummary FrameStats::computeSummary() const
+{
+    FrameStatsSummary summary;
+    summary.frameCount = static_cast<uint32_t>(m_samples.size());
+
+    std::vector<double> values(m_samples.size());
+    auto summarizeField = [&](double FrameTiming::*field) {
+        for (size_t i = 0; i < m_samples.size(); ++i)
+        {
+            values[i] = m_samples[i].timing.*field;
+        }
+        return summarize(values);
+    };
+
+    summary.processEvents = summarizeField(&FrameTiming::processEvents);
+    summary.update = summarizeField(&FrameTiming::update);
+    summary.render = summarizeField(&FrameTiming::render);
+    summary.frame = summarizeField(&FrameTiming::frame);
+
+    for (const Sample& sample : m_samples)
+    {
+        if (sample.hitch)
+        {
+            ++summary.hitchCount;
+        }
+    }
+    return summary;
+}
+
+void FrameStats::reset()
+{
+    m_samples.clear();
+    m_nextSample = 0;
+    m_lastFrame = {};
+    m_totalFrames = 0;
+    m_totalHitches = 0;
+}
+
+} // namespace graphyne::core
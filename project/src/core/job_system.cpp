@@ -0,0 +1,245 @@
+#include "core/job_system.h"
+#include "utils/logger.h"
+#include "utils/profiler.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace graphyne::core
+{
+
+struct JobSystem::JobSystemImpl
+{
+    struct QueuedJob
+    {
+        Job job;
+        JobCounter* counter = nullptr;
+    };
+
+    std::vector<std::thread> workers;
+    std::deque<QueuedJob> queue;
+    std::deque<QueuedJob> backgroundQueue; // Taken by workers only when queue is empty
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool stopping = false;
+};
+
+namespace
+{
+
+thread_local uint32_t t_threadIndex = 0;
+
+void runJob(const JobSystem::Job& job, JobCounter* counter)
+{
+    job();
+    if (counter)
+    {
+        counter->pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+} // namespace
+
+JobSystem& JobSystem::getInstance()
+{
+    static JobSystem instance;
+    return instance;
+}
+
+JobSystem::~JobSystem()
+{
+    shutdown();
+}
+
+bool JobSystem::initialize(uint32_t workerCount, const ThreadCallback& onWorkerStart)
+{
+    if (m_initialized)
+    {
+        GN_WARNING("Job system already initialized");
+        return true;
+    }
+
+    if (workerCount == 0)
+    {
+        uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = std::max(1u, hardwareThreads > 1 ? hardwareThreads - 1 : 1u);
+    }
+
+    m_impl = std::make_unique<JobSystemImpl>();
+
+    JobSystemImpl* impl = m_impl.get();
+    for (uint32_t i = 0; i < workerCount; ++i)
+    {
+        impl->workers.emplace_back([impl, i, onWorkerStart]() {
+            utils::Profiler::getInstance().setThreadName(fmt::format("Worker {}", i));
+            t_threadIndex = i + 1;
+            if (onWorkerStart)
+            {
+                onWorkerStart(t_threadIndex);
+            }
+            for (;;)
+            {
+                JobSystemImpl::QueuedJob queued;
+                {
+                    std::unique_lock<std::mutex> lock(impl->mutex);
+                    impl->condition.wait(lock, [impl]() {
+                        return impl->stopping || !impl->queue.empty() || !impl->backgroundQueue.empty();
+                    });
+                    std::deque<JobSystemImpl::QueuedJob>& source =
+                        impl->queue.empty() ? impl->backgroundQueue : impl->queue;
+                    if (source.empty())
+                    {
+                        return;
+                    }
+                    queued = std::move(source.front());
+                    source.pop_front();
+                }
+                runJob(queued.job, queued.counter);
+            }
+        });
+    }
+
+    m_initialized = true;
+    GN_INFO("Job system initialized with {} worker threads", workerCount);
+    return true;
+}
+
+void JobSystem::shutdown()
+{
+    if (!m_initialized)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_impl->mutex);
+        m_impl->stopping = true;
+    }
+    m_impl->condition.notify_all();
+
+    for (auto& worker : m_impl->workers)
+    {
+        worker.join();
+    }
+
+    m_impl.reset();
+    m_initialized = false;
+}
+
+void JobSystem::submit(Job job, JobCounter* counter, Priority priority)
+{
+    if (counter)
+    {
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (!m_initialized)
+    {
+        runJob(job, counter);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_impl->mutex);
+        std::deque<JobSystemImpl::QueuedJob>& queue =
+            priority == Priority::Background ? m_impl->backgroundQueue : m_impl->queue;
+        queue.push_back({std::move(job), counter});
+    }
+    m_impl->condition.notify_one();
+}
+
+void JobSystem::wait(const JobCounter& counter)
+{
+    while (!counter.isDone())
+    {
+        // Help with the counter's own queued jobs instead of sleeping, this also keeps nested waits from
+        // deadlocking. Other jobs are left alone, they could take arbitrarily long
+        if (!runPendingJob(counter))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::parallelFor(uint32_t count, uint32_t batchSize, const RangeJob& job)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    if (batchSize == 0)
+    {
+        uint32_t jobCount = std::max(1u, getWorkerCount() * 4);
+        batchSize = std::max(1u, count / jobCount + (count % jobCount != 0 ? 1 : 0));
+    }
+
+    if (!m_initialized || count <= batchSize)
+    {
+        job(0, count);
+        return;
+    }
+
+    JobCounter counter;
+    // Stepping by the remaining count, begin + batchSize could wrap around near UINT32_MAX
+    for (uint32_t begin = batchSize; begin < count;)
+    {
+        uint32_t end = begin + std::min(batchSize, count - begin);
+        submit([&job, begin, end]() { job(begin, end); }, &counter);
+        begin = end;
+    }
+
+    // The calling thread takes the first batch itself
+    job(0, batchSize);
+    wait(counter);
+}
+
+uint32_t JobSystem::getWorkerCount() const
+{
+    if (!m_initialized)
+    {
+        return 0;
+    }
+    return static_cast<uint32_t>(m_impl->workers.size());
+}
+
+uint32_t JobSystem::getCurrentThreadIndex()
+{
+    return t_threadIndex;
+}
+
+bool JobSystem::runPendingJob(const JobCounter& counter)
+{
+    if (!m_initialized)
+    {
+        return false;
+    }
+
+    JobSystemImpl::QueuedJob queued;
+    {
+        std::lock_guard<std::mutex> lock(m_impl->mutex);
+        auto takeJob = [&counter, &queued](std::deque<JobSystemImpl::QueuedJob>& queue) {
+            auto it = std::find_if(queue.begin(), queue.end(), [&counter](const JobSystemImpl::QueuedJob& job) {
+                return job.counter == &counter;
+            });
+            if (it == queue.end())
+            {
+                return false;
+            }
+            queued = std::move(*it);
+            queue.erase(it);
+            return true;
+        };
+        if (!takeJob(m_impl->queue) && !takeJob(m_impl->backgroundQueue))
+        {
+            return false;
+        }
+    }
+    runJob(queued.job, queued.counter);
+    return true;
+}
+
+} // namespace graphyne::core
@@ -114,15 +114,31 @@ void MemoryManager::free(void* ptr, AllocationType type)
     // The pools are cleared when the memory manager is shut down
 }
 
+void MemoryManager::trackExternalAllocation(size_t size, AllocationType type)
+{
+    m_externalSizes[static_cast<size_t>(type)].fetch_add(size, std::memory_order_relaxed);
+}
+
+void MemoryManager::trackExternalFree(size_t size, AllocationType type)
+{
+    m_externalSizes[static_cast<size_t>(type)].fetch_sub(size, std::memory_order_relaxed);
+}
+
 size_t MemoryManager::getAllocatedSize(AllocationType type) const
 {
+    size_t externalSize = getExternalSize(type);
     if (!m_initialized)
     {
-        return 0;
+        return externalSize;
     }
 
     const MemoryManagerImpl::MemoryPool& pool = (type == AllocationType::Temp) ? m_impl->tempPool : m_impl->generalPool;
-    return pool.used;
+    return pool.used + externalSize;
+}
+
+size_t MemoryManager::getExternalSize(AllocationType type) const
+{
+    return m_externalSizes[static_cast<size_t>(type)].load(std::memory_order_relaxed);
 }
 
 void MemoryManager::printStatistics() const
@@ -141,6 +157,13 @@ void MemoryManager::printStatistics() const
     GN_INFO("  Used: {} bytes", m_impl->tempPool.used);
     GN_INFO("  Peak: {} bytes", m_impl->tempPool.peak);
     GN_INFO("  Total: {} bytes", m_impl->tempPool.size);
+
+    size_t graphicsSize = getExternalSize(AllocationType::Graphics);
+    if (graphicsSize > 0)
+    {
+        GN_INFO("Graphics Device Memory:");
+        GN_INFO("  Used: {} bytes", graphicsSize);
+    }
 }
 
 } // namespace graphyne::core
@@ -0,0 +1,584 @@
+#include "graphics/null_renderer.h"
+#include "core/job_system.h"
+#include "utils/logger.h"
+#include <algorithm>
+
+namespace graphyne::graphics
+{
+
+namespace
+{
+
+// Misuse tends to repeat every frame, only the first errors are logged
+constexpr uint64_t MAX_LOGGED_VALIDATION_ERRORS = 32;
+
+void accumulate(NullRenderer::Counters& total, const NullRenderer::Counters& frame)
+{
+    total.frames += frame.frames;
+    total.drawCalls += frame.drawCalls;
+    total.vertices += frame.vertices;
+    total.instances += frame.instances;
+    total.triangles += frame.triangles;
+    total.indirectDrawCalls += frame.indirectDrawCalls;
+    total.cullPasses += frame.cullPasses;
+    total.cullObjects += frame.cullObjects;
+    total.bytesUploaded += frame.bytesUploaded;
+    total.pipelineBinds += frame.pipelineBinds;
+    total.vertexBufferBinds += frame.vertexBufferBinds;
+    total.indexBufferBinds += frame.indexBufferBinds;
+    total.pushConstantUpdates += frame.pushConstantUpdates;
+    total.redundantBinds += frame.redundantBinds;
+    total.resourcesCreated += frame.resourcesCreated;
+    total.resourcesDestroyed += frame.resourcesDestroyed;
+    total.validationErrors += frame.validationErrors;
+}
+
+// Forwards the calls of a parallel recording batch to the renderer
+class ForwardingRecorder : public CommandRecorder
+{
+public:
+    explicit ForwardingRecorder(NullRenderer& renderer) : m_renderer(renderer) {}
+
+    void bindPipeline(PipelineHandle pipeline) override { m_renderer.bindPipeline(pipeline); }
+    void bindVertexBuffer(BufferHandle buffer, size_t offset) override { m_renderer.bindVertexBuffer(buffer, offset); }
+    void bindIndexBuffer(BufferHandle buffer, IndexType type, size_t offset) override
+    {
+        m_renderer.bindIndexBuffer(buffer, type, offset);
+    }
+    void pushConstants(const void* data, uint32_t size, uint32_t offset) override
+    {
+        m_renderer.pushConstants(data, size, offset);
+    }
+    void draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) override
+    {
+        m_renderer.draw(vertexCount, instanceCount, firstVertex, firstInstance);
+    }
+    void drawIndexed(uint32_t indexCount,
+                     uint32_t instanceCount,
+                     uint32_t firstIndex,
+                     int32_t vertexOffset,
+                     uint32_t firstInstance) override
+    {
+        m_renderer.drawIndexed(indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+    }
+    void drawIndexedIndirectCount(BufferHandle commands,
+                                  size_t offset,
+                                  BufferHandle count,
+                                  size_t countOffset,
+                                  uint32_t maxDrawCount) override
+    {
+        m_renderer.drawIndexedIndirectCount(commands, offset, count, countOffset, maxDrawCount);
+    }
+
+private:
+    NullRenderer& m_renderer;
+};
+
+} // namespace
+
+NullRenderer::NullRenderer(platform::Window* window, const Config& config) : Renderer(window, config) {}
+
+NullRenderer::~NullRenderer()
+{
+    shutdown();
+}
+
+bool NullRenderer::initialize()
+{
+    m_initialized = true;
+    m_inFrame = false;
+    resetCounters();
+    GN_INFO("Null renderer initialized");
+    return true;
+}
+
+void NullRenderer::shutdown()
+{
+    if (!m_initialized)
+    {
+        return;
+    }
+
+    size_t leaked = m_buffers.size() + m_textures.size() + m_pipelines.size();
+    if (leaked > 0)
+    {
+        GN_WARNING("Null renderer shut down with {} live resources", leaked);
+    }
+
+    GN_INFO("Null renderer shut down after {} frames, {} draw calls, {} validation errors",
+            m_totalCounters.frames,
+            m_totalCounters.drawCalls,
+            m_totalCounters.validationErrors + m_frameCounters.validationErrors);
+
+    m_buffers.clear();
+    m_textures.clear();
+    m_pipelines.clear();
+    m_bindlessTextures = {};
+    m_bindlessBuffers = {};
+    m_initialized = false;
+}
+
+void NullRenderer::beginFrame()
+{
+    validate(!m_inFrame, "beginFrame called twice without endFrame");
+    m_inFrame = true;
+
+    // Bindings do not carry over between frames
+    resetBindings();
+}
+
+void NullRenderer::endFrame()
+{
+    validate(m_inFrame, "endFrame called without beginFrame");
+    m_inFrame = false;
+
+    m_frameCounters.frames = 1;
+    m_lastFrameCounters = m_frameCounters;
+
+    // Binds and barriers have no counterpart without a GPU, GPU culling is one dispatch per pass
+    m_stats = {};
+    m_stats.frameIndex = m_totalCounters.frames;
+    m_stats.drawCalls = m_frameCounters.drawCalls;
+    m_stats.indirectDrawCalls = m_frameCounters.indirectDrawCalls;
+    m_stats.dispatches = m_frameCounters.cullPasses;
+    m_stats.triangles = m_frameCounters.triangles;
+    m_stats.pipelineBinds = m_frameCounters.pipelineBinds;
+    m_stats.bytesUploaded = m_frameCounters.bytesUploaded;
+
+    accumulate(m_totalCounters, m_frameCounters);
+    m_frameCounters = {};
+}
+
+void NullRenderer::waitIdle() {}
+
+void NullRenderer::onResize(int width, int height)
+{
+    validate(width >= 0 && height >= 0, "onResize called with a negative size");
+}
+
+BufferHandle NullRenderer::createBuffer(const BufferDesc& desc, const void* initialData)
+{
+    if (!validate(desc.size > 0, "createBuffer called with a size of 0"))
+    {
+        return {};
+    }
+
+    BufferHandle handle{m_nextHandleId++};
+    BufferInfo& info = m_buffers[handle.id];
+    info.size = desc.size;
+    info.usage = desc.usage;
+    if (isBindless() && hasUsage(desc.usage, BufferUsage::Storage))
+    {
+        info.bindlessIndex = m_bindlessBuffers.allocate();
+    }
+    ++m_frameCounters.resourcesCreated;
+
+    if (initialData)
+    {
+        m_frameCounters.bytesUploaded += desc.size;
+    }
+    return handle;
+}
+
+void NullRenderer::updateBuffer(BufferHandle buffer, const void* data, size_t size, size_t offset)
+{
+    auto it = m_buffers.find(buffer.id);
+    if (!validate(it != m_buffers.end(), "updateBuffer called with an invalid buffer") ||
+        !validate(data != nullptr, "updateBuffer called without data") ||
+        !validate(offset + size <= it->second.size, "updateBuffer writes past the end of the buffer"))
+    {
+        return;
+    }
+
+    m_frameCounters.bytesUploaded += size;
+}
+
+void NullRenderer::destroyBuffer(BufferHandle buffer)
+{
+    auto it = m_buffers.find(buffer.id);
+    if (!validate(it != m_buffers.end(), "destroyBuffer called with an invalid buffer"))
+    {
+        return;
+    }
+
+    m_bindlessBuffers.release(it->second.bindlessIndex);
+    m_buffers.erase(it);
+
+    if (m_boundVertexBuffer == buffer)
+    {
+        m_boundVertexBuffer = {};
+    }
+    if (m_boundIndexBuffer == buffer)
+    {
+        m_boundIndexBuffer = {};
+    }
+    ++m_frameCounters.resourcesDestroyed;
+}
+
+TextureHandle NullRenderer::createTexture(const TextureDesc& desc)
+{
+    if (!validate(desc.width > 0 && desc.height > 0, "createTexture called with a size of 0") ||
+        !validate(desc.mipLevels > 0 && desc.mipLevels <= getFullMipCount(desc.width, desc.height),
+                  "createTexture called with an invalid mip count"))
+    {
+        return {};
+    }
+
+    TextureHandle handle{m_nextHandleId++};
+    TextureInfo& info = m_textures[handle.id];
+    info.desc = desc;
+    if (isBindless())
+    {
+        info.bindlessIndex = m_bindlessTextures.allocate();
+    }
+    ++m_frameCounters.resourcesCreated;
+    return handle;
+}
+
+void NullRenderer::updateTexture(TextureHandle texture, uint32_t mipLevel, const void* data, size_t size)
+{
+    auto it = m_textures.find(texture.id);
+    if (!validate(it != m_textures.end(), "updateTexture called with an invalid texture") ||
+        !validate(data != nullptr, "updateTexture called without data") ||
+        !validate(mipLevel < it->second.desc.mipLevels, "updateTexture called with an out of range mip level"))
+    {
+        return;
+    }
+
+    const TextureDesc& desc = it->second.desc;
+    size_t expectedSize =
+        getMipSize(desc.format, std::max(1u, desc.width >> mipLevel), std::max(1u, desc.height >> mipLevel));
+    if (!validate(size == expectedSize, "updateTexture data size does not match the mip level size"))
+    {
+        return;
+    }
+
+    m_frameCounters.bytesUploaded += size;
+}
+
+void NullRenderer::destroyTexture(TextureHandle texture)
+{
+    auto it = m_textures.find(texture.id);
+    if (!validate(it != m_textures.end(), "destroyTexture called with an invalid texture"))
+    {
+        return;
+    }
+
+    m_bindlessTextures.release(it->second.bindlessIndex);
+    m_textures.erase(it);
+    ++m_frameCounters.resourcesDestroyed;
+}
+
+uint32_t NullRenderer::getBindlessIndex(TextureHandle texture) const
+{
+    auto it = m_textures.find(texture.id);
+    return it != m_textures.end() ? it->second.bindlessIndex : INVALID_BINDLESS_INDEX;
+}
+
+uint32_t NullRenderer::getBindlessIndex(BufferHandle buffer) const
+{
+    auto it = m_buffers.find(buffer.id);
+    return it != m_buffers.end() ? it->second.bindlessIndex : INVALID_BINDLESS_INDEX;
+}
+
+PipelineHandle NullRenderer::createPipeline(const PipelineDesc& desc)
+{
+    if (!validate(!desc.vertexShader.empty() && !desc.fragmentShader.empty(),
+                  "createPipeline called without shader code") ||
+        !validate(desc.vertexAttributes.empty() || desc.vertexStride > 0,
+                  "createPipeline has vertex attributes but no vertex stride") ||
+        !validate(!desc.fallback.isValid() || m_pipelines.count(desc.fallback.id) == 1,
+                  "createPipeline called with an invalid fallback pipeline") ||
+        !validate(!isBindless() || desc.pushConstantSize <= MAX_BINDLESS_PUSH_CONSTANT_SIZE,
+                  "createPipeline push constants exceed the bindless pipeline layout"))
+    {
+        return {};
+    }
+
+    PipelineHandle handle{m_nextHandleId++};
+    m_pipelines[handle.id] = {desc.vertexStride, desc.pushConstantSize, desc.topology};
+    ++m_frameCounters.resourcesCreated;
+    return handle;
+}
+
+void NullRenderer::destroyPipeline(PipelineHandle pipeline)
+{
+    if (!validate(m_pipelines.erase(pipeline.id) == 1, "destroyPipeline called with an invalid pipeline"))
+    {
+        return;
+    }
+
+    if (m_boundPipeline == pipeline)
+    {
+        m_boundPipeline = {};
+    }
+    ++m_frameCounters.resourcesDestroyed;
+}
+
+bool NullRenderer::isPipelineReady(PipelineHandle pipeline) const
+{
+    // Nothing is compiled, pipelines are usable as soon as they are created
+    return m_pipelines.count(pipeline.id) == 1;
+}
+
+void NullRenderer::bindPipeline(PipelineHandle pipeline)
+{
+    if (!validateInFrame("bindPipeline") ||
+        !validate(m_pipelines.count(pipeline.id) == 1, "bindPipeline called with an invalid pipeline"))
+    {
+        return;
+    }
+
+    ++m_frameCounters.pipelineBinds;
+    if (m_boundPipeline == pipeline)
+    {
+        ++m_frameCounters.redundantBinds;
+    }
+    m_boundPipeline = pipeline;
+}
+
+void NullRenderer::bindVertexBuffer(BufferHandle buffer, size_t offset)
+{
+    auto it = m_buffers.find(buffer.id);
+    if (!validateInFrame("bindVertexBuffer") ||
+        !validate(it != m_buffers.end(), "bindVertexBuffer called with an invalid buffer") ||
+        !validate(offset < it->second.size, "bindVertexBuffer offset is past the end of the buffer"))
+    {
+        return;
+    }
+
+    ++m_frameCounters.vertexBufferBinds;
+    if (m_boundVertexBuffer == buffer && m_boundVertexOffset == offset)
+    {
+        ++m_frameCounters.redundantBinds;
+    }
+    m_boundVertexBuffer = buffer;
+    m_boundVertexOffset = offset;
+}
+
+void NullRenderer::bindIndexBuffer(BufferHandle buffer, IndexType type, size_t offset)
+{
+    auto it = m_buffers.find(buffer.id);
+    size_t indexSize = type == IndexType::Uint16 ? 2 : 4;
+    if (!validateInFrame("bindIndexBuffer") ||
+        !validate(it != m_buffers.end(), "bindIndexBuffer called with an invalid buffer") ||
+        !validate(offset < it->second.size, "bindIndexBuffer offset is past the end of the buffer") ||
+        !validate(offset % indexSize == 0, "bindIndexBuffer offset is not a multiple of the index size"))
+    {
+        return;
+    }
+
+    ++m_frameCounters.indexBufferBinds;
+    if (m_boundIndexBuffer == buffer && m_boundIndexOffset == offset)
+    {
+        ++m_frameCounters.redundantBinds;
+    }
+    m_boundIndexBuffer = buffer;
+    m_boundIndexOffset = offset;
+}
+
+void NullRenderer::pushConstants(const void* data, uint32_t size, uint32_t offset)
+{
+    if (!validateInFrame("pushConstants") ||
+        !validate(m_boundPipeline.isValid(), "pushConstants called without a bound pipeline") ||
+        !validate(data != nullptr, "pushConstants called without data") ||
+        !validate(offset + size <= m_pipelines[m_boundPipeline.id].pushConstantSize,
+                  "pushConstants exceeds the push constant size of the pipeline"))
+    {
+        return;
+    }
+
+    ++m_frameCounters.pushConstantUpdates;
+}
+
+void NullRenderer::draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
+{
+    if (!validateInFrame("draw") || !validate(m_boundPipeline.isValid(), "draw called without a bound pipeline") ||
+        !validate(m_pipelines[m_boundPipeline.id].vertexStride == 0 || m_boundVertexBuffer.isValid(),
+                  "draw called without a bound vertex buffer"))
+    {
+        return;
+    }
+
+    ++m_frameCounters.drawCalls;
+    m_frameCounters.vertices += static_cast<uint64_t>(vertexCount) * instanceCount;
+    m_frameCounters.instances += instanceCount;
+    m_frameCounters.triangles +=
+        getTriangleCount(m_pipelines[m_boundPipeline.id].topology, vertexCount) * instanceCount;
+}
+
+void NullRenderer::drawIndexed(uint32_t indexCount,
+                               uint32_t instanceCount,
+                               uint32_t firstIndex,
+                               int32_t vertexOffset,
+                               uint32_t firstInstance)
+{
+    if (!validateInFrame("drawIndexed") ||
+        !validate(m_boundPipeline.isValid(), "drawIndexed called without a bound pipeline") ||
+        !validate(m_boundIndexBuffer.isValid(), "drawIndexed called without a bound index buffer") ||
+        !validate(m_pipelines[m_boundPipeline.id].vertexStride == 0 || m_boundVertexBuffer.isValid(),
+                  "drawIndexed called without a bound vertex buffer"))
+    {
+        return;
+    }
+
+    ++m_frameCounters.drawCalls;
+    m_frameCounters.vertices += static_cast<uint64_t>(indexCount) * instanceCount;
+    m_frameCounters.instances += instanceCount;
+    m_frameCounters.triangles +=
+        getTriangleCount(m_pipelines[m_boundPipeline.id].topology, indexCount) * instanceCount;
+}
+
+void NullRenderer::drawIndexedIndirectCount(BufferHandle commands,
+                                            size_t offset,
+                                            BufferHandle count,
+                                            size_t countOffset,
+                                            uint32_t maxDrawCount)
+{
+    if (!validateInFrame("drawIndexedIndirectCount") ||
+        !validate(m_boundPipeline.isValid(), "drawIndexedIndirectCount called without a bound pipeline") ||
+        !validate(m_boundIndexBuffer.isValid(), "drawIndexedIndirectCount called without a bound index buffer") ||
+        !validate(m_pipelines[m_boundPipeline.id].vertexStride == 0 || m_boundVertexBuffer.isValid(),
+                  "drawIndexedIndirectCount called without a bound vertex buffer") ||
+        !validate(offset % 4 == 0 && countOffset % 4 == 0, "drawIndexedIndirectCount offsets are not 4 byte aligned") ||
+        !validateBufferRange(commands,
+                             BufferUsage::Indirect,
+                             offset,
+                             static_cast<size_t>(maxDrawCount) * sizeof(DrawIndexedIndirectCommand),
+                             "drawIndexedIndirectCount commands exceed the command buffer") ||
+        !validateBufferRange(
+            count, BufferUsage::Indirect, countOffset, sizeof(uint32_t), "drawIndexedIndirectCount count is invalid"))
+    {
+        return;
+    }
+
+    ++m_frameCounters.indirectDrawCalls;
+}
+
+void NullRenderer::cullDraws(const GpuCullDesc& desc)
+{
+    size_t commandCount = static_cast<size_t>(desc.groupCount) * desc.maxDrawsPerGroup;
+    if (!validateInFrame("cullDraws") ||
+        !validateBufferRange(desc.objects,
+                             BufferUsage::Storage,
+                             0,
+                             desc.objectCount * sizeof(GpuCullObject),
+                             "cullDraws objects exceed the object buffer") ||
+        !validateBufferRange(desc.drawCommands,
+                             BufferUsage::Storage,
+                             0,
+                             commandCount * sizeof(DrawIndexedIndirectCommand),
+                             "cullDraws commands exceed the command buffer") ||
+        !validateBufferRange(desc.drawCounts,
+                             BufferUsage::Storage,
+                             0,
+                             desc.groupCount * sizeof(uint32_t),
+                             "cullDraws counts exceed the count buffer"))
+    {
+        return;
+    }
+
+    ++m_frameCounters.cullPasses;
+    m_frameCounters.cullObjects += desc.objectCount;
+}
+
+void NullRenderer::recordParallel(uint32_t count, uint32_t batchSize, const RecordJob& job)
+{
+    if (!validateInFrame("recordParallel") || !validate(static_cast<bool>(job), "recordParallel called without a job"))
+    {
+        return;
+    }
+
+    if (batchSize == 0)
+    {
+        uint32_t batchCount = std::max(1u, (core::JobSystem::getInstance().getWorkerCount() + 1) * 2);
+        batchSize = std::max(1u, (count + batchCount - 1) / batchCount);
+    }
+
+    // Every batch, and the draws after the recording, start with nothing bound like on the GPU backends
+    ForwardingRecorder recorder(*this);
+    for (uint32_t begin = 0; begin < count; begin += batchSize)
+    {
+        resetBindings();
+        job(recorder, begin, std::min(count, begin + batchSize));
+    }
+    resetBindings();
+}
+
+void NullRenderer::resetCounters()
+{
+    m_frameCounters = {};
+    m_lastFrameCounters = {};
+    m_totalCounters = {};
+    m_stats = {};
+}
+
+uint32_t NullRenderer::BindlessIndices::allocate()
+{
+    if (freeIndices.empty())
+    {
+        return nextIndex++;
+    }
+
+    uint32_t index = freeIndices.back();
+    freeIndices.pop_back();
+    return index;
+}
+
+void NullRenderer::BindlessIndices::release(uint32_t index)
+{
+    if (index != INVALID_BINDLESS_INDEX)
+    {
+        freeIndices.push_back(index);
+    }
+}
+
+bool NullRenderer::validate(bool condition, const char* message)
+{
+    if (condition)
+    {
+        return true;
+    }
+
+    uint64_t errorCount = m_totalCounters.validationErrors + m_frameCounters.validationErrors;
+    if (errorCount < MAX_LOGGED_VALIDATION_ERRORS)
+    {
+        GN_ERROR("Null renderer: {}", message);
+    }
+    else if (errorCount == MAX_LOGGED_VALIDATION_ERRORS)
+    {
+        GN_ERROR("Null renderer: too many validation errors, further errors are not logged");
+    }
+
+    ++m_frameCounters.validationErrors;
+    return false;
+}
+
+bool NullRenderer::validateInFrame(const char* call)
+{
+    if (m_inFrame)
+    {
+        return true;
+    }
+    return validate(false, fmt::format("{} called outside of beginFrame/endFrame", call).c_str());
+}
+
+bool NullRenderer::validateBufferRange(BufferHandle buffer,
+                                       BufferUsage usage,
+                                       size_t offset,
+                                       size_t size,
+                                       const char* message)
+{
+    auto it = m_buffers.find(buffer.id);
+    return validate(
+        it != m_buffers.end() && hasUsage(it->second.usage, usage) && offset + size <= it->second.size, message);
+}
+
+void NullRenderer::resetBindings()
+{
+    m_boundPipeline = {};
+    m_boundVertexBuffer = {};
+    m_boundIndexBuffer = {};
+}
+
+} // namespace graphyne::graphics
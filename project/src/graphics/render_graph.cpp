@@ -0,0 +1,1064 @@
+#include "graphics/render_graph.h"
+#include "graphics/vulkan_gpu_profiler.h"
+#include "utils/logger.h"
+#include "utils/profiler.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <queue>
+
+namespace graphyne::graphics
+{
+
+namespace
+{
+
+constexpr VkAccessFlags WRITE_ACCESS = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                       VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+                                       VK_ACCESS_TRANSFER_WRITE_BIT;
+
+constexpr VkPipelineStageFlags SHADER_STAGES =
+    VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+constexpr VkPipelineStageFlags DEPTH_STAGES =
+    VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+
+struct UsageInfo
+{
+    VkImageLayout layout;
+    VkPipelineStageFlags stages;
+    VkAccessFlags access;
+    VkImageUsageFlags imageUsage;
+};
+
+UsageInfo getUsageInfo(ResourceUsage usage)
+{
+    switch (usage)
+    {
+        case ResourceUsage::None:
+            return {VK_IMAGE_LAYOUT_UNDEFINED, 0, 0, 0};
+        case ResourceUsage::ColorAttachment:
+            return {VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                    VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                    VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                    VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT};
+        case ResourceUsage::DepthAttachment:
+            return {VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                    DEPTH_STAGES,
+                    VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                    VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT};
+        case ResourceUsage::DepthRead:
+            return {VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+                    DEPTH_STAGES,
+                    VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+                    VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT};
+        case ResourceUsage::ShaderRead:
+            return {VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                    SHADER_STAGES,
+                    VK_ACCESS_SHADER_READ_BIT,
+                    VK_IMAGE_USAGE_SAMPLED_BIT};
+        case ResourceUsage::StorageRead:
+            return {VK_IMAGE_LAYOUT_GENERAL, SHADER_STAGES, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_USAGE_STORAGE_BIT};
+        case ResourceUsage::StorageWrite:
+            return {VK_IMAGE_LAYOUT_GENERAL,
+                    SHADER_STAGES,
+                    VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                    VK_IMAGE_USAGE_STORAGE_BIT};
+        case ResourceUsage::TransferSrc:
+            return {VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    VK_PIPELINE_STAGE_TRANSFER_BIT,
+                    VK_ACCESS_TRANSFER_READ_BIT,
+                    VK_IMAGE_USAGE_TRANSFER_SRC_BIT};
+        case ResourceUsage::TransferDst:
+            return {VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    VK_PIPELINE_STAGE_TRANSFER_BIT,
+                    VK_ACCESS_TRANSFER_WRITE_BIT,
+                    VK_IMAGE_USAGE_TRANSFER_DST_BIT};
+        case ResourceUsage::Present:
+            return {VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0};
+    }
+    return {VK_IMAGE_LAYOUT_UNDEFINED, 0, 0, 0};
+}
+
+bool isWriteUsage(ResourceUsage usage)
+{
+    return usage == ResourceUsage::ColorAttachment || usage == ResourceUsage::DepthAttachment ||
+           usage == ResourceUsage::StorageWrite || usage == ResourceUsage::TransferDst;
+}
+
+bool isReadUsage(ResourceUsage usage)
+{
+    return usage == ResourceUsage::DepthRead || usage == ResourceUsage::ShaderRead ||
+           usage == ResourceUsage::StorageRead || usage == ResourceUsage::TransferSrc;
+}
+
+bool isAttachmentUsage(ResourceUsage usage)
+{
+    return usage == ResourceUsage::ColorAttachment || usage == ResourceUsage::DepthAttachment ||
+           usage == ResourceUsage::DepthRead;
+}
+
+VkImageAspectFlags getAspectMask(VkFormat format)
+{
+    switch (format)
+    {
+        case VK_FORMAT_D16_UNORM:
+        case VK_FORMAT_X8_D24_UNORM_PACK32:
+        case VK_FORMAT_D32_SFLOAT:
+            return VK_IMAGE_ASPECT_DEPTH_BIT;
+        case VK_FORMAT_D16_UNORM_S8_UINT:
+        case VK_FORMAT_D24_UNORM_S8_UINT:
+        case VK_FORMAT_D32_SFLOAT_S8_UINT:
+            return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+        case VK_FORMAT_S8_UINT:
+            return VK_IMAGE_ASPECT_STENCIL_BIT;
+        default:
+            return VK_IMAGE_ASPECT_COLOR_BIT;
+    }
+}
+
+template <typename T>
+uint64_t toKey(T handle)
+{
+    // Non-dispatchable handles are pointers on 64-bit platforms and integers on 32-bit ones
+    uint64_t key = 0;
+    std::memcpy(&key, &handle, sizeof(handle));
+    return key;
+}
+
+} // namespace
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::read(RenderGraphResource resource, ResourceUsage usage)
+{
+    m_graph.addAccess(m_pass, resource, usage, false);
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::write(RenderGraphResource resource, ResourceUsage usage)
+{
+    m_graph.addAccess(m_pass, resource, usage, true);
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::clear(RenderGraphResource resource, const VkClearValue& value)
+{
+    m_graph.m_passes[m_pass].clears.emplace_back(resource.index, value);
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::setSideEffects()
+{
+    m_graph.m_passes[m_pass].sideEffects = true;
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::setSecondaryContents()
+{
+    m_graph.m_passes[m_pass].secondaryContents = true;
+    return *this;
+}
+
+RenderGraph::~RenderGraph()
+{
+    shutdown();
+}
+
+void RenderGraph::initialize(VkDevice device,
+                             VulkanAllocator& allocator,
+                             const VulkanSync& sync,
+                             VulkanDeletionQueue& deletionQueue)
+{
+    m_device = device;
+    m_allocator = &allocator;
+    m_sync = &sync;
+    m_deletionQueue = &deletionQueue;
+}
+
+void RenderGraph::shutdown()
+{
+    if (m_device == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    reset();
+    destroyTransientImages();
+    for (auto& [key, renderPass] : m_renderPasses)
+    {
+        vkDestroyRenderPass(m_device, renderPass, nullptr);
+    }
+    m_renderPasses.clear();
+
+    m_device = VK_NULL_HANDLE;
+    m_allocator = nullptr;
+    m_sync = nullptr;
+    m_deletionQueue = nullptr;
+}
+
+void RenderGraph::reset()
+{
+    m_resources.clear();
+    m_passes.clear();
+    m_order.clear();
+    m_barriers.clear();
+    m_valid = true;
+    m_compiled = false;
+}
+
+RenderGraphResource RenderGraph::createImage(std::string name, const TransientImageDesc& desc)
+{
+    if (desc.width == 0 || desc.height == 0 || desc.format == VK_FORMAT_UNDEFINED)
+    {
+        GN_ERROR("Render graph image {} needs a size and a format", name);
+        m_valid = false;
+    }
+
+    Resource& resource = m_resources.emplace_back();
+    resource.name = std::move(name);
+    resource.image.format = desc.format;
+    resource.image.extent = {desc.width, desc.height};
+    resource.image.preserveContents = false;
+    return {static_cast<uint32_t>(m_resources.size() - 1)};
+}
+
+RenderGraphResource RenderGraph::importImage(std::string name, const ImportedImage& image)
+{
+    if (isWriteUsage(image.finalUsage))
+    {
+        GN_ERROR("Render graph image {} can't be written after the last pass", name);
+        m_valid = false;
+    }
+
+    Resource& resource = m_resources.emplace_back();
+    resource.name = std::move(name);
+    resource.imported = true;
+    resource.image = image;
+    return {static_cast<uint32_t>(m_resources.size() - 1)};
+}
+
+RenderGraph::PassBuilder RenderGraph::addPass(std::string name, ExecuteFn execute)
+{
+    Pass& pass = m_passes.emplace_back();
+    pass.name = std::move(name);
+    pass.execute = std::move(execute);
+    return PassBuilder(*this, static_cast<uint32_t>(m_passes.size() - 1));
+}
+
+void RenderGraph::addAccess(uint32_t pass, RenderGraphResource resource, ResourceUsage usage, bool write)
+{
+    if (resource.index >= m_resources.size())
+    {
+        GN_ERROR("Render graph pass {} accesses an invalid image", m_passes[pass].name);
+        m_valid = false;
+        return;
+    }
+
+    if (write ? !isWriteUsage(usage) : !isReadUsage(usage))
+    {
+        GN_ERROR("Render graph pass {} {} image {} with an invalid usage",
+                 m_passes[pass].name,
+                 write ? "writes" : "reads",
+                 m_resources[resource.index].name);
+        m_valid = false;
+        return;
+    }
+
+    m_passes[pass].accesses.push_back({resource.index, usage, write});
+}
+
+bool RenderGraph::compile()
+{
+    GN_PROFILE_SCOPE("RenderGraph::compile");
+
+    m_compiled = false;
+    if (!m_valid || !validate() || !sortPasses())
+    {
+        return false;
+    }
+
+    cullPasses();
+    if (!realizeTransientImages() || !compilePasses())
+    {
+        return false;
+    }
+
+    m_stats.passCount = static_cast<uint32_t>(m_order.size());
+    m_stats.culledPassCount = static_cast<uint32_t>(m_passes.size() - m_order.size());
+    m_stats.barrierCount = static_cast<uint32_t>(m_barriers.size());
+    m_compiled = true;
+    return true;
+}
+
+void RenderGraph::execute(VkCommandBuffer commandBuffer)
+{
+    GN_PROFILE_SCOPE("RenderGraph::execute");
+
+    if (!m_compiled)
+    {
+        GN_ERROR("Render graph must be compiled before it is executed");
+        return;
+    }
+
+    for (uint32_t passIndex : m_order)
+    {
+        Pass& pass = m_passes[passIndex];
+        GN_GPU_SCOPE(commandBuffer, pass.name);
+        if (pass.barrierCount > 0)
+        {
+            m_sync->imageBarriers(commandBuffer, pass.barrierCount, &m_barriers[pass.firstBarrier]);
+        }
+
+        if (pass.renderPass != VK_NULL_HANDLE)
+        {
+            VkRenderPassBeginInfo beginInfo{};
+            beginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+            beginInfo.renderPass = pass.renderPass;
+            beginInfo.framebuffer = pass.framebuffer;
+            beginInfo.renderArea.extent = pass.extent;
+            beginInfo.clearValueCount = static_cast<uint32_t>(pass.clearValues.size());
+            beginInfo.pClearValues = pass.clearValues.data();
+            vkCmdBeginRenderPass(commandBuffer,
+                                 &beginInfo,
+                                 pass.secondaryContents ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS
+                                                        : VK_SUBPASS_CONTENTS_INLINE);
+        }
+
+        if (pass.execute)
+        {
+            pass.execute(commandBuffer, *this);
+        }
+
+        if (pass.renderPass != VK_NULL_HANDLE)
+        {
+            vkCmdEndRenderPass(commandBuffer);
+        }
+    }
+
+    uint32_t finalBarrierCount = static_cast<uint32_t>(m_barriers.size()) - m_finalBarrier;
+    if (finalBarrierCount > 0)
+    {
+        m_sync->imageBarriers(commandBuffer, finalBarrierCount, &m_barriers[m_finalBarrier]);
+    }
+}
+
+VkImage RenderGraph::getImage(RenderGraphResource resource) const
+{
+    return resource.index < m_resources.size() ? m_resources[resource.index].image.image : VK_NULL_HANDLE;
+}
+
+VkImageView RenderGraph::getImageView(RenderGraphResource resource) const
+{
+    return resource.index < m_resources.size() ? m_resources[resource.index].image.view : VK_NULL_HANDLE;
+}
+
+VkExtent2D RenderGraph::getExtent(RenderGraphResource resource) const
+{
+    return resource.index < m_resources.size() ? m_resources[resource.index].image.extent : VkExtent2D{0, 0};
+}
+
+void RenderGraph::releaseFramebuffers()
+{
+    for (auto& [key, framebuffer] : m_framebuffers)
+    {
+        vkDestroyFramebuffer(m_device, framebuffer, nullptr);
+    }
+    m_framebuffers.clear();
+}
+
+std::vector<VkFramebuffer> RenderGraph::detachFramebuffers()
+{
+    std::vector<VkFramebuffer> framebuffers;
+    framebuffers.reserve(m_framebuffers.size());
+    for (auto& [key, framebuffer] : m_framebuffers)
+    {
+        framebuffers.push_back(framebuffer);
+    }
+    m_framebuffers.clear();
+    return framebuffers;
+}
+
+bool RenderGraph::validate() const
+{
+    std::vector<bool> written(m_resources.size(), false);
+    for (const Pass& pass : m_passes)
+    {
+        for (size_t i = 0; i < pass.accesses.size(); ++i)
+        {
+            const Access& access = pass.accesses[i];
+            written[access.resource] = written[access.resource] || access.write;
+
+            // Two accesses would need the image in two layouts at once
+            for (size_t j = 0; j < i; ++j)
+            {
+                if (pass.accesses[j].resource == access.resource)
+                {
+                    GN_ERROR("Render graph pass {} accesses image {} more than once",
+                             pass.name,
+                             m_resources[access.resource].name);
+                    return false;
+                }
+            }
+        }
+
+        for (const auto& [resource, value] : pass.clears)
+        {
+            auto isClearedAttachment = [resource = resource](const Access& access) {
+                return access.resource == resource && access.write && isAttachmentUsage(access.usage);
+            };
+            if (std::none_of(pass.accesses.begin(), pass.accesses.end(), isClearedAttachment))
+            {
+                GN_ERROR("Render graph pass {} clears an image it doesn't write as an attachment", pass.name);
+                return false;
+            }
+        }
+    }
+
+    for (const Pass& pass : m_passes)
+    {
+        for (const Access& access : pass.accesses)
+        {
+            const Resource& resource = m_resources[access.resource];
+            if (!access.write && !resource.imported && !written[access.resource])
+            {
+                GN_ERROR("Render graph pass {} reads image {}, which no pass writes", pass.name, resource.name);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool RenderGraph::sortPasses()
+{
+    size_t passCount = m_passes.size();
+    std::vector<std::vector<uint32_t>> successors(passCount);
+    std::vector<uint32_t> predecessorCount(passCount, 0);
+    auto addEdge = [&](uint32_t from, uint32_t to) {
+        successors[from].push_back(to);
+        ++predecessorCount[to];
+    };
+
+    // Writers of an image run in declaration order, readers after the last writer
+    for (Resource& resource : m_resources)
+    {
+        resource.lastWriter = UINT32_MAX;
+    }
+    for (uint32_t passIndex = 0; passIndex < passCount; ++passIndex)
+    {
+        for (const Access& access : m_passes[passIndex].accesses)
+        {
+            Resource& resource = m_resources[access.resource];
+            if (access.write)
+            {
+                if (resource.lastWriter != UINT32_MAX)
+                {
+                    addEdge(resource.lastWriter, passIndex);
+                }
+                resource.lastWriter = passIndex;
+            }
+        }
+    }
+    for (uint32_t passIndex = 0; passIndex < passCount; ++passIndex)
+    {
+        for (const Access& access : m_passes[passIndex].accesses)
+        {
+            uint32_t lastWriter = m_resources[access.resource].lastWriter;
+            if (!access.write && lastWriter != UINT32_MAX)
+            {
+                addEdge(lastWriter, passIndex);
+            }
+        }
+    }
+
+    // Among the passes that are ready, the first declared runs first, so independent passes keep their order
+    std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> ready;
+    for (uint32_t passIndex = 0; passIndex < passCount; ++passIndex)
+    {
+        if (predecessorCount[passIndex] == 0)
+        {
+            ready.push(passIndex);
+        }
+    }
+
+    m_order.clear();
+    while (!ready.empty())
+    {
+        uint32_t passIndex = ready.top();
+        ready.pop();
+        m_order.push_back(passIndex);
+        for (uint32_t successor : successors[passIndex])
+        {
+            if (--predecessorCount[successor] == 0)
+            {
+                ready.push(successor);
+            }
+        }
+    }
+
+    if (m_order.size() != passCount)
+    {
+        auto cyclic = std::find_if(predecessorCount.begin(), predecessorCount.end(), [](uint32_t count) {
+            return count > 0;
+        });
+        GN_ERROR("Render graph pass {} is part of a dependency cycle",
+                 m_passes[static_cast<size_t>(cyclic - predecessorCount.begin())].name);
+        return false;
+    }
+    return true;
+}
+
+void RenderGraph::cullPasses()
+{
+    // Walk backwards from the imported images, every reader has been visited before the writers it depends on
+    std::vector<bool> needed(m_resources.size(), false);
+    for (size_t i = 0; i < m_resources.size(); ++i)
+    {
+        needed[i] = m_resources[i].imported;
+    }
+
+    for (auto it = m_order.rbegin(); it != m_order.rend(); ++it)
+    {
+        Pass& pass = m_passes[*it];
+        pass.culled = !pass.sideEffects;
+        for (const Access& access : pass.accesses)
+        {
+            if (access.write && needed[access.resource])
+            {
+                pass.culled = false;
+            }
+        }
+
+        if (!pass.culled)
+        {
+            for (const Access& access : pass.accesses)
+            {
+                if (!access.write)
+                {
+                    needed[access.resource] = true;
+                }
+            }
+        }
+    }
+
+    m_order.erase(std::remove_if(m_order.begin(),
+                                 m_order.end(),
+                                 [this](uint32_t passIndex) { return m_passes[passIndex].culled; }),
+                  m_order.end());
+
+    for (Resource& resource : m_resources)
+    {
+        resource.firstPass = UINT32_MAX;
+        resource.lastPass = 0;
+        resource.usageFlags = 0;
+    }
+    for (uint32_t position = 0; position < m_order.size(); ++position)
+    {
+        for (const Access& access : m_passes[m_order[position]].accesses)
+        {
+            Resource& resource = m_resources[access.resource];
+            resource.firstPass = std::min(resource.firstPass, position);
+            resource.lastPass = std::max(resource.lastPass, position);
+            resource.usageFlags |= getUsageInfo(access.usage).imageUsage;
+        }
+    }
+}
+
+bool RenderGraph::realizeTransientImages()
+{
+    std::vector<TransientImage> images;
+    for (Resource& resource : m_resources)
+    {
+        resource.transient = UINT32_MAX;
+        if (resource.imported || resource.firstPass == UINT32_MAX)
+        {
+            continue;
+        }
+
+        TransientImage& image = images.emplace_back();
+        image.desc = {resource.image.extent.width, resource.image.extent.height, resource.image.format};
+        image.usageFlags = resource.usageFlags;
+        image.firstPass = resource.firstPass;
+        image.lastPass = resource.lastPass;
+        resource.transient = static_cast<uint32_t>(images.size() - 1);
+    }
+
+    auto sameImage = [](const TransientImage& a, const TransientImage& b) {
+        return a.desc.width == b.desc.width && a.desc.height == b.desc.height && a.desc.format == b.desc.format &&
+               a.usageFlags == b.usageFlags && a.firstPass == b.firstPass && a.lastPass == b.lastPass;
+    };
+
+    // The memory aliasing depends on the lifetimes, so any change recreates all transient images
+    if (images.size() != m_transientImages.size() ||
+        !std::equal(images.begin(), images.end(), m_transientImages.begin(), sameImage))
+    {
+        if (!m_transientImages.empty())
+        {
+            destroyTransientImages();
+        }
+
+        m_transientImages = std::move(images);
+        if (!createTransientImages())
+        {
+            destroyTransientImages();
+            return false;
+        }
+    }
+
+    for (Resource& resource : m_resources)
+    {
+        if (resource.transient != UINT32_MAX)
+        {
+            resource.image.image = m_transientImages[resource.transient].image;
+            resource.image.view = m_transientImages[resource.transient].view;
+        }
+    }
+    return true;
+}
+
+bool RenderGraph::createTransientImages()
+{
+    std::vector<VkMemoryRequirements> requirements(m_transientImages.size());
+    for (size_t i = 0; i < m_transientImages.size(); ++i)
+    {
+        TransientImage& image = m_transientImages[i];
+
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = image.desc.format;
+        imageInfo.extent = {image.desc.width, image.desc.height, 1};
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = image.usageFlags;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        if (vkCreateImage(m_device, &imageInfo, nullptr, &image.image) != VK_SUCCESS)
+        {
+            GN_ERROR("Failed to create render graph image");
+            return false;
+        }
+        vkGetImageMemoryRequirements(m_device, image.image, &requirements[i]);
+    }
+
+    // Greedy interval packing: in order of first use, each image takes the best fitting slot whose
+    // previous images are no longer used, or a new slot if none is free
+    std::vector<uint32_t> byFirstUse(m_transientImages.size());
+    std::iota(byFirstUse.begin(), byFirstUse.end(), 0);
+    std::stable_sort(byFirstUse.begin(), byFirstUse.end(), [this](uint32_t a, uint32_t b) {
+        return m_transientImages[a].firstPass < m_transientImages[b].firstPass;
+    });
+
+    m_memorySlots.clear();
+    m_stats.unaliasedMemory = 0;
+    for (uint32_t imageIndex : byFirstUse)
+    {
+        TransientImage& image = m_transientImages[imageIndex];
+        const VkMemoryRequirements& required = requirements[imageIndex];
+        m_stats.unaliasedMemory += required.size;
+
+        uint32_t bestSlot = UINT32_MAX;
+        VkDeviceSize bestWaste = 0;
+        for (uint32_t slotIndex = 0; slotIndex < m_memorySlots.size(); ++slotIndex)
+        {
+            const MemorySlot& slot = m_memorySlots[slotIndex];
+            if (slot.lastPass >= image.firstPass || (slot.requirements.memoryTypeBits & required.memoryTypeBits) == 0)
+            {
+                continue;
+            }
+
+            // Either unused space in the slot or the amount it has to grow by
+            VkDeviceSize waste = slot.requirements.size >= required.size ? slot.requirements.size - required.size
+                                                                         : required.size - slot.requirements.size;
+            if (bestSlot == UINT32_MAX || waste < bestWaste)
+            {
+                bestSlot = slotIndex;
+                bestWaste = waste;
+            }
+        }
+
+        if (bestSlot == UINT32_MAX)
+        {
+            bestSlot = static_cast<uint32_t>(m_memorySlots.size());
+            m_memorySlots.emplace_back().requirements = required;
+        }
+        else
+        {
+            VkMemoryRequirements& slotRequirements = m_memorySlots[bestSlot].requirements;
+            slotRequirements.size = std::max(slotRequirements.size, required.size);
+            slotRequirements.alignment = std::max(slotRequirements.alignment, required.alignment);
+            slotRequirements.memoryTypeBits &= required.memoryTypeBits;
+        }
+        m_memorySlots[bestSlot].lastPass = image.lastPass;
+        image.slot = bestSlot;
+    }
+
+    m_stats.transientMemory = 0;
+    for (MemorySlot& slot : m_memorySlots)
+    {
+        if (!m_allocator->allocate(slot.requirements, MemoryUsage::GpuOnly, false, slot.allocation))
+        {
+            GN_ERROR("Failed to allocate render graph memory");
+            return false;
+        }
+        m_stats.transientMemory += slot.requirements.size;
+    }
+
+    for (TransientImage& image : m_transientImages)
+    {
+        const VulkanAllocation& allocation = m_memorySlots[image.slot].allocation;
+        if (vkBindImageMemory(m_device, image.image, allocation.memory, allocation.offset) != VK_SUCCESS)
+        {
+            GN_ERROR("Failed to bind render graph image memory");
+            return false;
+        }
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = image.image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = image.desc.format;
+        viewInfo.subresourceRange.aspectMask = getAspectMask(image.desc.format);
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.layerCount = 1;
+
+        if (vkCreateImageView(m_device, &viewInfo, nullptr, &image.view) != VK_SUCCESS)
+        {
+            GN_ERROR("Failed to create render graph image view");
+            return false;
+        }
+    }
+
+    m_stats.transientImageCount = static_cast<uint32_t>(m_transientImages.size());
+    GN_DEBUG("Render graph created {} transient images in {} KB, {} KB without aliasing",
+             m_transientImages.size(),
+             m_stats.transientMemory / 1024,
+             m_stats.unaliasedMemory / 1024);
+    return true;
+}
+
+void RenderGraph::destroyTransientImages()
+{
+    // Frames in flight may still use the images, the deletion queue keeps them until those have executed.
+    // Framebuffers may reference the views, imported views included, so they are all recreated on demand.
+    for (auto& [key, framebuffer] : m_framebuffers)
+    {
+        m_deletionQueue->destroyFramebuffer(framebuffer);
+    }
+    m_framebuffers.clear();
+
+    for (TransientImage& image : m_transientImages)
+    {
+        if (image.view != VK_NULL_HANDLE)
+        {
+            m_deletionQueue->destroyImageView(image.view);
+        }
+        if (image.image != VK_NULL_HANDLE)
+        {
+            // The memory is aliased and owned by the slots
+            VulkanAllocation noAllocation;
+            m_deletionQueue->destroyImage(image.image, noAllocation);
+        }
+    }
+    m_transientImages.clear();
+
+    for (MemorySlot& slot : m_memorySlots)
+    {
+        if (slot.allocation.isValid())
+        {
+            m_deletionQueue->free(slot.allocation);
+        }
+    }
+    m_memorySlots.clear();
+    m_stats.transientImageCount = 0;
+    m_stats.transientMemory = 0;
+    m_stats.unaliasedMemory = 0;
+}
+
+bool RenderGraph::compilePasses()
+{
+    m_barriers.clear();
+    for (Resource& resource : m_resources)
+    {
+        if (!resource.imported)
+        {
+            continue;
+        }
+
+        // The first pass waits for the last access before the frame
+        UsageInfo info = getUsageInfo(resource.image.initialUsage);
+        resource.state = ResourceState{};
+        resource.state.layout = resource.image.preserveContents ? info.layout : VK_IMAGE_LAYOUT_UNDEFINED;
+        resource.state.hasContents = resource.image.preserveContents;
+        if (isWriteUsage(resource.image.initialUsage))
+        {
+            resource.state.writeStages = info.stages;
+            resource.state.writeAccess = info.access & WRITE_ACCESS;
+        }
+        else
+        {
+            resource.state.readStages = info.stages;
+        }
+    }
+
+    for (uint32_t position = 0; position < m_order.size(); ++position)
+    {
+        Pass& pass = m_passes[m_order[position]];
+
+        // A transient image starts by waiting for the previous image of its memory slot, possibly from the last frame
+        for (const Access& access : pass.accesses)
+        {
+            Resource& resource = m_resources[access.resource];
+            if (resource.transient != UINT32_MAX && resource.firstPass == position)
+            {
+                resource.state = m_memorySlots[m_transientImages[resource.transient].slot].state;
+                resource.state.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+                resource.state.hasContents = false;
+            }
+        }
+
+        // Load and store ops depend on the contents before the pass
+        if (!createRenderPass(pass, position))
+        {
+            return false;
+        }
+
+        pass.firstBarrier = static_cast<uint32_t>(m_barriers.size());
+        for (const Access& access : pass.accesses)
+        {
+            transition(m_resources[access.resource], access.usage, access.write);
+        }
+        pass.barrierCount = static_cast<uint32_t>(m_barriers.size()) - pass.firstBarrier;
+
+        for (const Access& access : pass.accesses)
+        {
+            Resource& resource = m_resources[access.resource];
+            if (resource.transient != UINT32_MAX && resource.lastPass == position)
+            {
+                m_memorySlots[m_transientImages[resource.transient].slot].state = resource.state;
+            }
+        }
+    }
+
+    m_finalBarrier = static_cast<uint32_t>(m_barriers.size());
+    for (Resource& resource : m_resources)
+    {
+        if (resource.imported && resource.image.finalUsage != ResourceUsage::None)
+        {
+            transition(resource, resource.image.finalUsage, false);
+        }
+    }
+    return true;
+}
+
+bool RenderGraph::createRenderPass(Pass& pass, uint32_t position)
+{
+    pass.renderPass = VK_NULL_HANDLE;
+    pass.framebuffer = VK_NULL_HANDLE;
+    pass.clearValues.clear();
+
+    // Color attachments in declaration order, followed by the depth attachment
+    std::vector<const Access*> attachments;
+    for (const Access& access : pass.accesses)
+    {
+        if (access.usage == ResourceUsage::ColorAttachment)
+        {
+            attachments.push_back(&access);
+        }
+    }
+    uint32_t colorCount = static_cast<uint32_t>(attachments.size());
+    for (const Access& access : pass.accesses)
+    {
+        if (access.usage == ResourceUsage::DepthAttachment || access.usage == ResourceUsage::DepthRead)
+        {
+            attachments.push_back(&access);
+        }
+    }
+
+    if (attachments.empty())
+    {
+        return true;
+    }
+    if (attachments.size() > colorCount + 1)
+    {
+        GN_ERROR("Render graph pass {} has more than one depth attachment", pass.name);
+        return false;
+    }
+
+    std::vector<uint32_t> renderPassKey;
+    std::vector<VkAttachmentDescription> descriptions;
+    std::vector<VkImageView> views;
+    pass.extent = m_resources[attachments[0]->resource].image.extent;
+    for (const Access* access : attachments)
+    {
+        const Resource& resource = m_resources[access->resource];
+        if (resource.image.extent.width != pass.extent.width || resource.image.extent.height != pass.extent.height)
+        {
+            GN_ERROR("Attachments of render graph pass {} have different sizes", pass.name);
+            return false;
+        }
+
+        auto clear = std::find_if(pass.clears.begin(), pass.clears.end(), [access](const auto& entry) {
+            return entry.first == access->resource;
+        });
+
+        VkAttachmentDescription& description = descriptions.emplace_back();
+        description.format = resource.image.format;
+        description.samples = VK_SAMPLE_COUNT_1_BIT;
+        description.loadOp = clear != pass.clears.end()    ? VK_ATTACHMENT_LOAD_OP_CLEAR
+                             : resource.state.hasContents ? VK_ATTACHMENT_LOAD_OP_LOAD
+                                                          : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        description.storeOp = resource.imported || resource.lastPass > position ? VK_ATTACHMENT_STORE_OP_STORE
+                                                                                : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        bool hasStencil = (getAspectMask(resource.image.format) & VK_IMAGE_ASPECT_STENCIL_BIT) != 0;
+        description.stencilLoadOp = hasStencil ? description.loadOp : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        description.stencilStoreOp = hasStencil ? description.storeOp : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        // The barriers before the pass transition the layouts, the render pass keeps them as they are
+        description.initialLayout = getUsageInfo(access->usage).layout;
+        description.finalLayout = description.initialLayout;
+
+        renderPassKey.insert(renderPassKey.end(),
+                             {static_cast<uint32_t>(description.format),
+                              static_cast<uint32_t>(description.loadOp),
+                              static_cast<uint32_t>(description.storeOp),
+                              static_cast<uint32_t>(description.initialLayout)});
+        pass.clearValues.push_back(clear != pass.clears.end() ? clear->second : VkClearValue{});
+        views.push_back(resource.image.view);
+    }
+    renderPassKey.push_back(colorCount);
+
+    auto renderPass = m_renderPasses.find(renderPassKey);
+    if (renderPass == m_renderPasses.end())
+    {
+        std::vector<VkAttachmentReference> colorReferences(colorCount);
+        for (uint32_t i = 0; i < colorCount; ++i)
+        {
+            colorReferences[i] = {i, descriptions[i].initialLayout};
+        }
+        VkAttachmentReference depthReference{};
+        if (descriptions.size() > colorCount)
+        {
+            depthReference = {colorCount, descriptions[colorCount].initialLayout};
+        }
+
+        VkSubpassDescription subpass{};
+        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.colorAttachmentCount = colorCount;
+        subpass.pColorAttachments = colorReferences.data();
+        subpass.pDepthStencilAttachment = descriptions.size() > colorCount ? &depthReference : nullptr;
+
+        VkRenderPassCreateInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        renderPassInfo.attachmentCount = static_cast<uint32_t>(descriptions.size());
+        renderPassInfo.pAttachments = descriptions.data();
+        renderPassInfo.subpassCount = 1;
+        renderPassInfo.pSubpasses = &subpass;
+
+        VkRenderPass handle = VK_NULL_HANDLE;
+        if (vkCreateRenderPass(m_device, &renderPassInfo, nullptr, &handle) != VK_SUCCESS)
+        {
+            GN_ERROR("Failed to create render pass for render graph pass {}", pass.name);
+            return false;
+        }
+        renderPass = m_renderPasses.emplace(std::move(renderPassKey), handle).first;
+    }
+    pass.renderPass = renderPass->second;
+
+    std::vector<uint64_t> framebufferKey = {toKey(pass.renderPass), pass.extent.width, pass.extent.height};
+    for (VkImageView view : views)
+    {
+        framebufferKey.push_back(toKey(view));
+    }
+
+    auto framebuffer = m_framebuffers.find(framebufferKey);
+    if (framebuffer == m_framebuffers.end())
+    {
+        VkFramebufferCreateInfo framebufferInfo{};
+        framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebufferInfo.renderPass = pass.renderPass;
+        framebufferInfo.attachmentCount = static_cast<uint32_t>(views.size());
+        framebufferInfo.pAttachments = views.data();
+        framebufferInfo.width = pass.extent.width;
+        framebufferInfo.height = pass.extent.height;
+        framebufferInfo.layers = 1;
+
+        VkFramebuffer handle = VK_NULL_HANDLE;
+        if (vkCreateFramebuffer(m_device, &framebufferInfo, nullptr, &handle) != VK_SUCCESS)
+        {
+            GN_ERROR("Failed to create framebuffer for render graph pass {}", pass.name);
+            return false;
+        }
+        framebuffer = m_framebuffers.emplace(std::move(framebufferKey), handle).first;
+    }
+    pass.framebuffer = framebuffer->second;
+    return true;
+}
+
+void RenderGraph::transition(Resource& resource, ResourceUsage usage, bool write)
+{
+    UsageInfo info = getUsageInfo(usage);
+    ResourceState& state = resource.state;
+    bool layoutChange = state.layout != info.layout;
+
+    VkPipelineStageFlags waitStages = 0;
+    VkAccessFlags waitAccess = 0;
+    if (write || layoutChange)
+    {
+        // Writes and layout transitions must not overlap any earlier access
+        waitStages = state.writeStages | state.readStages;
+        waitAccess = state.writeAccess;
+    }
+    else if ((info.stages & ~state.visibleStages) != 0 || (info.access & ~state.visibleAccess) != 0)
+    {
+        // Reads only wait for the last write, and only once per stage
+        waitStages = state.writeStages;
+        waitAccess = state.writeAccess;
+    }
+
+    if (layoutChange || waitStages != 0)
+    {
+        // Without earlier accesses the source stages are empty, the transition waits for nothing
+        VkImageMemoryBarrier2 barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+        barrier.srcStageMask = waitStages;
+        barrier.srcAccessMask = waitAccess;
+        barrier.dstStageMask = info.stages;
+        barrier.dstAccessMask = info.access;
+        // Contents that are overwritten anyway don't need to survive the transition
+        barrier.oldLayout = state.hasContents ? state.layout : VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = info.layout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = resource.image.image;
+        barrier.subresourceRange.aspectMask = getAspectMask(resource.image.format);
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.layerCount = 1;
+        m_barriers.push_back(barrier);
+    }
+
+    if (write || layoutChange)
+    {
+        // A layout transition behaves like a write that later accesses have to wait for
+        state.layout = info.layout;
+        state.writeStages = info.stages;
+        state.writeAccess = write ? info.access & WRITE_ACCESS : 0;
+        state.readStages = write ? 0 : info.stages;
+        state.visibleStages = info.stages;
+        state.visibleAccess = info.access;
+    }
+    else
+    {
+        state.readStages |= info.stages;
+        if (waitStages != 0)
+        {
+            state.visibleStages |= info.stages;
+            state.visibleAccess |= info.access;
+        }
+    }
+    state.hasContents = state.hasContents || write;
+}
+
+} // namespace graphyne::graphics
@@ -1,22 +1,25 @@
 #include "graphics/renderer.h"
+#include "graphics/null_renderer.h"
 #include "graphics/vulkan_renderer.h"
 #include "utils/logger.h"
 
 namespace graphyne::graphics
 {
 
-Renderer::Renderer(platform::Window& window, const Config& config) : m_window(window), m_config(config) {}
+Renderer::Renderer(platform::Window* window, const Config& config) : m_window(window), m_config(config) {}
 
-std::unique_ptr<Renderer> Renderer::create(platform::Window& window, const Config& config)
+std::unique_ptr<Renderer> Renderer::create(platform::Window* window, const Config& config)
 {
-    // For now, we only support Vulkan
-    auto renderer = std::make_unique<VulkanRenderer>(window, config);
-    if (!renderer->initialize())
+    switch (config.backend)
     {
-        GN_ERROR("Failed to create Vulkan renderer");
-        return nullptr;
+        case Backend::Vulkan:
+            return std::make_unique<VulkanRenderer>(window, config);
+        case Backend::Null:
+            return std::make_unique<NullRenderer>(window, config);
+        default:
+            GN_ERROR("Unknown renderer backend");
+            return nullptr;
     }
-    return renderer;
 }
 
 } // namespace graphyne::graphics
@@ -0,0 +1,834 @@
+#include "graphics/vulkan_allocator.h"
+#include "core/memory.h"
+#include "utils/logger.h"
+#include <algorithm>
+#include <bit>
+
+namespace graphyne::graphics
+{
+
+namespace
+{
+
+VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+VkDeviceSize alignDown(VkDeviceSize value, VkDeviceSize alignment)
+{
+    return value / alignment * alignment;
+}
+
+double toMegabytes(VkDeviceSize bytes)
+{
+    return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+} // namespace
+
+/**
+ * @brief One VkDeviceMemory block, sub-allocated with a two-level segregated fit allocator
+ *
+ * Free chunks are kept in size class lists indexed by the position of the highest set bit
+ * (first level) and the next SECOND_LEVEL_LOG2 bits (second level). Bitmaps of the non-empty
+ * lists find a chunk that is large enough with two bit scans. Chunks also form a list in
+ * address order so freed chunks merge with their free neighbours.
+ */
+class VulkanAllocator::Block
+{
+public:
+    Block(VkDeviceMemory memory, VkDeviceSize size, void* mapped, bool linear)
+        : m_memory(memory), m_size(size), m_mapped(mapped), m_linear(linear)
+    {
+        m_freeLists.fill(NONE);
+
+        Chunk chunk;
+        chunk.size = size;
+        m_chunks.push_back(chunk);
+        insertFree(0);
+    }
+
+    /**
+     * @brief Allocate a range from the block
+     * @param size Size of the range
+     * @param alignment Required alignment of the range offset
+     * @param offset Receives the offset of the range
+     * @param chunk Receives the chunk to pass to free()
+     * @return True if the block had room, false otherwise
+     */
+    bool allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset, uint32_t& chunk)
+    {
+        // Searching for the padded size guarantees the aligned range fits in whatever chunk is found
+        uint32_t index = findFree(size + alignment - 1);
+        if (index == NONE)
+        {
+            return false;
+        }
+        removeFree(index);
+
+        VkDeviceSize padding = alignUp(m_chunks[index].offset, alignment) - m_chunks[index].offset;
+        if (padding > 0)
+        {
+            // The previous chunk is never free, free neighbours are always merged
+            uint32_t front = createChunk();
+            m_chunks[front].offset = m_chunks[index].offset;
+            m_chunks[front].size = padding;
+            linkAfter(m_chunks[index].prevPhysical, front);
+
+            m_chunks[index].offset += padding;
+            m_chunks[index].size -= padding;
+            insertFree(front);
+        }
+
+        if (m_chunks[index].size > size)
+        {
+            uint32_t back = createChunk();
+            m_chunks[back].offset = m_chunks[index].offset + size;
+            m_chunks[back].size = m_chunks[index].size - size;
+            linkAfter(index, back);
+
+            m_chunks[index].size = size;
+            insertFree(back);
+        }
+
+        m_usedBytes += size;
+        ++m_allocationCount;
+        offset = m_chunks[index].offset;
+        chunk = index;
+        return true;
+    }
+
+    /**
+     * @brief Return a range to the block
+     * @param chunk Chunk returned by allocate()
+     * @return Size of the freed range
+     */
+    VkDeviceSize free(uint32_t chunk)
+    {
+        VkDeviceSize size = m_chunks[chunk].size;
+        m_usedBytes -= size;
+        --m_allocationCount;
+
+        uint32_t previous = m_chunks[chunk].prevPhysical;
+        if (previous != NONE && m_chunks[previous].free)
+        {
+            removeFree(previous);
+            m_chunks[previous].size += m_chunks[chunk].size;
+            unlink(chunk);
+            chunk = previous;
+        }
+
+        uint32_t next = m_chunks[chunk].nextPhysical;
+        if (next != NONE && m_chunks[next].free)
+        {
+            removeFree(next);
+            m_chunks[chunk].size += m_chunks[next].size;
+            unlink(next);
+        }
+
+        insertFree(chunk);
+        return size;
+    }
+
+    VkDeviceMemory getMemory() const { return m_memory; }
+    VkDeviceSize getSize() const { return m_size; }
+    void* getMapped() const { return m_mapped; }
+    bool isLinear() const { return m_linear; }
+    bool isEmpty() const { return m_allocationCount == 0; }
+    VkDeviceSize getUsedBytes() const { return m_usedBytes; }
+
+private:
+    static constexpr uint32_t SECOND_LEVEL_LOG2 = 4;
+    static constexpr uint32_t SECOND_LEVEL_COUNT = 1u << SECOND_LEVEL_LOG2;
+    static constexpr uint32_t FIRST_LEVEL_COUNT = 64 - SECOND_LEVEL_LOG2 + 1;
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Chunk
+    {
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+        uint32_t prevPhysical = NONE; // Neighbours in address order
+        uint32_t nextPhysical = NONE;
+        uint32_t prevFree = NONE; // Neighbours in the free list of the size class
+        uint32_t nextFree = NONE;
+        bool free = false;
+    };
+
+    static void getSizeClass(VkDeviceSize size, uint32_t& firstLevel, uint32_t& secondLevel)
+    {
+        uint32_t log2 = static_cast<uint32_t>(std::bit_width(size)) - 1;
+        if (log2 < SECOND_LEVEL_LOG2)
+        {
+            // Sizes below SECOND_LEVEL_COUNT are spread linearly over the first class
+            firstLevel = 0;
+            secondLevel = static_cast<uint32_t>(size);
+        }
+        else
+        {
+            firstLevel = log2 - SECOND_LEVEL_LOG2 + 1;
+            secondLevel = static_cast<uint32_t>(size >> (log2 - SECOND_LEVEL_LOG2)) ^ SECOND_LEVEL_COUNT;
+        }
+    }
+
+    uint32_t findFree(VkDeviceSize size) const
+    {
+        // Round up to the next size class, every chunk in it is then large enough
+        if (size >= SECOND_LEVEL_COUNT)
+        {
+            uint32_t log2 = static_cast<uint32_t>(std::bit_width(size)) - 1;
+            size += (VkDeviceSize(1) << (log2 - SECOND_LEVEL_LOG2)) - 1;
+        }
+
+        uint32_t firstLevel = 0;
+        uint32_t secondLevel = 0;
+        getSizeClass(size, firstLevel, secondLevel);
+        if (firstLevel >= FIRST_LEVEL_COUNT)
+        {
+            return NONE;
+        }
+
+        uint32_t secondLevelMap = m_secondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+        if (secondLevelMap == 0)
+        {
+            uint64_t firstLevelMap = m_firstLevelBitmap & (~uint64_t(0) << (firstLevel + 1));
+            if (firstLevelMap == 0)
+            {
+                return NONE;
+            }
+            firstLevel = static_cast<uint32_t>(std::countr_zero(firstLevelMap));
+            secondLevelMap = m_secondLevelBitmaps[firstLevel];
+        }
+
+        secondLevel = static_cast<uint32_t>(std::countr_zero(secondLevelMap));
+        return m_freeLists[firstLevel * SECOND_LEVEL_COUNT + secondLevel];
+    }
+
+    void insertFree(uint32_t index)
+    {
+        uint32_t firstLevel = 0;
+        uint32_t secondLevel = 0;
+        getSizeClass(m_chunks[index].size, firstLevel, secondLevel);
+
+        uint32_t& head = m_freeLists[firstLevel * SECOND_LEVEL_COUNT + secondLevel];
+        m_chunks[index].free = true;
+        m_chunks[index].prevFree = NONE;
+        m_chunks[index].nextFree = head;
+        if (head != NONE)
+        {
+            m_chunks[head].prevFree = index;
+        }
+        head = index;
+
+        m_firstLevelBitmap |= uint64_t(1) << firstLevel;
+        m_secondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+    }
+
+    void removeFree(uint32_t index)
+    {
+        Chunk& chunk = m_chunks[index];
+        chunk.free = false;
+
+        if (chunk.nextFree != NONE)
+        {
+            m_chunks[chunk.nextFree].prevFree = chunk.prevFree;
+        }
+
+        if (chunk.prevFree != NONE)
+        {
+            m_chunks[chunk.prevFree].nextFree = chunk.nextFree;
+            return;
+        }
+
+        // The chunk was the head of its list
+        uint32_t firstLevel = 0;
+        uint32_t secondLevel = 0;
+        getSizeClass(chunk.size, firstLevel, secondLevel);
+        m_freeLists[firstLevel * SECOND_LEVEL_COUNT + secondLevel] = chunk.nextFree;
+        if (chunk.nextFree == NONE)
+        {
+            m_secondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+            if (m_secondLevelBitmaps[firstLevel] == 0)
+            {
+                m_firstLevelBitmap &= ~(uint64_t(1) << firstLevel);
+            }
+        }
+    }
+
+    uint32_t createChunk()
+    {
+        if (!m_unusedChunks.empty())
+        {
+            uint32_t index = m_unusedChunks.back();
+            m_unusedChunks.pop_back();
+            m_chunks[index] = Chunk{};
+            return index;
+        }
+        m_chunks.emplace_back();
+        return static_cast<uint32_t>(m_chunks.size() - 1);
+    }
+
+    // Insert index into the address order list after previous, or at the front if previous is NONE
+    void linkAfter(uint32_t previous, uint32_t index)
+    {
+        uint32_t next = NONE;
+        if (previous != NONE)
+        {
+            next = m_chunks[previous].nextPhysical;
+            m_chunks[previous].nextPhysical = index;
+        }
+        else
+        {
+            // Only the padding of the first chunk of the block is inserted at the front
+            next = m_firstChunk;
+            m_firstChunk = index;
+        }
+
+        m_chunks[index].prevPhysical = previous;
+        m_chunks[index].nextPhysical = next;
+        if (next != NONE)
+        {
+            m_chunks[next].prevPhysical = index;
+        }
+    }
+
+    // Remove a chunk merged into a neighbour from the address order list
+    void unlink(uint32_t index)
+    {
+        Chunk& chunk = m_chunks[index];
+        if (chunk.prevPhysical != NONE)
+        {
+            m_chunks[chunk.prevPhysical].nextPhysical = chunk.nextPhysical;
+        }
+        else
+        {
+            m_firstChunk = chunk.nextPhysical;
+        }
+
+        if (chunk.nextPhysical != NONE)
+        {
+            m_chunks[chunk.nextPhysical].prevPhysical = chunk.prevPhysical;
+        }
+        m_unusedChunks.push_back(index);
+    }
+
+    VkDeviceMemory m_memory;
+    VkDeviceSize m_size;
+    void* m_mapped;
+    bool m_linear;
+
+    std::vector<Chunk> m_chunks;
+    std::vector<uint32_t> m_unusedChunks; // Chunk slots released by merges
+    uint32_t m_firstChunk = 0;
+    uint64_t m_firstLevelBitmap = 0;
+    std::array<uint32_t, FIRST_LEVEL_COUNT> m_secondLevelBitmaps = {};
+    std::array<uint32_t, FIRST_LEVEL_COUNT * SECOND_LEVEL_COUNT> m_freeLists;
+    VkDeviceSize m_usedBytes = 0;
+    uint32_t m_allocationCount = 0;
+};
+
+VulkanAllocator::VulkanAllocator() = default;
+
+VulkanAllocator::~VulkanAllocator()
+{
+    shutdown();
+}
+
+bool VulkanAllocator::initialize(VkPhysicalDevice physicalDevice, VkDevice device, VkDeviceSize blockSize)
+{
+    m_device = device;
+    m_blockSize = blockSize;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &m_memoryProperties);
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    m_bufferImageGranularity = std::max<VkDeviceSize>(1, properties.limits.bufferImageGranularity);
+    m_nonCoherentAtomSize = std::max<VkDeviceSize>(1, properties.limits.nonCoherentAtomSize);
+    m_maxAllocationCount = properties.limits.maxMemoryAllocationCount;
+
+    for (uint32_t i = 0; i < m_memoryProperties.memoryHeapCount; ++i)
+    {
+        m_heapStats[i] = HeapStats{};
+        m_heapStats[i].heapSize = m_memoryProperties.memoryHeaps[i].size;
+        m_heapStats[i].deviceLocal = (m_memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+    }
+
+    GN_INFO("Vulkan allocator initialized with {} memory types, {} heaps, {:.0f} MiB blocks",
+            m_memoryProperties.memoryTypeCount,
+            m_memoryProperties.memoryHeapCount,
+            toMegabytes(m_blockSize));
+    return true;
+}
+
+void VulkanAllocator::shutdown()
+{
+    if (m_device == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (uint32_t type = 0; type < m_memoryProperties.memoryTypeCount; ++type)
+    {
+        for (std::unique_ptr<Block>& block : m_blocks[type])
+        {
+            if (!block)
+            {
+                continue;
+            }
+            if (!block->isEmpty())
+            {
+                GN_WARNING("Freeing device memory block with {} bytes still in use", block->getUsedBytes());
+            }
+            freeDeviceMemory(type, block->getSize(), block->getMemory());
+        }
+        m_blocks[type].clear();
+    }
+
+    for (const HeapStats& stats : m_heapStats)
+    {
+        if (stats.dedicatedCount > 0)
+        {
+            GN_WARNING("{} dedicated device memory allocations were not freed", stats.dedicatedCount);
+        }
+    }
+
+    m_heapStats = {};
+    m_deviceAllocationCount = 0;
+    m_device = VK_NULL_HANDLE;
+}
+
+bool VulkanAllocator::createBuffer(const VkBufferCreateInfo& createInfo,
+                                   MemoryUsage usage,
+                                   VkBuffer& buffer,
+                                   VulkanAllocation& allocation)
+{
+    if (vkCreateBuffer(m_device, &createInfo, nullptr, &buffer) != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to create buffer");
+        return false;
+    }
+
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements(m_device, buffer, &requirements);
+
+    if (!allocate(requirements, usage, true, allocation))
+    {
+        vkDestroyBuffer(m_device, buffer, nullptr);
+        buffer = VK_NULL_HANDLE;
+        return false;
+    }
+
+    if (vkBindBufferMemory(m_device, buffer, allocation.memory, allocation.offset) != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to bind buffer memory");
+        destroyBuffer(buffer, allocation);
+        buffer = VK_NULL_HANDLE;
+        return false;
+    }
+
+    return true;
+}
+
+void VulkanAllocator::destroyBuffer(VkBuffer buffer, VulkanAllocation& allocation)
+{
+    if (buffer != VK_NULL_HANDLE)
+    {
+        vkDestroyBuffer(m_device, buffer, nullptr);
+    }
+    free(allocation);
+}
+
+bool VulkanAllocator::createImage(const VkImageCreateInfo& createInfo,
+                                  MemoryUsage usage,
+                                  VkImage& image,
+                                  VulkanAllocation& allocation)
+{
+    if (vkCreateImage(m_device, &createInfo, nullptr, &image) != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to create image");
+        return false;
+    }
+
+    VkMemoryRequirements requirements;
+    vkGetImageMemoryRequirements(m_device, image, &requirements);
+
+    if (!allocate(requirements, usage, createInfo.tiling == VK_IMAGE_TILING_LINEAR, allocation))
+    {
+        vkDestroyImage(m_device, image, nullptr);
+        image = VK_NULL_HANDLE;
+        return false;
+    }
+
+    if (vkBindImageMemory(m_device, image, allocation.memory, allocation.offset) != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to bind image memory");
+        destroyImage(image, allocation);
+        image = VK_NULL_HANDLE;
+        return false;
+    }
+
+    return true;
+}
+
+void VulkanAllocator::destroyImage(VkImage image, VulkanAllocation& allocation)
+{
+    if (image != VK_NULL_HANDLE)
+    {
+        vkDestroyImage(m_device, image, nullptr);
+    }
+    free(allocation);
+}
+
+bool VulkanAllocator::allocate(const VkMemoryRequirements& requirements,
+                               MemoryUsage usage,
+                               bool linear,
+                               VulkanAllocation& allocation)
+{
+    std::vector<uint32_t> memoryTypes;
+    if (!findMemoryTypes(requirements.memoryTypeBits, usage, memoryTypes))
+    {
+        GN_ERROR("No memory type supports the requested usage");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Fall back to less preferred memory types when a heap is exhausted
+    for (uint32_t memoryType : memoryTypes)
+    {
+        if (allocateFromType(memoryType, requirements, linear, allocation))
+        {
+            return true;
+        }
+    }
+
+    GN_ERROR("Failed to allocate {} bytes of device memory", requirements.size);
+    return false;
+}
+
+void VulkanAllocator::free(VulkanAllocation& allocation)
+{
+    if (!allocation.isValid())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    HeapStats& stats = m_heapStats[getHeapIndex(allocation.memoryType)];
+
+    if (allocation.isDedicated())
+    {
+        freeDeviceMemory(allocation.memoryType, allocation.size, allocation.memory);
+        stats.usedBytes -= allocation.size;
+        --stats.dedicatedCount;
+        --stats.allocationCount;
+        allocation = VulkanAllocation{};
+        return;
+    }
+
+    std::vector<std::unique_ptr<Block>>& blocks = m_blocks[allocation.memoryType];
+    std::unique_ptr<Block>& block = blocks[allocation.block];
+    stats.usedBytes -= block->free(allocation.chunk);
+    --stats.allocationCount;
+
+    // Keep one block per memory type around, so a single resource being recreated does not reallocate it
+    if (block->isEmpty())
+    {
+        auto blockCount = std::count_if(blocks.begin(), blocks.end(), [](const auto& b) { return b != nullptr; });
+        if (blockCount > 1)
+        {
+            freeDeviceMemory(allocation.memoryType, block->getSize(), block->getMemory());
+            block.reset();
+            --stats.blockCount;
+        }
+    }
+
+    allocation = VulkanAllocation{};
+}
+
+void VulkanAllocator::flush(const VulkanAllocation& allocation, VkDeviceSize offset, VkDeviceSize size)
+{
+    if (allocation.mapped && !isCoherent(allocation.memoryType))
+    {
+        VkMappedMemoryRange range = getMappedRange(allocation, offset, size);
+        vkFlushMappedMemoryRanges(m_device, 1, &range);
+    }
+}
+
+void VulkanAllocator::invalidate(const VulkanAllocation& allocation, VkDeviceSize offset, VkDeviceSize size)
+{
+    if (allocation.mapped && !isCoherent(allocation.memoryType))
+    {
+        VkMappedMemoryRange range = getMappedRange(allocation, offset, size);
+        vkInvalidateMappedMemoryRanges(m_device, 1, &range);
+    }
+}
+
+std::vector<HeapStats> VulkanAllocator::getHeapStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::vector<HeapStats>(m_heapStats.begin(), m_heapStats.begin() + m_memoryProperties.memoryHeapCount);
+}
+
+void VulkanAllocator::logStatistics() const
+{
+    std::vector<HeapStats> heapStats = getHeapStats();
+    for (size_t i = 0; i < heapStats.size(); ++i)
+    {
+        const HeapStats& stats = heapStats[i];
+        GN_INFO("Memory heap {} ({}): {:.1f} MiB used, {:.1f} MiB allocated of {:.1f} MiB, "
+                "{} blocks, {} dedicated, {} allocations",
+                i,
+                stats.deviceLocal ? "device local" : "host",
+                toMegabytes(stats.usedBytes),
+                toMegabytes(stats.allocatedBytes),
+                toMegabytes(stats.heapSize),
+                stats.blockCount,
+                stats.dedicatedCount,
+                stats.allocationCount);
+    }
+}
+
+bool VulkanAllocator::findMemoryTypes(uint32_t typeBits, MemoryUsage usage, std::vector<uint32_t>& types) const
+{
+    VkMemoryPropertyFlags required = 0;
+    VkMemoryPropertyFlags preferred = 0;
+    VkMemoryPropertyFlags avoided = 0;
+    switch (usage)
+    {
+        case MemoryUsage::GpuOnly:
+            // Integrated GPUs only have host visible device local memory, so that is not excluded
+            preferred = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+            avoided = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+            break;
+        case MemoryUsage::CpuToGpu:
+            required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+            preferred = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+            avoided = VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+            break;
+        case MemoryUsage::GpuToCpu:
+            // Reading from uncached memory is very slow
+            required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+            preferred = VK_MEMORY_PROPERTY_HOST_CACHED_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+            break;
+    }
+
+    // Lazily allocated and protected memory can't back regular resources
+    VkMemoryPropertyFlags excluded = VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT | VK_MEMORY_PROPERTY_PROTECTED_BIT;
+
+    std::vector<std::pair<int, uint32_t>> candidates;
+    for (uint32_t i = 0; i < m_memoryProperties.memoryTypeCount; ++i)
+    {
+        VkMemoryPropertyFlags flags = m_memoryProperties.memoryTypes[i].propertyFlags;
+        if (!(typeBits & (1u << i)) || (flags & required) != required || (flags & excluded) != 0)
+        {
+            continue;
+        }
+
+        int score = 2 * std::popcount(flags & preferred) - std::popcount(flags & avoided);
+        candidates.emplace_back(-score, i);
+    }
+
+    // Highest score first, lower type indices first on ties as the specification orders them by performance
+    std::sort(candidates.begin(), candidates.end());
+
+    types.clear();
+    for (const auto& candidate : candidates)
+    {
+        types.push_back(candidate.second);
+    }
+    return !types.empty();
+}
+
+bool VulkanAllocator::allocateFromType(uint32_t memoryType,
+                                       const VkMemoryRequirements& requirements,
+                                       bool linear,
+                                       VulkanAllocation& allocation)
+{
+    VkDeviceSize size = requirements.size;
+    VkDeviceSize alignment = std::max<VkDeviceSize>(1, requirements.alignment);
+
+    // Keep non-coherent ranges atom aligned, so flushing one allocation never touches its neighbours
+    if (isHostVisible(memoryType) && !isCoherent(memoryType))
+    {
+        size = alignUp(size, m_nonCoherentAtomSize);
+        alignment = std::max(alignment, m_nonCoherentAtomSize);
+    }
+
+    VkDeviceSize blockSize = getBlockSize(memoryType);
+    if (size > blockSize / 2)
+    {
+        return allocateDedicated(memoryType, size, allocation);
+    }
+
+    // Without a granularity constraint buffers and images can share blocks
+    bool separateLinear = m_bufferImageGranularity > 1;
+    std::vector<std::unique_ptr<Block>>& blocks = m_blocks[memoryType];
+    HeapStats& stats = m_heapStats[getHeapIndex(memoryType)];
+
+    auto allocateFromBlock = [&](uint32_t index) {
+        Block& block = *blocks[index];
+        VkDeviceSize offset = 0;
+        uint32_t chunk = 0;
+        if ((separateLinear && block.isLinear() != linear) || !block.allocate(size, alignment, offset, chunk))
+        {
+            return false;
+        }
+
+        allocation.memory = block.getMemory();
+        allocation.offset = offset;
+        allocation.size = size;
+        allocation.mapped = block.getMapped() ? static_cast<uint8_t*>(block.getMapped()) + offset : nullptr;
+        allocation.memoryType = memoryType;
+        allocation.block = index;
+        allocation.chunk = chunk;
+        stats.usedBytes += size;
+        ++stats.allocationCount;
+        return true;
+    };
+
+    for (uint32_t i = 0; i < blocks.size(); ++i)
+    {
+        if (blocks[i] && allocateFromBlock(i))
+        {
+            return true;
+        }
+    }
+
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    void* mapped = nullptr;
+    if (allocateDeviceMemory(memoryType, blockSize, memory, mapped) != VK_SUCCESS)
+    {
+        // The heap may still have room for the resource on its own
+        return allocateDedicated(memoryType, size, allocation);
+    }
+
+    auto freeSlot = std::find(blocks.begin(), blocks.end(), nullptr);
+    if (freeSlot == blocks.end())
+    {
+        freeSlot = blocks.insert(blocks.end(), nullptr);
+    }
+    *freeSlot = std::make_unique<Block>(memory, blockSize, mapped, linear);
+    ++stats.blockCount;
+
+    return allocateFromBlock(static_cast<uint32_t>(freeSlot - blocks.begin()));
+}
+
+bool VulkanAllocator::allocateDedicated(uint32_t memoryType, VkDeviceSize size, VulkanAllocation& allocation)
+{
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    void* mapped = nullptr;
+    if (allocateDeviceMemory(memoryType, size, memory, mapped) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    allocation.memory = memory;
+    allocation.offset = 0;
+    allocation.size = size;
+    allocation.mapped = mapped;
+    allocation.memoryType = memoryType;
+    allocation.block = VulkanAllocation::DEDICATED_BLOCK;
+    allocation.chunk = 0;
+
+    HeapStats& stats = m_heapStats[getHeapIndex(memoryType)];
+    stats.usedBytes += size;
+    ++stats.dedicatedCount;
+    ++stats.allocationCount;
+    return true;
+}
+
+VkResult VulkanAllocator::allocateDeviceMemory(uint32_t memoryType,
+                                               VkDeviceSize size,
+                                               VkDeviceMemory& memory,
+                                               void*& mapped)
+{
+    if (m_deviceAllocationCount >= m_maxAllocationCount)
+    {
+        GN_ERROR("Reached maxMemoryAllocationCount of {} device memory allocations", m_maxAllocationCount);
+        return VK_ERROR_TOO_MANY_OBJECTS;
+    }
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryType;
+
+    VkResult result = vkAllocateMemory(m_device, &allocInfo, nullptr, &memory);
+    if (result != VK_SUCCESS)
+    {
+        return result;
+    }
+
+    mapped = nullptr;
+    if (isHostVisible(memoryType))
+    {
+        result = vkMapMemory(m_device, memory, 0, VK_WHOLE_SIZE, 0, &mapped);
+        if (result != VK_SUCCESS)
+        {
+            vkFreeMemory(m_device, memory, nullptr);
+            memory = VK_NULL_HANDLE;
+            return result;
+        }
+    }
+
+    m_heapStats[getHeapIndex(memoryType)].allocatedBytes += size;
+    ++m_deviceAllocationCount;
+    core::MemoryManager::getInstance().trackExternalAllocation(static_cast<size_t>(size),
+                                                               core::AllocationType::Graphics);
+    return VK_SUCCESS;
+}
+
+void VulkanAllocator::freeDeviceMemory(uint32_t memoryType, VkDeviceSize size, VkDeviceMemory memory)
+{
+    // Freeing mapped memory implicitly unmaps it
+    vkFreeMemory(m_device, memory, nullptr);
+
+    m_heapStats[getHeapIndex(memoryType)].allocatedBytes -= size;
+    --m_deviceAllocationCount;
+    core::MemoryManager::getInstance().trackExternalFree(static_cast<size_t>(size), core::AllocationType::Graphics);
+}
+
+VkMappedMemoryRange VulkanAllocator::getMappedRange(const VulkanAllocation& allocation,
+                                                    VkDeviceSize offset,
+                                                    VkDeviceSize size) const
+{
+    VkDeviceSize end = size == VK_WHOLE_SIZE ? allocation.size : std::min(offset + size, allocation.size);
+
+    // Non-coherent allocations are atom aligned, so the widened range stays inside the allocation
+    VkMappedMemoryRange range{};
+    range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+    range.memory = allocation.memory;
+    range.offset = alignDown(allocation.offset + offset, m_nonCoherentAtomSize);
+    range.size = alignUp(allocation.offset + end, m_nonCoherentAtomSize) - range.offset;
+    return range;
+}
+
+VkDeviceSize VulkanAllocator::getBlockSize(uint32_t memoryType) const
+{
+    // Small heaps, such as the 256 MiB host visible device local heap, would be used up by a few blocks
+    VkDeviceSize heapSize = m_memoryProperties.memoryHeaps[getHeapIndex(memoryType)].size;
+    if (heapSize <= 1024ull * 1024 * 1024)
+    {
+        return std::min(m_blockSize, heapSize / 8);
+    }
+    return m_blockSize;
+}
+
+bool VulkanAllocator::isHostVisible(uint32_t memoryType) const
+{
+    return (m_memoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+}
+
+bool VulkanAllocator::isCoherent(uint32_t memoryType) const
+{
+    return (m_memoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+}
+
+uint32_t VulkanAllocator::getHeapIndex(uint32_t memoryType) const
+{
+    return m_memoryProperties.memoryTypes[memoryType].heapIndex;
+}
+
+} // namespace graphyne::graphics
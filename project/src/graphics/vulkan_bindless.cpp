@@ -0,0 +1,233 @@
+#include "graphics/vulkan_bindless.h"
+#include "utils/logger.h"
+#include <algorithm>
+#include <array>
+
+namespace graphyne::graphics
+{
+
+namespace
+{
+
+// Upper bound of each array, the descriptor memory is allocated up front
+constexpr uint32_t MAX_TEXTURES = 16384;
+constexpr uint32_t MAX_BUFFERS = 16384;
+
+} // namespace
+
+VulkanBindlessHeap::~VulkanBindlessHeap()
+{
+    shutdown();
+}
+
+bool VulkanBindlessHeap::initialize(VkPhysicalDevice physicalDevice, VkDevice device)
+{
+    m_device = device;
+
+    VkPhysicalDeviceDescriptorIndexingProperties indexingProperties{};
+    indexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+    VkPhysicalDeviceProperties2 properties{};
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties.pNext = &indexingProperties;
+    vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+
+    // Combined image samplers count against both the sampler and the sampled image limits
+    uint32_t textureCount = std::min({MAX_TEXTURES,
+                                      indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages,
+                                      indexingProperties.maxDescriptorSetUpdateAfterBindSamplers,
+                                      indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                                      indexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers});
+    uint32_t bufferCount = std::min({MAX_BUFFERS,
+                                     indexingProperties.maxDescriptorSetUpdateAfterBindStorageBuffers,
+                                     indexingProperties.maxPerStageDescriptorUpdateAfterBindStorageBuffers});
+    uint32_t resourceLimit = indexingProperties.maxPerStageUpdateAfterBindResources;
+    if (textureCount + bufferCount > resourceLimit)
+    {
+        bufferCount = std::min(bufferCount, resourceLimit / 2);
+        textureCount = std::min(textureCount, resourceLimit - bufferCount);
+    }
+    m_textures.capacity = textureCount;
+    m_buffers.capacity = bufferCount;
+
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+    bindings[0].binding = TEXTURE_BINDING;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[0].descriptorCount = textureCount;
+    bindings[0].stageFlags = VK_SHADER_STAGE_ALL;
+    bindings[1].binding = BUFFER_BINDING;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[1].descriptorCount = bufferCount;
+    bindings[1].stageFlags = VK_SHADER_STAGE_ALL;
+
+    std::array<VkDescriptorBindingFlags, 2> bindingFlags{};
+    bindingFlags.fill(VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT);
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo{};
+    flagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    flagsInfo.bindingCount = static_cast<uint32_t>(bindingFlags.size());
+    flagsInfo.pBindingFlags = bindingFlags.data();
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.pNext = &flagsInfo;
+    layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &m_layout) != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to create bindless descriptor set layout");
+        return false;
+    }
+
+    std::array<VkDescriptorPoolSize, 2> poolSizes = {{{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, textureCount},
+                                                      {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, bufferCount}}};
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+
+    if (vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &m_pool) != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to create bindless descriptor pool");
+        return false;
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_pool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &m_layout;
+
+    if (vkAllocateDescriptorSets(m_device, &allocInfo, &m_set) != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to allocate bindless descriptor set");
+        return false;
+    }
+
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+
+    if (vkCreateSampler(m_device, &samplerInfo, nullptr, &m_sampler) != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to create bindless sampler");
+        return false;
+    }
+
+    GN_INFO("Bindless descriptors: {} textures, {} storage buffers", textureCount, bufferCount);
+    return true;
+}
+
+void VulkanBindlessHeap::shutdown()
+{
+    if (m_device == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    // Destroying the pool frees the set
+    vkDestroySampler(m_device, m_sampler, nullptr);
+    vkDestroyDescriptorPool(m_device, m_pool, nullptr);
+    vkDestroyDescriptorSetLayout(m_device, m_layout, nullptr);
+    m_sampler = VK_NULL_HANDLE;
+    m_pool = VK_NULL_HANDLE;
+    m_set = VK_NULL_HANDLE;
+    m_layout = VK_NULL_HANDLE;
+    m_textures = {};
+    m_buffers = {};
+    m_device = VK_NULL_HANDLE;
+}
+
+uint32_t VulkanBindlessHeap::addTexture(VkImageView view)
+{
+    uint32_t slot = m_textures.allocate();
+    if (slot == INVALID_BINDLESS_INDEX)
+    {
+        GN_ERROR("Bindless texture array is full ({} textures)", m_textures.capacity);
+        return slot;
+    }
+
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.sampler = m_sampler;
+    imageInfo.imageView = view;
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = m_set;
+    write.dstBinding = TEXTURE_BINDING;
+    write.dstArrayElement = slot;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.pImageInfo = &imageInfo;
+    vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+    return slot;
+}
+
+uint32_t VulkanBindlessHeap::addBuffer(VkBuffer buffer)
+{
+    uint32_t slot = m_buffers.allocate();
+    if (slot == INVALID_BINDLESS_INDEX)
+    {
+        GN_ERROR("Bindless buffer array is full ({} buffers)", m_buffers.capacity);
+        return slot;
+    }
+
+    VkDescriptorBufferInfo bufferInfo{};
+    bufferInfo.buffer = buffer;
+    bufferInfo.offset = 0;
+    bufferInfo.range = VK_WHOLE_SIZE;
+
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = m_set;
+    write.dstBinding = BUFFER_BINDING;
+    write.dstArrayElement = slot;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    write.pBufferInfo = &bufferInfo;
+    vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+    return slot;
+}
+
+void VulkanBindlessHeap::removeTexture(uint32_t index)
+{
+    // Partially bound arrays may keep the stale descriptor, it is never accessed until rewritten
+    m_textures.release(index);
+}
+
+void VulkanBindlessHeap::removeBuffer(uint32_t index)
+{
+    m_buffers.release(index);
+}
+
+uint32_t VulkanBindlessHeap::SlotAllocator::allocate()
+{
+    if (!freeSlots.empty())
+    {
+        uint32_t slot = freeSlots.back();
+        freeSlots.pop_back();
+        return slot;
+    }
+    return nextSlot < capacity ? nextSlot++ : INVALID_BINDLESS_INDEX;
+}
+
+void VulkanBindlessHeap::SlotAllocator::release(uint32_t slot)
+{
+    if (slot != INVALID_BINDLESS_INDEX)
+    {
+        freeSlots.push_back(slot);
+    }
+}
+
+} // namespace graphyne::graphics
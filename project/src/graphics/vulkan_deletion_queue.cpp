@@ -0,0 +1,184 @@
+#include "graphics/vulkan_deletion_queue.h"
+#include "utils/logger.h"
+
+namespace graphyne::graphics
+{
+
+VulkanDeletionQueue::~VulkanDeletionQueue()
+{
+    shutdown();
+}
+
+void VulkanDeletionQueue::initialize(VkDevice device, VulkanAllocator& allocator)
+{
+    m_device = device;
+    m_allocator = &allocator;
+    m_retireValue = 0;
+}
+
+void VulkanDeletionQueue::shutdown()
+{
+    if (m_device == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    flush();
+    m_freeBuckets.clear();
+    m_device = VK_NULL_HANDLE;
+    m_allocator = nullptr;
+}
+
+void VulkanDeletionQueue::setRetireValue(uint64_t value)
+{
+    if (value < m_retireValue)
+    {
+        GN_WARNING("Deletion queue retire value went back from {} to {}", m_retireValue, value);
+        return;
+    }
+    m_retireValue = value;
+}
+
+void VulkanDeletionQueue::destroyBuffer(VkBuffer buffer, VulkanAllocation& allocation)
+{
+    currentBucket().buffers.emplace_back(buffer, allocation);
+    allocation = VulkanAllocation{};
+    ++m_pendingCount;
+}
+
+void VulkanDeletionQueue::destroyImage(VkImage image, VulkanAllocation& allocation)
+{
+    currentBucket().images.emplace_back(image, allocation);
+    allocation = VulkanAllocation{};
+    ++m_pendingCount;
+}
+
+void VulkanDeletionQueue::free(VulkanAllocation& allocation)
+{
+    currentBucket().allocations.push_back(allocation);
+    allocation = VulkanAllocation{};
+    ++m_pendingCount;
+}
+
+void VulkanDeletionQueue::destroyImageView(VkImageView imageView)
+{
+    currentBucket().imageViews.push_back(imageView);
+    ++m_pendingCount;
+}
+
+void VulkanDeletionQueue::destroyFramebuffer(VkFramebuffer framebuffer)
+{
+    currentBucket().framebuffers.push_back(framebuffer);
+    ++m_pendingCount;
+}
+
+void VulkanDeletionQueue::destroyPipeline(VkPipeline pipeline)
+{
+    currentBucket().pipelines.push_back(pipeline);
+    ++m_pendingCount;
+}
+
+void VulkanDeletionQueue::destroyPipelineLayout(VkPipelineLayout pipelineLayout)
+{
+    currentBucket().pipelineLayouts.push_back(pipelineLayout);
+    ++m_pendingCount;
+}
+
+void VulkanDeletionQueue::destroyDescriptorPool(VkDescriptorPool descriptorPool)
+{
+    currentBucket().descriptorPools.push_back(descriptorPool);
+    ++m_pendingCount;
+}
+
+void VulkanDeletionQueue::defer(std::function<void()> release)
+{
+    currentBucket().callbacks.push_back(std::move(release));
+    ++m_pendingCount;
+}
+
+void VulkanDeletionQueue::collect(uint64_t completedValue)
+{
+    while (!m_buckets.empty() && m_buckets.front().value <= completedValue)
+    {
+        destroy(m_buckets.front());
+        m_freeBuckets.push_back(std::move(m_buckets.front()));
+        m_buckets.pop_front();
+    }
+}
+
+VulkanDeletionQueue::Bucket& VulkanDeletionQueue::currentBucket()
+{
+    if (!m_buckets.empty() && m_buckets.back().value == m_retireValue)
+    {
+        return m_buckets.back();
+    }
+
+    if (m_freeBuckets.empty())
+    {
+        m_buckets.emplace_back();
+    }
+    else
+    {
+        m_buckets.push_back(std::move(m_freeBuckets.back()));
+        m_freeBuckets.pop_back();
+    }
+    m_buckets.back().value = m_retireValue;
+    return m_buckets.back();
+}
+
+void VulkanDeletionQueue::destroy(Bucket& bucket)
+{
+    // Referencing objects first, so nothing outlives what it points to
+    for (VkFramebuffer framebuffer : bucket.framebuffers)
+    {
+        vkDestroyFramebuffer(m_device, framebuffer, nullptr);
+    }
+    for (VkPipeline pipeline : bucket.pipelines)
+    {
+        vkDestroyPipeline(m_device, pipeline, nullptr);
+    }
+    for (VkPipelineLayout pipelineLayout : bucket.pipelineLayouts)
+    {
+        vkDestroyPipelineLayout(m_device, pipelineLayout, nullptr);
+    }
+    for (VkDescriptorPool descriptorPool : bucket.descriptorPools)
+    {
+        vkDestroyDescriptorPool(m_device, descriptorPool, nullptr);
+    }
+    for (VkImageView imageView : bucket.imageViews)
+    {
+        vkDestroyImageView(m_device, imageView, nullptr);
+    }
+    for (auto& [image, allocation] : bucket.images)
+    {
+        m_allocator->destroyImage(image, allocation);
+    }
+    for (auto& [buffer, allocation] : bucket.buffers)
+    {
+        m_allocator->destroyBuffer(buffer, allocation);
+    }
+    for (VulkanAllocation& allocation : bucket.allocations)
+    {
+        m_allocator->free(allocation);
+    }
+    for (std::function<void()>& release : bucket.callbacks)
+    {
+        release();
+    }
+
+    m_pendingCount -= static_cast<uint32_t>(bucket.framebuffers.size() + bucket.pipelines.size() +
+                                            bucket.pipelineLayouts.size() + bucket.descriptorPools.size() +
+                                            bucket.imageViews.size() + bucket.images.size() + bucket.buffers.size() +
+                                            bucket.allocations.size() + bucket.callbacks.size());
+    bucket.framebuffers.clear();
+    bucket.pipelines.clear();
+    bucket.pipelineLayouts.clear();
+    bucket.descriptorPools.clear();
+    bucket.imageViews.clear();
+    bucket.images.clear();
+    bucket.buffers.clear();
+    bucket.allocations.clear();
+    bucket.callbacks.clear();
+}
+
+} // namespace graphyne::graphics
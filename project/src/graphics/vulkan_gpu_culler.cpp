@@ -0,0 +1,245 @@
+#include "graphics/vulkan_gpu_culler.h"
+#include "utils/logger.h"
+#include "utils/profiler.h"
+#include <array>
+#include <cstring>
+
+namespace graphyne::graphics
+{
+
+namespace
+{
+
+// SPIR-V of project/shaders/gpu_cull.comp, compiled at build time
+const uint32_t CULL_SHADER[] = {
+#include "gpu_cull.comp.spv.inc"
+};
+
+constexpr uint32_t CULL_GROUP_SIZE = 64;     // local_size_x of the shader
+constexpr uint32_t MAX_PASSES_PER_FRAME = 16; // Descriptor sets in the pool of each frame
+constexpr uint32_t BUFFER_BINDING_COUNT = 3;  // Objects, commands and counts
+
+// Push constants of the shader
+struct CullParams
+{
+    float frustumPlanes[6][4];
+    uint32_t objectCount;
+    uint32_t groupCount;
+    uint32_t maxDrawsPerGroup;
+};
+
+static_assert(sizeof(GpuCullObject) == 32, "GpuCullObject must match CullObject of gpu_cull.comp");
+static_assert(sizeof(DrawIndexedIndirectCommand) == sizeof(VkDrawIndexedIndirectCommand),
+              "DrawIndexedIndirectCommand must match VkDrawIndexedIndirectCommand");
+static_assert(sizeof(CullParams) <= 128, "Push constants are only guaranteed to hold 128 bytes");
+
+} // namespace
+
+VulkanGpuCuller::~VulkanGpuCuller()
+{
+    shutdown();
+}
+
+bool VulkanGpuCuller::initialize(VkDevice device,
+                                 const VulkanSync& sync,
+                                 VkPipelineCache pipelineCache,
+                                 uint32_t framesInFlight)
+{
+    m_device = device;
+    m_sync = &sync;
+
+    std::array<VkDescriptorSetLayoutBinding, BUFFER_BINDING_COUNT> bindings{};
+    for (uint32_t i = 0; i < BUFFER_BINDING_COUNT; ++i)
+    {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo setLayoutInfo{};
+    setLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    setLayoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    setLayoutInfo.pBindings = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(m_device, &setLayoutInfo, nullptr, &m_setLayout) != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to create culling descriptor set layout");
+        return false;
+    }
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(CullParams);
+
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = &m_setLayout;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(m_device, &layoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to create culling pipeline layout");
+        return false;
+    }
+
+    VkShaderModuleCreateInfo moduleInfo{};
+    moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    moduleInfo.codeSize = sizeof(CULL_SHADER);
+    moduleInfo.pCode = CULL_SHADER;
+
+    VkShaderModule shaderModule = VK_NULL_HANDLE;
+    if (vkCreateShaderModule(m_device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to create culling shader module");
+        return false;
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = shaderModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = m_pipelineLayout;
+
+    VkResult result = vkCreateComputePipelines(m_device, pipelineCache, 1, &pipelineInfo, nullptr, &m_pipeline);
+    vkDestroyShaderModule(m_device, shaderModule, nullptr);
+    if (result != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to create culling pipeline");
+        return false;
+    }
+
+    VkDescriptorPoolSize poolSize{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, MAX_PASSES_PER_FRAME * BUFFER_BINDING_COUNT};
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = MAX_PASSES_PER_FRAME;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+
+    m_descriptorPools.resize(framesInFlight, VK_NULL_HANDLE);
+    for (VkDescriptorPool& pool : m_descriptorPools)
+    {
+        if (vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &pool) != VK_SUCCESS)
+        {
+            GN_ERROR("Failed to create culling descriptor pool");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void VulkanGpuCuller::shutdown()
+{
+    if (m_device == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    for (VkDescriptorPool pool : m_descriptorPools)
+    {
+        vkDestroyDescriptorPool(m_device, pool, nullptr);
+    }
+    m_descriptorPools.clear();
+
+    vkDestroyPipeline(m_device, m_pipeline, nullptr);
+    vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr);
+    vkDestroyDescriptorSetLayout(m_device, m_setLayout, nullptr);
+    m_pipeline = VK_NULL_HANDLE;
+    m_pipelineLayout = VK_NULL_HANDLE;
+    m_setLayout = VK_NULL_HANDLE;
+    m_device = VK_NULL_HANDLE;
+    m_sync = nullptr;
+}
+
+void VulkanGpuCuller::beginFrame(uint32_t frame)
+{
+    if (frame < m_descriptorPools.size())
+    {
+        vkResetDescriptorPool(m_device, m_descriptorPools[frame], 0);
+    }
+}
+
+bool VulkanGpuCuller::record(VkCommandBuffer commandBuffer,
+                             uint32_t frame,
+                             VkBuffer objects,
+                             VkBuffer drawCommands,
+                             VkBuffer drawCounts,
+                             const GpuCullDesc& desc,
+                             RenderStats& stats)
+{
+    GN_PROFILE_SCOPE("VulkanGpuCuller::record");
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_descriptorPools[frame];
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &m_setLayout;
+
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    if (vkAllocateDescriptorSets(m_device, &allocInfo, &set) != VK_SUCCESS)
+    {
+        GN_ERROR("More than {} culling passes in one frame", MAX_PASSES_PER_FRAME);
+        return false;
+    }
+
+    std::array<VkDescriptorBufferInfo, BUFFER_BINDING_COUNT> bufferInfos = {
+        {{objects, 0, VK_WHOLE_SIZE}, {drawCommands, 0, VK_WHOLE_SIZE}, {drawCounts, 0, VK_WHOLE_SIZE}}};
+    std::array<VkWriteDescriptorSet, BUFFER_BINDING_COUNT> writes{};
+    for (uint32_t i = 0; i < BUFFER_BINDING_COUNT; ++i)
+    {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = set;
+        writes[i].dstBinding = i;
+        writes[i].descriptorCount = 1;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].pBufferInfo = &bufferInfos[i];
+    }
+    vkUpdateDescriptorSets(m_device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+
+    CullParams params;
+    std::memcpy(params.frustumPlanes, desc.frustumPlanes, sizeof(params.frustumPlanes));
+    params.objectCount = desc.objectCount;
+    params.groupCount = desc.groupCount;
+    params.maxDrawsPerGroup = desc.maxDrawsPerGroup;
+
+    // Indirect draws of earlier passes or frames may still read the outputs, only execution has to wait for them
+    m_sync->memoryBarrier(commandBuffer,
+                          VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
+                          VK_ACCESS_2_NONE,
+                          VK_PIPELINE_STAGE_2_TRANSFER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                          VK_ACCESS_2_NONE);
+    vkCmdFillBuffer(commandBuffer, drawCounts, 0, desc.groupCount * sizeof(uint32_t), 0);
+    m_sync->memoryBarrier(commandBuffer,
+                          VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                          VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                          VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                          VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
+    vkCmdBindDescriptorSets(
+        commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1, &set, 0, nullptr);
+    vkCmdPushConstants(
+        commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullParams), &params);
+    vkCmdDispatch(commandBuffer, (desc.objectCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+
+    m_sync->memoryBarrier(commandBuffer,
+                          VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                          VK_ACCESS_2_SHADER_WRITE_BIT,
+                          VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
+                          VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT);
+
+    ++stats.dispatches;
+    ++stats.pipelineBinds;
+    ++stats.descriptorBinds;
+    stats.barriers += 3;
+    return true;
+}
+
+} // namespace graphyne::graphics
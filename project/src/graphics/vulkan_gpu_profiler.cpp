@@ -0,0 +1,352 @@
+#include "graphics/vulkan_gpu_profiler.h"
+#include "utils/logger.h"
+#include <algorithm>
+
+namespace graphyne::graphics
+{
+
+namespace
+{
+
+constexpr uint32_t MAX_QUERIES_PER_FRAME = 512; // Two timestamps per scope
+constexpr uint64_t CALIBRATION_TIMEOUT = 1000000000ull;
+
+struct TrackSlice
+{
+    const char* name;
+    uint64_t end;
+};
+
+} // namespace
+
+VulkanGpuProfiler* VulkanGpuProfiler::s_active = nullptr;
+
+VulkanGpuProfiler::~VulkanGpuProfiler()
+{
+    shutdown();
+}
+
+bool VulkanGpuProfiler::initialize(VkPhysicalDevice physicalDevice,
+                                   VkDevice device,
+                                   VkQueue queue,
+                                   uint32_t queueFamily,
+                                   uint32_t framesInFlight)
+{
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, families.data());
+    if (queueFamily >= familyCount || families[queueFamily].timestampValidBits == 0)
+    {
+        GN_DEBUG("Queue family {} does not support timestamps", queueFamily);
+        return false;
+    }
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    m_timestampPeriod = properties.limits.timestampPeriod;
+    uint32_t validBits = families[queueFamily].timestampValidBits;
+    m_timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+    m_device = device;
+    m_frames.resize(framesInFlight);
+    for (Frame& frame : m_frames)
+    {
+        VkQueryPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        poolInfo.queryCount = MAX_QUERIES_PER_FRAME;
+        if (vkCreateQueryPool(m_device, &poolInfo, nullptr, &frame.queryPool) != VK_SUCCESS)
+        {
+            GN_ERROR("Failed to create timestamp query pool");
+            shutdown();
+            return false;
+        }
+    }
+
+    if (!calibrate(queue, queueFamily))
+    {
+        GN_ERROR("Failed to calibrate GPU timestamps");
+        shutdown();
+        return false;
+    }
+
+    m_track = utils::Profiler::getInstance().createTrack("GPU");
+    return true;
+}
+
+void VulkanGpuProfiler::shutdown()
+{
+    if (s_active == this)
+    {
+        s_active = nullptr;
+    }
+    if (m_device == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    for (Frame& frame : m_frames)
+    {
+        vkDestroyQueryPool(m_device, frame.queryPool, nullptr);
+    }
+    m_frames.clear();
+    m_current = nullptr;
+    m_openScopes.clear();
+    m_timings.clear();
+    m_device = VK_NULL_HANDLE;
+}
+
+bool VulkanGpuProfiler::calibrate(VkQueue queue, uint32_t queueFamily)
+{
+    // Without VK_EXT_calibrated_timestamps, a single timestamp written by a blocking submit is matched
+    // to the middle of the CPU interval around it. The error is bounded by the submit latency, which
+    // only shifts the GPU track against the CPU threads, durations are exact.
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = queueFamily;
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    VkFence fence = VK_NULL_HANDLE;
+    if (vkCreateFence(m_device, &fenceInfo, nullptr, &fence) != VK_SUCCESS)
+    {
+        vkDestroyCommandPool(m_device, commandPool, nullptr);
+        return false;
+    }
+
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = commandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    bool calibrated = false;
+    VkQueryPool queryPool = m_frames.front().queryPool;
+    if (vkAllocateCommandBuffers(m_device, &allocInfo, &commandBuffer) == VK_SUCCESS &&
+        vkBeginCommandBuffer(commandBuffer, &beginInfo) == VK_SUCCESS)
+    {
+        vkCmdResetQueryPool(commandBuffer, queryPool, 0, 1);
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, 0);
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &commandBuffer;
+
+        uint64_t before = utils::Profiler::now();
+        if (vkEndCommandBuffer(commandBuffer) == VK_SUCCESS &&
+            vkQueueSubmit(queue, 1, &submitInfo, fence) == VK_SUCCESS &&
+            vkWaitForFences(m_device, 1, &fence, VK_TRUE, CALIBRATION_TIMEOUT) == VK_SUCCESS)
+        {
+            uint64_t after = utils::Profiler::now();
+            uint64_t timestamp = 0;
+            if (vkGetQueryPoolResults(m_device,
+                                      queryPool,
+                                      0,
+                                      1,
+                                      sizeof(timestamp),
+                                      &timestamp,
+                                      sizeof(timestamp),
+                                      VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT) == VK_SUCCESS)
+            {
+                m_calibrationTimestamp = timestamp & m_timestampMask;
+                m_calibrationTime = before + (after - before) / 2;
+                m_lastTime = m_calibrationTime;
+                calibrated = true;
+            }
+        }
+    }
+
+    vkDestroyFence(m_device, fence, nullptr);
+    vkDestroyCommandPool(m_device, commandPool, nullptr);
+    return calibrated;
+}
+
+void VulkanGpuProfiler::beginFrame(VkCommandBuffer commandBuffer, uint32_t frame)
+{
+    m_current = nullptr;
+    m_openScopes.clear();
+    if (frame >= m_frames.size())
+    {
+        return;
+    }
+
+    Frame& current = m_frames[frame];
+    resolve(current);
+    current.scopes.clear();
+    current.queryCount = 0;
+    vkCmdResetQueryPool(commandBuffer, current.queryPool, 0, MAX_QUERIES_PER_FRAME);
+    m_current = &current;
+    m_overflowReported = false;
+}
+
+void VulkanGpuProfiler::beginScope(VkCommandBuffer commandBuffer, const char* name)
+{
+    if (!m_current)
+    {
+        return;
+    }
+
+    // Scopes past the pool size are dropped, still tracked so that their end pairs up
+    if (m_current->queryCount + 2 > MAX_QUERIES_PER_FRAME)
+    {
+        if (!m_overflowReported)
+        {
+            GN_WARNING("More than {} GPU scopes in a frame, the rest are not measured", MAX_QUERIES_PER_FRAME / 2);
+            m_overflowReported = true;
+        }
+        m_openScopes.push_back(INVALID_QUERY);
+        return;
+    }
+
+    Scope& scope = m_current->scopes.emplace_back();
+    scope.name = name;
+    scope.query = m_current->queryCount;
+    scope.depth = static_cast<uint32_t>(m_openScopes.size());
+    m_current->queryCount += 2;
+    m_openScopes.push_back(static_cast<uint32_t>(m_current->scopes.size() - 1));
+
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_current->queryPool, scope.query);
+}
+
+void VulkanGpuProfiler::endScope(VkCommandBuffer commandBuffer)
+{
+    if (!m_current || m_openScopes.empty())
+    {
+        return;
+    }
+
+    uint32_t index = m_openScopes.back();
+    m_openScopes.pop_back();
+    if (index != INVALID_QUERY)
+    {
+        vkCmdWriteTimestamp(commandBuffer,
+                            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                            m_current->queryPool,
+                            m_current->scopes[index].query + 1);
+    }
+}
+
+void VulkanGpuProfiler::resolve(Frame& frame)
+{
+    if (frame.scopes.empty())
+    {
+        return;
+    }
+
+    // The frame was waited on, so the results are available unless it was never
+    // submitted or a scope was left open, in which case the frame is dropped instead of waiting
+    m_results.resize(frame.queryCount);
+    VkResult result = vkGetQueryPoolResults(m_device,
+                                            frame.queryPool,
+                                            0,
+                                            frame.queryCount,
+                                            m_results.size() * sizeof(uint64_t),
+                                            m_results.data(),
+                                            sizeof(uint64_t),
+                                            VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS)
+    {
+        if (result != VK_NOT_READY)
+        {
+            GN_WARNING("Failed to read GPU timestamps ({})", static_cast<int>(result));
+        }
+        return;
+    }
+
+    utils::Profiler& profiler = utils::Profiler::getInstance();
+    bool tracing = profiler.isEnabled();
+    std::vector<TrackSlice> open;
+    auto closeSlice = [&]() {
+        m_lastTime = std::max(open.back().end, m_lastTime);
+        if (tracing)
+        {
+            profiler.recordTrackEvent(m_track, open.back().name, utils::ProfileEventType::End, m_lastTime);
+        }
+        open.pop_back();
+    };
+
+    m_timings.clear();
+    for (const Scope& scope : frame.scopes)
+    {
+        uint64_t begin = m_results[scope.query] & m_timestampMask;
+        uint64_t end = m_results[scope.query + 1] & m_timestampMask;
+        uint64_t ticks = (end - begin) & m_timestampMask;
+
+        GpuPassTiming& timing = m_timings.emplace_back();
+        timing.name = scope.name;
+        timing.depth = scope.depth;
+        timing.milliseconds = static_cast<double>(ticks) * m_timestampPeriod / 1.0e6;
+
+        // The trace needs properly nested slices in time order, even where the pipelined
+        // timestamps of consecutive scopes overlap
+        while (open.size() > scope.depth)
+        {
+            closeSlice();
+        }
+        uint64_t beginTime = std::max(toProfilerTime(begin), m_lastTime);
+        uint64_t endTime = std::max(toProfilerTime(end), beginTime);
+        if (!open.empty())
+        {
+            beginTime = std::min(beginTime, open.back().end);
+            endTime = std::min(endTime, open.back().end);
+        }
+        m_lastTime = beginTime;
+        if (tracing)
+        {
+            profiler.recordTrackEvent(m_track, scope.name, utils::ProfileEventType::Begin, beginTime);
+        }
+        open.push_back({scope.name, endTime});
+    }
+    while (!open.empty())
+    {
+        closeSlice();
+    }
+}
+
+uint64_t VulkanGpuProfiler::toProfilerTime(uint64_t timestamp) const
+{
+    // Ticks wrap around at timestampValidBits, count forward from the calibration
+    uint64_t ticks = (timestamp - m_calibrationTimestamp) & m_timestampMask;
+    return m_calibrationTime + static_cast<uint64_t>(static_cast<double>(ticks) * m_timestampPeriod);
+}
+
+GpuProfileScope::GpuProfileScope(VkCommandBuffer commandBuffer, const char* name)
+    : m_commandBuffer(commandBuffer), m_profiler(VulkanGpuProfiler::getActive())
+{
+    if (m_profiler)
+    {
+        m_profiler->beginScope(commandBuffer, name);
+    }
+}
+
+GpuProfileScope::GpuProfileScope(VkCommandBuffer commandBuffer, const std::string& name)
+    : m_commandBuffer(commandBuffer), m_profiler(VulkanGpuProfiler::getActive())
+{
+    if (m_profiler)
+    {
+        m_profiler->beginScope(commandBuffer, utils::Profiler::getInstance().internName(name));
+    }
+}
+
+GpuProfileScope::~GpuProfileScope()
+{
+    if (m_profiler)
+    {
+        m_profiler->endScope(m_commandBuffer);
+    }
+}
+
+} // namespace graphyne::graphics
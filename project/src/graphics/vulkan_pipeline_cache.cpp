@@ -0,0 +1,240 @@
+#include "graphics/vulkan_pipeline_cache.h"
+#include "utils/hash.h"
+#include "utils/logger.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace graphyne::graphics
+{
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+constexpr uint32_t FILE_MAGIC = 0x43504E47; // "GNPC"
+constexpr uint32_t FILE_VERSION = 1;
+
+// Prepended to the Vulkan cache data, the driver does not detect truncated or corrupted files on its own
+struct FileHeader
+{
+    uint32_t magic = FILE_MAGIC;
+    uint32_t version = FILE_VERSION;
+    uint64_t dataSize = 0;
+    uint64_t dataHash = 0;
+};
+
+} // namespace
+
+VulkanPipelineCache::~VulkanPipelineCache()
+{
+    shutdown();
+}
+
+bool VulkanPipelineCache::initialize(VkPhysicalDevice physicalDevice, VkDevice device, std::string path)
+{
+    m_device = device;
+    m_path = std::move(path);
+    vkGetPhysicalDeviceProperties(physicalDevice, &m_deviceProperties);
+
+    std::vector<uint8_t> data;
+    if (!m_path.empty() && loadFile(data) && !isCompatible(data))
+    {
+        GN_INFO("Pipeline cache {} was created for another device or driver, starting empty", m_path);
+        data.clear();
+    }
+
+    VkPipelineCacheCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    createInfo.initialDataSize = data.size();
+    createInfo.pInitialData = data.empty() ? nullptr : data.data();
+
+    if (vkCreatePipelineCache(m_device, &createInfo, nullptr, &m_cache) != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to create pipeline cache");
+        return false;
+    }
+
+    if (!data.empty())
+    {
+        GN_INFO("Loaded pipeline cache {} ({} bytes)", m_path, data.size());
+    }
+
+    m_dirty = false;
+    m_lastSave = std::chrono::steady_clock::now();
+    return true;
+}
+
+void VulkanPipelineCache::shutdown()
+{
+    if (m_cache == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    save();
+    core::JobSystem::getInstance().wait(m_pendingWrites);
+
+    vkDestroyPipelineCache(m_device, m_cache, nullptr);
+    m_cache = VK_NULL_HANDLE;
+    m_device = VK_NULL_HANDLE;
+}
+
+bool VulkanPipelineCache::save(bool async)
+{
+    // Cleared before the data is fetched, so compiles finishing meanwhile mark it dirty again.
+    // Every failure below sets it back, the next save retries
+    if (m_path.empty() || m_cache == VK_NULL_HANDLE || !m_dirty.exchange(false, std::memory_order_relaxed))
+    {
+        return true;
+    }
+    m_lastSave = std::chrono::steady_clock::now();
+
+    size_t dataSize = 0;
+    if (vkGetPipelineCacheData(m_device, m_cache, &dataSize, nullptr) != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to query pipeline cache size");
+        markDirty();
+        return false;
+    }
+
+    std::vector<uint8_t> file(sizeof(FileHeader) + dataSize);
+    uint8_t* data = file.data() + sizeof(FileHeader);
+    if (vkGetPipelineCacheData(m_device, m_cache, &dataSize, data) != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to retrieve pipeline cache data");
+        markDirty();
+        return false;
+    }
+    file.resize(sizeof(FileHeader) + dataSize);
+
+    FileHeader header;
+    header.dataSize = dataSize;
+    header.dataHash = utils::hash64(data, dataSize);
+    std::memcpy(file.data(), &header, sizeof(header));
+
+    // A newer save must not be overtaken by an older one still being written
+    core::JobSystem& jobSystem = core::JobSystem::getInstance();
+    jobSystem.wait(m_pendingWrites);
+
+    if (!async)
+    {
+        if (!writeFile(m_path, file))
+        {
+            markDirty();
+            return false;
+        }
+        return true;
+    }
+
+    // Disk I/O stays off the frame path, shutdown() waits for the write before the cache is destroyed
+    jobSystem.submit(
+        [this, path = m_path, file = std::move(file)]() {
+            if (!writeFile(path, file))
+            {
+                markDirty();
+            }
+        },
+        &m_pendingWrites,
+        core::JobSystem::Priority::Background);
+    return true;
+}
+
+void VulkanPipelineCache::saveIfDue(std::chrono::steady_clock::duration interval)
+{
+    // Called from the render thread, a save still being written is not waited for but retried next time
+    if (m_dirty.load(std::memory_order_relaxed) && m_pendingWrites.isDone() &&
+        std::chrono::steady_clock::now() - m_lastSave >= interval)
+    {
+        save(true);
+    }
+}
+
+bool VulkanPipelineCache::loadFile(std::vector<uint8_t>& data) const
+{
+    std::ifstream file(m_path, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    std::vector<uint8_t> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    FileHeader header;
+    if (contents.size() < sizeof(header))
+    {
+        GN_WARNING("Pipeline cache {} is truncated, ignoring it", m_path);
+        return false;
+    }
+    std::memcpy(&header, contents.data(), sizeof(header));
+
+    const uint8_t* payload = contents.data() + sizeof(header);
+    if (header.magic != FILE_MAGIC || header.version != FILE_VERSION ||
+        header.dataSize != contents.size() - sizeof(header) ||
+        header.dataHash != utils::hash64(payload, static_cast<size_t>(header.dataSize)))
+    {
+        GN_WARNING("Pipeline cache {} is corrupted or outdated, ignoring it", m_path);
+        return false;
+    }
+
+    data.assign(payload, payload + header.dataSize);
+    return true;
+}
+
+bool VulkanPipelineCache::isCompatible(const std::vector<uint8_t>& data) const
+{
+    VkPipelineCacheHeaderVersionOne header;
+    if (data.size() < sizeof(header))
+    {
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    // The UUID changes with the driver version, so stale caches of an updated driver are rejected too
+    return header.headerSize >= sizeof(header) && header.headerSize <= data.size() &&
+           header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           header.vendorID == m_deviceProperties.vendorID && header.deviceID == m_deviceProperties.deviceID &&
+           std::memcmp(header.pipelineCacheUUID, m_deviceProperties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+bool VulkanPipelineCache::writeFile(const std::string& path, const std::vector<uint8_t>& data)
+{
+    fs::path tempPath = path + ".tmp";
+    std::error_code error;
+    if (fs::path(path).has_parent_path())
+    {
+        fs::create_directories(fs::path(path).parent_path(), error);
+    }
+
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            GN_ERROR("Failed to open pipeline cache for writing: {}", tempPath.string());
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!file.good())
+        {
+            file.close();
+            fs::remove(tempPath, error);
+            GN_ERROR("Failed to write pipeline cache: {}", tempPath.string());
+            return false;
+        }
+    }
+
+    fs::rename(tempPath, path, error);
+    if (error)
+    {
+        fs::remove(tempPath, error);
+        GN_ERROR("Failed to commit pipeline cache: {}", path);
+        return false;
+    }
+
+    GN_DEBUG("Saved pipeline cache {} ({} bytes)", path, data.size());
+    return true;
+}
+
+} // namespace graphyne::graphics
@@ -1,13 +1,176 @@
 #include "graphics/vulkan_renderer.h"
 #include "platform/window.h"
 #include "utils/logger.h"
+#include "utils/profiler.h"
+#include <SDL2/SDL_vulkan.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <set>
 #include <stdexcept>
 
 namespace graphyne::graphics
 {
 
-VulkanRenderer::VulkanRenderer(platform::Window& window, const Config& config) : Renderer(window, config) {}
+namespace
+{
+
+// Newest Vulkan version whose core features the backend uses
+constexpr uint32_t MAX_API_VERSION = VK_API_VERSION_1_2;
+
+// Results are written in bit order, matching the fields of PipelineStatistics
+constexpr VkQueryPipelineStatisticFlags PIPELINE_STATISTICS =
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+constexpr uint32_t PIPELINE_STATISTIC_COUNT = 5;
+
+VkFormat toVkFormat(VertexFormat format)
+{
+    switch (format)
+    {
+        case VertexFormat::Float:
+            return VK_FORMAT_R32_SFLOAT;
+        case VertexFormat::Float2:
+            return VK_FORMAT_R32G32_SFLOAT;
+        case VertexFormat::Float3:
+            return VK_FORMAT_R32G32B32_SFLOAT;
+        case VertexFormat::Float4:
+            return VK_FORMAT_R32G32B32A32_SFLOAT;
+        case VertexFormat::Unorm8x4:
+            return VK_FORMAT_R8G8B8A8_UNORM;
+    }
+    return VK_FORMAT_UNDEFINED;
+}
+
+VkFormat toVkFormat(TextureFormat format)
+{
+    switch (format)
+    {
+        case TextureFormat::Rgba8Unorm:
+            return VK_FORMAT_R8G8B8A8_UNORM;
+        case TextureFormat::Rgba8Srgb:
+            return VK_FORMAT_R8G8B8A8_SRGB;
+        case TextureFormat::Rgba16Float:
+            return VK_FORMAT_R16G16B16A16_SFLOAT;
+        case TextureFormat::Bc1Unorm:
+            return VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+        case TextureFormat::Bc1Srgb:
+            return VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+        case TextureFormat::Bc3Unorm:
+            return VK_FORMAT_BC3_UNORM_BLOCK;
+        case TextureFormat::Bc3Srgb:
+            return VK_FORMAT_BC3_SRGB_BLOCK;
+        case TextureFormat::Bc5Unorm:
+            return VK_FORMAT_BC5_UNORM_BLOCK;
+        case TextureFormat::Bc7Unorm:
+            return VK_FORMAT_BC7_UNORM_BLOCK;
+        case TextureFormat::Bc7Srgb:
+            return VK_FORMAT_BC7_SRGB_BLOCK;
+    }
+    return VK_FORMAT_UNDEFINED;
+}
+
+VkBufferUsageFlags toVkBufferUsage(BufferUsage usage)
+{
+    // Device local buffers are filled through copies
+    VkBufferUsageFlags flags = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    if (hasUsage(usage, BufferUsage::Vertex))
+    {
+        flags |= VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+    }
+    if (hasUsage(usage, BufferUsage::Index))
+    {
+        flags |= VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+    }
+    if (hasUsage(usage, BufferUsage::Uniform))
+    {
+        flags |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    }
+    if (hasUsage(usage, BufferUsage::Storage))
+    {
+        flags |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    }
+    if (hasUsage(usage, BufferUsage::Indirect))
+    {
+        flags |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+    }
+    return flags;
+}
+
+const char* getDeviceTypeName(VkPhysicalDeviceType type)
+{
+    switch (type)
+    {
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+            return "discrete";
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+            return "integrated";
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+            return "virtual";
+        case VK_PHYSICAL_DEVICE_TYPE_CPU:
+            return "CPU";
+        default:
+            return "other";
+    }
+}
+
+const char* getPresentModeName(VkPresentModeKHR mode)
+{
+    switch (mode)
+    {
+        case VK_PRESENT_MODE_IMMEDIATE_KHR:
+            return "immediate";
+        case VK_PRESENT_MODE_MAILBOX_KHR:
+            return "mailbox";
+        case VK_PRESENT_MODE_FIFO_KHR:
+            return "vsync";
+        default:
+            return "other";
+    }
+}
+
+VkPrimitiveTopology toVkTopology(PrimitiveTopology topology)
+{
+    switch (topology)
+    {
+        case PrimitiveTopology::TriangleList:
+            return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        case PrimitiveTopology::TriangleStrip:
+            return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+        case PrimitiveTopology::LineList:
+            return VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+        case PrimitiveTopology::PointList:
+            return VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+    }
+    return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+}
+
+// Describes a semaphore operation of a submission, the value is ignored for binary semaphores
+VkSemaphoreSubmitInfo makeSemaphoreInfo(VkSemaphore semaphore, uint64_t value, VkPipelineStageFlags2 stages)
+{
+    VkSemaphoreSubmitInfo info{};
+    info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+    info.semaphore = semaphore;
+    info.value = value;
+    info.stageMask = stages;
+    return info;
+}
+
+// Adds the counters a command recorder tracks
+void accumulate(RenderStats& total, const RenderStats& recorder)
+{
+    total.drawCalls += recorder.drawCalls;
+    total.indirectDrawCalls += recorder.indirectDrawCalls;
+    total.triangles += recorder.triangles;
+    total.pipelineBinds += recorder.pipelineBinds;
+    total.descriptorBinds += recorder.descriptorBinds;
+}
+
+} // namespace
+
+VulkanRenderer::VulkanRenderer(platform::Window* window, const Config& config) : Renderer(window, config) {}
 
 VulkanRenderer::~VulkanRenderer()
 {
@@ -16,6 +179,12 @@ VulkanRenderer::~VulkanRenderer()
 
 bool VulkanRenderer::initialize()
 {
+    if (!m_window && !isOffscreen())
+    {
+        GN_ERROR("Vulkan renderer requires a window unless it renders offscreen");
+        return false;
+    }
+
     if (!createInstance())
     {
         GN_ERROR("Failed to create Vulkan instance");
@@ -28,7 +197,8 @@ bool VulkanRenderer::initialize()
         return false;
     }
 
-    if (!createSurface())
+    // Offscreen rendering has no surface at all, so it also works without a display
+    if (!isOffscreen() && !createSurface())
     {
         GN_ERROR("Failed to create surface");
         return false;
@@ -46,20 +216,143 @@ bool VulkanRenderer::initialize()
         return false;
     }
 
-    if (!createSwapChain())
+    if (!m_allocator.initialize(m_physicalDevice, m_device))
+    {
+        GN_ERROR("Failed to initialize device memory allocator");
+        return false;
+    }
+    m_deletionQueue.initialize(m_device, m_allocator);
+    m_deletionQueue.setRetireValue(m_frameIndex + 1);
+
+    if (!initializeUploader())
+    {
+        GN_ERROR("Failed to initialize resource uploads");
+        return false;
+    }
+
+    if (!m_pipelineCache.initialize(m_physicalDevice, m_device, m_config.pipelineCachePath))
+    {
+        GN_ERROR("Failed to create pipeline cache");
+        return false;
+    }
+
+    if (m_bindless && !createBindlessLayout())
+    {
+        GN_ERROR("Failed to create bindless descriptors");
+        return false;
+    }
+
+    // Draws submitted from the CPU keep working without GPU culling
+    if (m_gpuCulling &&
+        !m_gpuCuller.initialize(
+            m_device, m_sync, m_pipelineCache.getHandle(), std::max(1u, m_config.framesInFlight)))
+    {
+        GN_WARNING("Failed to create the GPU culling pipeline, GPU culling is disabled");
+        m_gpuCuller.shutdown();
+        m_gpuCulling = false;
+    }
+
+    // Timings are optional, rendering works the same without them
+    if (m_gpuProfiler.initialize(m_physicalDevice,
+                                 m_device,
+                                 m_graphicsQueue,
+                                 m_graphicsQueueFamily,
+                                 std::max(1u, m_config.framesInFlight)))
+    {
+        VulkanGpuProfiler::setActive(&m_gpuProfiler);
+    }
+    else
+    {
+        GN_WARNING("GPU timestamps are not supported, GPU pass timings are disabled");
+    }
+
+    m_renderGraph.initialize(m_device, m_allocator, m_sync, m_deletionQueue);
+
+    if (isOffscreen())
+    {
+        if (!createRenderPass() || !createOffscreenTarget() || !createReadbackBuffers())
+        {
+            GN_ERROR("Failed to create offscreen render target");
+            return false;
+        }
+    }
+    else if (!createSwapChain() || !createRenderPass())
     {
         GN_ERROR("Failed to create swap chain");
         return false;
     }
 
-    GN_INFO("Vulkan renderer initialized successfully");
+    if (!createFrameResources())
+    {
+        GN_ERROR("Failed to create frame resources");
+        return false;
+    }
+
+    GN_INFO("Vulkan renderer initialized successfully{}", isOffscreen() ? " (offscreen)" : "");
     return true;
 }
 
 void VulkanRenderer::shutdown()
 {
+    if (m_device != VK_NULL_HANDLE)
+    {
+        m_uploader.waitIdle();
+        vkDeviceWaitIdle(m_device);
+        m_deletionQueue.flush();
+    }
+
+    for (auto& [id, pipeline] : m_pipelines)
+    {
+        core::JobSystem::getInstance().wait(pipeline->compileJob);
+        vkDestroyPipeline(m_device, pipeline->pipeline, nullptr);
+        destroyPipelineLayout(pipeline->layout);
+    }
+    m_pipelines.clear();
+    m_immediateRecorder.reset();
+    m_renderGraph.shutdown();
+
+    for (auto& [id, texture] : m_textures)
+    {
+        vkDestroyImageView(m_device, texture.view, nullptr);
+        m_allocator.destroyImage(texture.image, texture.allocation);
+    }
+    m_textures.clear();
+    for (auto& [id, buffer] : m_buffers)
+    {
+        m_allocator.destroyBuffer(buffer.buffer, buffer.allocation);
+    }
+    m_buffers.clear();
+
+    if (m_bindlessPipelineLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyPipelineLayout(m_device, m_bindlessPipelineLayout, nullptr);
+        m_bindlessPipelineLayout = VK_NULL_HANDLE;
+    }
+    m_bindlessHeap.shutdown();
+    m_gpuCuller.shutdown();
+    m_gpuProfiler.shutdown();
+
+    destroyFrameResources();
+    destroyReadbackBuffers();
+    destroyOffscreenTarget();
     cleanupSwapChain();
 
+    if (m_renderPass != VK_NULL_HANDLE)
+    {
+        vkDestroyRenderPass(m_device, m_renderPass, nullptr);
+        m_renderPass = VK_NULL_HANDLE;
+    }
+
+    m_pipelineCache.shutdown();
+    m_uploader.shutdown();
+    m_deletionQueue.shutdown();
+    if (m_frameTimeline != VK_NULL_HANDLE)
+    {
+        vkDestroySemaphore(m_device, m_frameTimeline, nullptr);
+        m_frameTimeline = VK_NULL_HANDLE;
+    }
+    m_allocator.shutdown();
+
     if (m_device != VK_NULL_HANDLE)
     {
         vkDestroyDevice(m_device, nullptr);
@@ -92,223 +385,2485 @@ void VulkanRenderer::shutdown()
 
 void VulkanRenderer::beginFrame()
 {
-    // TODO: Implement frame begin
-}
+    GN_PROFILE_SCOPE("VulkanRenderer::beginFrame");
 
-void VulkanRenderer::endFrame()
-{
-    // TODO: Implement frame end
-}
+    // Nothing submitted to a lost device executes, rendering stops until the renderer is shut down
+    if (m_deviceLost)
+    {
+        return;
+    }
 
-void VulkanRenderer::waitIdle()
-{
-    vkDeviceWaitIdle(m_device);
-}
+    FrameData& frame = m_frames[m_currentFrame];
 
-void VulkanRenderer::onResize(int width, int height)
-{
-    m_framebufferResized = true;
-}
+    // Only blocks when the CPU is more than framesInFlight frames ahead of the GPU
+    m_sync.wait(m_frameTimeline, frame.timelineValue);
+    if (m_deletionQueue.getPendingCount() > 0)
+    {
+        m_deletionQueue.collect(getCompletedFrames());
+    }
 
-bool VulkanRenderer::createInstance()
-{
-    VkApplicationInfo appInfo{};
-    appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
-    appInfo.pApplicationName = m_config.appName.c_str();
-    appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
-    appInfo.pEngineName = "Graphyne";
-    appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-    appInfo.apiVersion = VK_API_VERSION_1_0;
+    if (!isOffscreen())
+    {
+        destroyRetiredSwapChains(false);
 
-    VkInstanceCreateInfo createInfo{};
-    createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
-    createInfo.pApplicationInfo = &appInfo;
+        // Recreated before acquiring, so the retired swapchain is only used by frames already submitted
+        if (m_framebufferResized)
+        {
+            if (!recreateSwapChain())
+            {
+                // The frame is skipped, nothing was submitted for the slot
+                return;
+            }
+            m_framebufferResized = false;
+        }
 
-    auto extensions = getRequiredExtensions();
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
-    createInfo.ppEnabledExtensionNames = extensions.data();
+        VkResult result = vkAcquireNextImageKHR(
+            m_device, m_swapChain, UINT64_MAX, frame.imageAvailable, VK_NULL_HANDLE, &m_imageIndex);
+        if (result == VK_ERROR_OUT_OF_DATE_KHR && recreateSwapChain())
+        {
+            result = vkAcquireNextImageKHR(
+                m_device, m_swapChain, UINT64_MAX, frame.imageAvailable, VK_NULL_HANDLE, &m_imageIndex);
+        }
+        if (result == VK_ERROR_OUT_OF_DATE_KHR)
+        {
+            m_framebufferResized = true;
+            return;
+        }
+        if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+        {
+            GN_ERROR("Failed to acquire swap chain image");
+            return;
+        }
+    }
 
-    VkDebugUtilsMessengerCreateInfoEXT debugCreateInfo{};
-    if (m_config.enableValidation)
+    vkResetCommandPool(m_device, frame.commandPool, 0);
+    for (ThreadCommandPool& pool : frame.threadPools)
     {
-        if (!checkValidationLayerSupport())
+        if (pool.usedCount > 0)
         {
-            GN_ERROR("Validation layers requested but not available");
-            return false;
+            vkResetCommandPool(m_device, pool.commandPool, 0);
+            pool.usedCount = 0;
         }
-
-        createInfo.enabledLayerCount = static_cast<uint32_t>(m_validationLayers.size());
-        createInfo.ppEnabledLayerNames = m_validationLayers.data();
-
-        debugCreateInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
-        debugCreateInfo.messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT |
-                                          VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT |
-                                          VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
-        debugCreateInfo.messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT |
-                                      VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT |
-                                      VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
-        debugCreateInfo.pfnUserCallback = debugCallback;
-        debugCreateInfo.pUserData = nullptr;
-
-        createInfo.pNext = &debugCreateInfo;
     }
-    else
+    frame.secondaryCommandBuffers.clear();
+    m_uploader.collect();
+    if (m_gpuCulling)
     {
-        createInfo.enabledLayerCount = 0;
-        createInfo.pNext = nullptr;
+        m_gpuCuller.beginFrame(m_currentFrame);
     }
 
-    if (vkCreateInstance(&createInfo, nullptr, &m_instance) != VK_SUCCESS)
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if (vkBeginCommandBuffer(frame.commandBuffer, &beginInfo) != VK_SUCCESS)
     {
-        GN_ERROR("Failed to create Vulkan instance");
-        return false;
+        GN_ERROR("Failed to begin command buffer");
+        return;
     }
 
-    return true;
-}
-
-bool VulkanRenderer::setupDebugMessenger()
-{
-    VkDebugUtilsMessengerCreateInfoEXT createInfo{};
-    createInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
-    createInfo.messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT |
-                                 VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT |
-                                 VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
-    createInfo.messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT |
-                             VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT |
-                             VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
-    createInfo.pfnUserCallback = debugCallback;
-    createInfo.pUserData = nullptr;
-
-    auto func = (PFN_vkCreateDebugUtilsMessengerEXT)vkGetInstanceProcAddr(m_instance, "vkCreateDebugUtilsMessengerEXT");
-    if (func == nullptr)
+    m_gpuProfiler.beginFrame(frame.commandBuffer, m_currentFrame);
+    m_gpuProfiler.beginScope(frame.commandBuffer, "Frame");
+    if (m_pipelineStatistics)
     {
-        GN_ERROR("Failed to load vkCreateDebugUtilsMessengerEXT");
-        return false;
+        resolvePipelineStatistics(m_currentFrame);
+        vkCmdResetQueryPool(frame.commandBuffer, frame.statisticsQuery, 0, 1);
+        vkCmdBeginQuery(frame.commandBuffer, frame.statisticsQuery, 0, 0);
     }
 
-    if (func(m_instance, &createInfo, nullptr, &m_debugMessenger) != VK_SUCCESS)
-    {
-        GN_ERROR("Failed to setup debug messenger");
-        return false;
-    }
+    m_renderGraph.reset();
+    addScenePass();
 
-    return true;
+    m_frameStarted = true;
 }
 
-bool VulkanRenderer::checkValidationLayerSupport()
+void VulkanRenderer::endFrame()
 {
-    uint32_t layerCount;
-    vkEnumerateInstanceLayerProperties(&layerCount, nullptr);
+    GN_PROFILE_SCOPE("VulkanRenderer::endFrame");
 
-    std::vector<VkLayerProperties> availableLayers(layerCount);
-    vkEnumerateInstanceLayerProperties(&layerCount, availableLayers.data());
-
-    for (const char* layerName : m_validationLayers)
+    if (!m_frameStarted)
     {
-        bool layerFound = false;
+        return;
+    }
 
-        for (const auto& layerProperties : availableLayers)
+    FrameData& frame = m_frames[m_currentFrame];
+    closeImmediateRecorder();
+
+    std::optional<uint32_t> readbackSlot;
+    if (m_readbackRequested)
+    {
+        for (uint32_t i = 0; i < m_readbacks.size(); ++i)
         {
-            if (strcmp(layerName, layerProperties.layerName) == 0)
+            if (!m_readbacks[i].pending)
             {
-                layerFound = true;
+                readbackSlot = i;
+                m_renderGraph
+                    .addPass("readback",
+                             [this, i](VkCommandBuffer commandBuffer, const RenderGraph&) {
+                                 recordReadback(commandBuffer, i);
+                             })
+                    .read(m_backbuffer, ResourceUsage::TransferSrc)
+                    .setSideEffects();
                 break;
             }
         }
-
-        if (!layerFound)
-        {
-            return false;
-        }
+        m_readbackRequested = false;
     }
 
-    return true;
-}
-
-std::vector<const char*> VulkanRenderer::getRequiredExtensions()
-{
-    std::vector<const char*> extensions;
-
-    // Get required extensions from window
-    auto windowExtensions = m_window.getRequiredExtensions();
-    extensions.insert(extensions.end(), windowExtensions.begin(), windowExtensions.end());
-
-    if (m_config.enableValidation)
+    if (m_renderGraph.compile())
     {
-        extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+        m_renderGraph.execute(frame.commandBuffer);
+        m_frameStats.barriers += m_renderGraph.getStats().barrierCount;
+    }
+    else
+    {
+        GN_ERROR("Failed to compile the render graph, the frame is left empty");
+        readbackSlot.reset();
     }
 
-    return extensions;
-}
+    if (m_pipelineStatistics)
+    {
+        vkCmdEndQuery(frame.commandBuffer, frame.statisticsQuery, 0);
+        frame.statisticsPending = true;
+        frame.statisticsFrame = m_frameIndex;
+    }
+    m_gpuProfiler.endScope(frame.commandBuffer);
+    bool recorded = vkEndCommandBuffer(frame.commandBuffer) == VK_SUCCESS;
+    if (!recorded)
+    {
+        GN_ERROR("Failed to record command buffer");
+    }
 
-bool VulkanRenderer::pickPhysicalDevice()
-{
-    uint32_t deviceCount = 0;
-    vkEnumeratePhysicalDevices(m_instance, &deviceCount, nullptr);
+    // Uploads recorded during the frame go out first, on the graphics queue submission order makes them visible
+    uint64_t uploadValue = m_uploader.flush();
+    finishFrameStats();
 
-    if (deviceCount == 0)
+    std::array<VkSemaphoreSubmitInfo, 2> waitInfos{};
+    std::array<VkSemaphoreSubmitInfo, 2> signalInfos{};
+    uint32_t waitCount = 0;
+    uint32_t signalCount = 0;
+    if (!isOffscreen())
     {
-        GN_ERROR("Failed to find GPUs with Vulkan support");
-        return false;
+        waitInfos[waitCount++] =
+            makeSemaphoreInfo(frame.imageAvailable, 0, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT);
+        signalInfos[signalCount++] =
+            makeSemaphoreInfo(m_renderFinishedSemaphores[m_imageIndex], 0, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+    }
+    if (m_uploader.isDedicated())
+    {
+        waitInfos[waitCount++] =
+            makeSemaphoreInfo(m_uploader.getSemaphore(), uploadValue, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
     }
+    signalInfos[signalCount++] =
+        makeSemaphoreInfo(m_frameTimeline, m_frameIndex + 1, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
 
-    std::vector<VkPhysicalDevice> devices(deviceCount);
-    vkEnumeratePhysicalDevices(m_instance, &deviceCount, devices.data());
+    VkCommandBufferSubmitInfo commandBufferInfo{};
+    commandBufferInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+    commandBufferInfo.commandBuffer = frame.commandBuffer;
 
-    for (const auto& device : devices)
+    VkSubmitInfo2 submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+    submitInfo.waitSemaphoreInfoCount = waitCount;
+    submitInfo.pWaitSemaphoreInfos = waitInfos.data();
+    submitInfo.commandBufferInfoCount = 1;
+    submitInfo.pCommandBufferInfos = &commandBufferInfo;
+    submitInfo.signalSemaphoreInfoCount = signalCount;
+    submitInfo.pSignalSemaphoreInfos = signalInfos.data();
+
+    // A failed submission leaves the slot free, later frames signal higher values than it would have
+    bool submitted = false;
+    if (recorded)
     {
-        if (isDeviceSuitable(device))
+        VkResult result = m_sync.submit(m_graphicsQueue, submitInfo);
+        submitted = result == VK_SUCCESS;
+        if (submitted)
         {
+            frame.timelineValue = m_frameIndex + 1;
+        }
+        else if (result == VK_ERROR_DEVICE_LOST)
+        {
+            GN_ERROR("Device lost while submitting frame {}, rendering stops", m_frameIndex);
+            m_deviceLost = true;
+        }
+        else
+        {
+            GN_ERROR("Failed to submit frame");
+        }
+    }
+
+    // The copy is part of the frame, it is done once the frame timeline passed the frame
+    if (readbackSlot && submitted)
+    {
+        Readback& readback = m_readbacks[*readbackSlot];
+        readback.pending = true;
+        readback.frameIndex = m_frameIndex;
+    }
+
+    // Without the submission nothing signals the render finished semaphore, presenting would wait forever
+    if (!isOffscreen() && !submitted && !m_deviceLost)
+    {
+        recoverFromFailedSubmit(m_currentFrame);
+    }
+    else if (!isOffscreen() && submitted)
+    {
+        VkPresentInfoKHR presentInfo{};
+        presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+        presentInfo.waitSemaphoreCount = 1;
+        presentInfo.pWaitSemaphores = &m_renderFinishedSemaphores[m_imageIndex];
+        presentInfo.swapchainCount = 1;
+        presentInfo.pSwapchains = &m_swapChain;
+        presentInfo.pImageIndices = &m_imageIndex;
+
+        VkResult result = vkQueuePresentKHR(m_presentQueue, &presentInfo);
+        if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
+        {
+            m_framebufferResized = true;
+        }
+        else if (result == VK_ERROR_DEVICE_LOST)
+        {
+            GN_ERROR("Device lost while presenting frame {}, rendering stops", m_frameIndex);
+            m_deviceLost = true;
+        }
+        else if (result != VK_SUCCESS)
+        {
+            GN_ERROR("Failed to present swap chain image");
+        }
+    }
+
+    if (m_config.pipelineCacheSaveInterval > 0.0)
+    {
+        auto interval = std::chrono::duration<double>(m_config.pipelineCacheSaveInterval);
+        m_pipelineCache.saveIfDue(std::chrono::duration_cast<std::chrono::steady_clock::duration>(interval));
+    }
+
+    m_frameStarted = false;
+    m_currentFrame = (m_currentFrame + 1) % static_cast<uint32_t>(m_frames.size());
+    ++m_frameIndex;
+    m_deletionQueue.setRetireValue(m_frameIndex + 1);
+}
+
+void VulkanRenderer::waitIdle()
+{
+    if (m_device != VK_NULL_HANDLE)
+    {
+        m_uploader.waitIdle();
+        vkDeviceWaitIdle(m_device);
+        m_deletionQueue.flush();
+    }
+}
+
+void VulkanRenderer::onResize(int width, int height)
+{
+    m_framebufferResized = true;
+}
+
+bool VulkanRenderer::requestReadback()
+{
+    if (!isOffscreen())
+    {
+        GN_WARNING("Readback is only available in offscreen mode");
+        return false;
+    }
+
+    for (const Readback& readback : m_readbacks)
+    {
+        if (!readback.pending)
+        {
+            m_readbackRequested = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool VulkanRenderer::pollReadback(std::vector<uint8_t>& pixels, uint32_t& width, uint32_t& height)
+{
+    Readback* oldest = nullptr;
+    for (Readback& readback : m_readbacks)
+    {
+        if (readback.pending && (!oldest || readback.frameIndex < oldest->frameIndex))
+        {
+            oldest = &readback;
+        }
+    }
+
+    if (!oldest || oldest->frameIndex >= getCompletedFrames())
+    {
+        return false;
+    }
+
+    width = m_config.width;
+    height = m_config.height;
+    size_t size = static_cast<size_t>(width) * height * 4;
+    pixels.resize(size);
+    m_allocator.invalidate(oldest->memory);
+    std::memcpy(pixels.data(), oldest->memory.mapped, size);
+
+    oldest->pending = false;
+    return true;
+}
+
+BufferHandle VulkanRenderer::createBuffer(const BufferDesc& desc, const void* initialData)
+{
+    if (desc.size == 0)
+    {
+        GN_ERROR("Buffer {} has a size of 0", desc.debugName);
+        return {};
+    }
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = desc.size;
+    bufferInfo.usage = toVkBufferUsage(desc.usage);
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    // Written by the transfer queue and read by the graphics queue without ownership transfers
+    std::array<uint32_t, 2> queueFamilies = {m_graphicsQueueFamily, m_transferQueueFamily};
+    if (m_uploader.isDedicated())
+    {
+        bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufferInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilies.size());
+        bufferInfo.pQueueFamilyIndices = queueFamilies.data();
+    }
+
+    BufferData data;
+    data.size = desc.size;
+    data.usage = desc.usage;
+    data.createdFrame = m_frameIndex;
+    MemoryUsage memoryUsage = desc.hostVisible ? MemoryUsage::CpuToGpu : MemoryUsage::GpuOnly;
+    if (!m_allocator.createBuffer(bufferInfo, memoryUsage, data.buffer, data.allocation))
+    {
+        GN_ERROR("Failed to create buffer {}", desc.debugName);
+        return {};
+    }
+
+    if (m_bindless && hasUsage(desc.usage, BufferUsage::Storage))
+    {
+        data.bindlessIndex = m_bindlessHeap.addBuffer(data.buffer);
+    }
+
+    BufferHandle handle{m_nextHandleId++};
+    m_buffers[handle.id] = data;
+
+    if (initialData)
+    {
+        updateBuffer(handle, initialData, desc.size);
+    }
+    return handle;
+}
+
+void VulkanRenderer::updateBuffer(BufferHandle buffer, const void* data, size_t size, size_t offset)
+{
+    auto it = m_buffers.find(buffer.id);
+    if (it == m_buffers.end() || !data || offset + size > it->second.size)
+    {
+        GN_ERROR("updateBuffer called with an invalid buffer or range");
+        return;
+    }
+
+    // Host visible buffers are written in place, the caller keeps frames in flight from reading the range
+    const BufferData& target = it->second;
+    if (target.allocation.mapped)
+    {
+        std::memcpy(static_cast<uint8_t*>(target.allocation.mapped) + offset, data, size);
+        m_allocator.flush(target.allocation, offset, size);
+        return;
+    }
+
+    waitForFramesUsing(target.createdFrame);
+    if (!m_uploader.uploadBuffer(target.buffer, offset, data, size))
+    {
+        GN_ERROR("Failed to upload {} bytes to buffer", size);
+    }
+}
+
+void VulkanRenderer::destroyBuffer(BufferHandle buffer)
+{
+    auto it = m_buffers.find(buffer.id);
+    if (it == m_buffers.end())
+    {
+        return;
+    }
+
+    // Frames in flight and pending uploads may still use the buffer and its descriptor slot
+    uint32_t bindlessIndex = it->second.bindlessIndex;
+    m_deletionQueue.destroyBuffer(it->second.buffer, it->second.allocation);
+    if (bindlessIndex != INVALID_BINDLESS_INDEX)
+    {
+        m_deletionQueue.defer([this, bindlessIndex]() { m_bindlessHeap.removeBuffer(bindlessIndex); });
+    }
+    m_buffers.erase(it);
+}
+
+TextureHandle VulkanRenderer::createTexture(const TextureDesc& desc)
+{
+    if (desc.width == 0 || desc.height == 0 || desc.mipLevels == 0 ||
+        desc.mipLevels > getFullMipCount(desc.width, desc.height))
+    {
+        GN_ERROR("Texture {} has an invalid size or mip count", desc.debugName);
+        return {};
+    }
+    if (isCompressed(desc.format) && !m_enabledFeatures.textureCompressionBC)
+    {
+        GN_ERROR("Texture {} is block compressed, which the device does not support", desc.debugName);
+        return {};
+    }
+
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = toVkFormat(desc.format);
+    imageInfo.extent = {desc.width, desc.height, 1};
+    imageInfo.mipLevels = desc.mipLevels;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    std::array<uint32_t, 2> queueFamilies = {m_graphicsQueueFamily, m_transferQueueFamily};
+    if (m_uploader.isDedicated())
+    {
+        imageInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        imageInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilies.size());
+        imageInfo.pQueueFamilyIndices = queueFamilies.data();
+    }
+
+    TextureData data;
+    data.desc = desc;
+    data.createdFrame = m_frameIndex;
+    if (!m_allocator.createImage(imageInfo, MemoryUsage::GpuOnly, data.image, data.allocation))
+    {
+        GN_ERROR("Failed to create texture {}", desc.debugName);
+        return {};
+    }
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = data.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = imageInfo.format;
+    viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, desc.mipLevels, 0, 1};
+
+    // Textures stay in SHADER_READ_ONLY_OPTIMAL outside of uploads, so they can be sampled at any time
+    if (vkCreateImageView(m_device, &viewInfo, nullptr, &data.view) != VK_SUCCESS ||
+        !m_uploader.initializeImage(data.image, desc.mipLevels))
+    {
+        GN_ERROR("Failed to initialize texture {}", desc.debugName);
+        vkDestroyImageView(m_device, data.view, nullptr);
+        m_allocator.destroyImage(data.image, data.allocation);
+        return {};
+    }
+
+    if (m_bindless)
+    {
+        data.bindlessIndex = m_bindlessHeap.addTexture(data.view);
+    }
+
+    TextureHandle handle{m_nextHandleId++};
+    m_textures[handle.id] = data;
+    return handle;
+}
+
+void VulkanRenderer::updateTexture(TextureHandle texture, uint32_t mipLevel, const void* data, size_t size)
+{
+    auto it = m_textures.find(texture.id);
+    if (it == m_textures.end() || !data || mipLevel >= it->second.desc.mipLevels)
+    {
+        GN_ERROR("updateTexture called with an invalid texture or mip level");
+        return;
+    }
+
+    const TextureDesc& desc = it->second.desc;
+    size_t expectedSize =
+        getMipSize(desc.format, std::max(1u, desc.width >> mipLevel), std::max(1u, desc.height >> mipLevel));
+    if (size != expectedSize)
+    {
+        GN_ERROR("updateTexture data size {} does not match the mip level size {}", size, expectedSize);
+        return;
+    }
+
+    VkExtent3D extent = {std::max(1u, desc.width >> mipLevel), std::max(1u, desc.height >> mipLevel), 1};
+    waitForFramesUsing(it->second.createdFrame);
+    if (!m_uploader.uploadImage(it->second.image, mipLevel, extent, data, size))
+    {
+        GN_ERROR("Failed to upload mip level {} of texture {}", mipLevel, desc.debugName);
+    }
+}
+
+void VulkanRenderer::destroyTexture(TextureHandle texture)
+{
+    auto it = m_textures.find(texture.id);
+    if (it == m_textures.end())
+    {
+        return;
+    }
+
+    // Frames in flight and pending uploads may still use the texture and its descriptor slot
+    uint32_t bindlessIndex = it->second.bindlessIndex;
+    m_deletionQueue.destroyImageView(it->second.view);
+    m_deletionQueue.destroyImage(it->second.image, it->second.allocation);
+    if (bindlessIndex != INVALID_BINDLESS_INDEX)
+    {
+        m_deletionQueue.defer([this, bindlessIndex]() { m_bindlessHeap.removeTexture(bindlessIndex); });
+    }
+    m_textures.erase(it);
+}
+
+uint32_t VulkanRenderer::getBindlessIndex(TextureHandle texture) const
+{
+    auto it = m_textures.find(texture.id);
+    return it != m_textures.end() ? it->second.bindlessIndex : INVALID_BINDLESS_INDEX;
+}
+
+uint32_t VulkanRenderer::getBindlessIndex(BufferHandle buffer) const
+{
+    auto it = m_buffers.find(buffer.id);
+    return it != m_buffers.end() ? it->second.bindlessIndex : INVALID_BINDLESS_INDEX;
+}
+
+bool VulkanRenderer::initializeUploader()
+{
+    VulkanUploader::QueueInfo queue{m_graphicsQueue, m_graphicsQueueFamily, false};
+    if (m_transferQueue != VK_NULL_HANDLE)
+    {
+        queue = {m_transferQueue, m_transferQueueFamily, true};
+    }
+
+    return m_uploader.initialize(m_device, m_allocator, m_sync, queue, m_config.uploadBufferSize);
+}
+
+void VulkanRenderer::waitForFramesUsing(uint64_t createdFrame)
+{
+    // On the graphics queue the upload is ordered after earlier frames, a transfer queue has to wait for them
+    if (m_uploader.isDedicated() && createdFrame < m_frameIndex)
+    {
+        m_uploader.waitForGraphics(m_frameTimeline, m_frameIndex);
+    }
+}
+
+PipelineHandle VulkanRenderer::createPipeline(const PipelineDesc& desc)
+{
+    if (desc.vertexShader.empty() || desc.fragmentShader.empty())
+    {
+        GN_ERROR("Pipeline {} is missing shader code", desc.debugName);
+        return {};
+    }
+
+    auto data = std::make_unique<PipelineData>();
+    data->pushConstantSize = desc.pushConstantSize;
+    data->topology = desc.topology;
+    data->fallback = desc.fallback;
+    PipelineData* pipeline = data.get();
+
+    PipelineHandle handle{m_nextHandleId++};
+    m_pipelines[handle.id] = std::move(data);
+
+    if (!m_config.asyncPipelineCompilation)
+    {
+        if (!compilePipeline(desc, *pipeline))
+        {
+            m_pipelines.erase(handle.id);
+            return {};
+        }
+        return handle;
+    }
+
+    // Until the job has finished, draws with the pipeline use its fallback or are skipped. Background priority
+    // keeps compiles behind the recording jobs of the frames
+    core::JobSystem::getInstance().submit([this, pipeline, desc]() { compilePipeline(desc, *pipeline); },
+                                          &pipeline->compileJob,
+                                          core::JobSystem::Priority::Background);
+    return handle;
+}
+
+bool VulkanRenderer::compilePipeline(const PipelineDesc& desc, PipelineData& data)
+{
+    GN_PROFILE_SCOPE("VulkanRenderer::compilePipeline");
+
+    if (m_bindless)
+    {
+        if (desc.pushConstantSize > MAX_BINDLESS_PUSH_CONSTANT_SIZE)
+        {
+            GN_ERROR("Pipeline {} uses {} bytes of push constants, bindless pipelines are limited to {}",
+                     desc.debugName,
+                     desc.pushConstantSize,
+                     MAX_BINDLESS_PUSH_CONSTANT_SIZE);
+            data.state.store(PipelineState::Failed, std::memory_order_release);
+            return false;
+        }
+        data.layout = m_bindlessPipelineLayout;
+    }
+    else
+    {
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = desc.pushConstantSize;
+
+        VkPipelineLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        layoutInfo.pushConstantRangeCount = desc.pushConstantSize > 0 ? 1 : 0;
+        layoutInfo.pPushConstantRanges = &pushConstantRange;
+
+        if (vkCreatePipelineLayout(m_device, &layoutInfo, nullptr, &data.layout) != VK_SUCCESS)
+        {
+            GN_ERROR("Failed to create pipeline layout for {}", desc.debugName);
+            data.state.store(PipelineState::Failed, std::memory_order_release);
+            return false;
+        }
+    }
+
+    VkShaderModule vertexModule = createShaderModule(desc.vertexShader);
+    VkShaderModule fragmentModule = createShaderModule(desc.fragmentShader);
+    if (vertexModule == VK_NULL_HANDLE || fragmentModule == VK_NULL_HANDLE)
+    {
+        GN_ERROR("Failed to create shader modules for {}", desc.debugName);
+        vkDestroyShaderModule(m_device, vertexModule, nullptr);
+        vkDestroyShaderModule(m_device, fragmentModule, nullptr);
+        destroyPipelineLayout(data.layout);
+        data.layout = VK_NULL_HANDLE;
+        data.state.store(PipelineState::Failed, std::memory_order_release);
+        return false;
+    }
+
+    std::array<VkPipelineShaderStageCreateInfo, 2> stages{};
+    stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    stages[0].module = vertexModule;
+    stages[0].pName = "main";
+    stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    stages[1].module = fragmentModule;
+    stages[1].pName = "main";
+
+    VkVertexInputBindingDescription binding{};
+    binding.binding = 0;
+    binding.stride = desc.vertexStride;
+    binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    std::vector<VkVertexInputAttributeDescription> attributes;
+    for (const VertexAttribute& attribute : desc.vertexAttributes)
+    {
+        attributes.push_back({attribute.location, 0, toVkFormat(attribute.format), attribute.offset});
+    }
+
+    VkPipelineVertexInputStateCreateInfo vertexInput{};
+    vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInput.vertexBindingDescriptionCount = desc.vertexStride > 0 ? 1 : 0;
+    vertexInput.pVertexBindingDescriptions = &binding;
+    vertexInput.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributes.size());
+    vertexInput.pVertexAttributeDescriptions = attributes.data();
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = toVkTopology(desc.topology);
+
+    VkPipelineViewportStateCreateInfo viewportState{};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    VkPipelineRasterizationStateCreateInfo rasterizer{};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.cullMode = VK_CULL_MODE_NONE;
+    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rasterizer.lineWidth = 1.0f;
+
+    VkPipelineMultisampleStateCreateInfo multisampling{};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkPipelineColorBlendAttachmentState blendAttachment{};
+    blendAttachment.colorWriteMask =
+        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    if (desc.alphaBlend)
+    {
+        blendAttachment.blendEnable = VK_TRUE;
+        blendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        blendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        blendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+        blendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        blendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        blendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+    }
+
+    VkPipelineColorBlendStateCreateInfo colorBlending{};
+    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlending.attachmentCount = 1;
+    colorBlending.pAttachments = &blendAttachment;
+
+    std::array<VkDynamicState, 2> dynamicStates = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+    VkPipelineDynamicStateCreateInfo dynamicState{};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+    dynamicState.pDynamicStates = dynamicStates.data();
+
+    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = static_cast<uint32_t>(stages.size());
+    pipelineInfo.pStages = stages.data();
+    pipelineInfo.pVertexInputState = &vertexInput;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = data.layout;
+    pipelineInfo.renderPass = m_renderPass;
+    pipelineInfo.subpass = 0;
+
+    VkResult result = vkCreateGraphicsPipelines(
+        m_device, m_pipelineCache.getHandle(), 1, &pipelineInfo, nullptr, &data.pipeline);
+
+    // Modules are only needed during pipeline creation
+    vkDestroyShaderModule(m_device, vertexModule, nullptr);
+    vkDestroyShaderModule(m_device, fragmentModule, nullptr);
+
+    if (result != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to create pipeline {}", desc.debugName);
+        destroyPipelineLayout(data.layout);
+        data.layout = VK_NULL_HANDLE;
+        data.state.store(PipelineState::Failed, std::memory_order_release);
+        return false;
+    }
+
+    m_pipelineCache.markDirty();
+    data.state.store(PipelineState::Ready, std::memory_order_release);
+    return true;
+}
+
+void VulkanRenderer::destroyPipeline(PipelineHandle pipeline)
+{
+    auto it = m_pipelines.find(pipeline.id);
+    if (it == m_pipelines.end())
+    {
+        return;
+    }
+
+    // The compile job writes into the pipeline data
+    core::JobSystem::getInstance().wait(it->second->compileJob);
+
+    // Destroyed once the frames that bound the pipeline have executed
+    m_deletionQueue.destroyPipeline(it->second->pipeline);
+    if (it->second->layout != m_bindlessPipelineLayout)
+    {
+        m_deletionQueue.destroyPipelineLayout(it->second->layout);
+    }
+    m_pipelines.erase(it);
+
+    if (m_immediateRecorder)
+    {
+        m_immediateRecorder->resetBindings();
+    }
+}
+
+void VulkanRenderer::destroyPipelineLayout(VkPipelineLayout layout)
+{
+    // Bindless pipelines share one layout, destroyed at shutdown
+    if (layout != m_bindlessPipelineLayout)
+    {
+        vkDestroyPipelineLayout(m_device, layout, nullptr);
+    }
+}
+
+bool VulkanRenderer::isPipelineReady(PipelineHandle pipeline) const
+{
+    auto it = m_pipelines.find(pipeline.id);
+    return it != m_pipelines.end() && it->second->state.load(std::memory_order_acquire) == PipelineState::Ready;
+}
+
+void VulkanRenderer::bindPipeline(PipelineHandle pipeline)
+{
+    if (SecondaryRecorder* recorder = getImmediateRecorder())
+    {
+        recorder->bindPipeline(pipeline);
+    }
+}
+
+void VulkanRenderer::bindVertexBuffer(BufferHandle buffer, size_t offset)
+{
+    if (SecondaryRecorder* recorder = getImmediateRecorder())
+    {
+        recorder->bindVertexBuffer(buffer, offset);
+    }
+}
+
+void VulkanRenderer::bindIndexBuffer(BufferHandle buffer, IndexType type, size_t offset)
+{
+    if (SecondaryRecorder* recorder = getImmediateRecorder())
+    {
+        recorder->bindIndexBuffer(buffer, type, offset);
+    }
+}
+
+void VulkanRenderer::pushConstants(const void* data, uint32_t size, uint32_t offset)
+{
+    if (SecondaryRecorder* recorder = getImmediateRecorder())
+    {
+        recorder->pushConstants(data, size, offset);
+    }
+}
+
+void VulkanRenderer::draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
+{
+    if (SecondaryRecorder* recorder = getImmediateRecorder())
+    {
+        recorder->draw(vertexCount, instanceCount, firstVertex, firstInstance);
+    }
+}
+
+void VulkanRenderer::drawIndexed(uint32_t indexCount,
+                                 uint32_t instanceCount,
+                                 uint32_t firstIndex,
+                                 int32_t vertexOffset,
+                                 uint32_t firstInstance)
+{
+    if (SecondaryRecorder* recorder = getImmediateRecorder())
+    {
+        recorder->drawIndexed(indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+    }
+}
+
+void VulkanRenderer::drawIndexedIndirectCount(BufferHandle commands,
+                                              size_t offset,
+                                              BufferHandle count,
+                                              size_t countOffset,
+                                              uint32_t maxDrawCount)
+{
+    if (SecondaryRecorder* recorder = getImmediateRecorder())
+    {
+        recorder->drawIndexedIndirectCount(commands, offset, count, countOffset, maxDrawCount);
+    }
+}
+
+void VulkanRenderer::cullDraws(const GpuCullDesc& desc)
+{
+    if (!m_frameStarted)
+    {
+        return;
+    }
+    if (!m_gpuCulling)
+    {
+        GN_ERROR("cullDraws called, but GPU culling is not supported by the device");
+        return;
+    }
+
+    auto objects = m_buffers.find(desc.objects.id);
+    auto commands = m_buffers.find(desc.drawCommands.id);
+    auto counts = m_buffers.find(desc.drawCounts.id);
+    auto isStorage = [this](auto it, size_t size) {
+        return it != m_buffers.end() && hasUsage(it->second.usage, BufferUsage::Storage) && size <= it->second.size;
+    };
+    size_t commandCount = static_cast<size_t>(desc.groupCount) * desc.maxDrawsPerGroup;
+    if (desc.groupCount == 0 || !isStorage(objects, desc.objectCount * sizeof(GpuCullObject)) ||
+        !isStorage(commands, commandCount * sizeof(DrawIndexedIndirectCommand)) ||
+        !isStorage(counts, desc.groupCount * sizeof(uint32_t)))
+    {
+        GN_ERROR("cullDraws called with invalid or too small storage buffers");
+        return;
+    }
+
+    // Recorded into the primary command buffer, ahead of the render graph and its secondary command buffers
+    VkCommandBuffer commandBuffer = m_frames[m_currentFrame].commandBuffer;
+    GN_GPU_SCOPE(commandBuffer, "GPU culling");
+    m_gpuCuller.record(commandBuffer,
+                       m_currentFrame,
+                       objects->second.buffer,
+                       commands->second.buffer,
+                       counts->second.buffer,
+                       desc,
+                       m_frameStats);
+}
+
+void VulkanRenderer::recordParallel(uint32_t count, uint32_t batchSize, const RecordJob& job)
+{
+    GN_PROFILE_SCOPE("VulkanRenderer::recordParallel");
+
+    if (!m_frameStarted || count == 0)
+    {
+        return;
+    }
+
+    // Draws issued before the recording execute before it
+    closeImmediateRecorder();
+
+    core::JobSystem& jobSystem = core::JobSystem::getInstance();
+    if (batchSize == 0)
+    {
+        // A few batches per thread balance the load, more only add secondary command buffer overhead
+        uint32_t batchCount = (jobSystem.getWorkerCount() + 1) * 2;
+        batchSize = std::max(1u, (count + batchCount - 1) / batchCount);
+    }
+
+    uint32_t batchCount = (count + batchSize - 1) / batchSize;
+    std::vector<VkCommandBuffer> commandBuffers(batchCount, VK_NULL_HANDLE);
+    std::vector<RenderStats> batchStats(batchCount);
+
+    // Each batch records into a command buffer from the pool of the thread running it. The batches are normal
+    // priority jobs, taken before queued compiles, and the wait at the end only runs batches of this call
+    jobSystem.parallelFor(batchCount, 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t batch = begin; batch < end; ++batch)
+        {
+            VkCommandBuffer commandBuffer = beginSecondaryCommandBuffer();
+            if (commandBuffer == VK_NULL_HANDLE)
+            {
+                continue;
+            }
+
+            SecondaryRecorder recorder(*this, commandBuffer);
+            uint32_t first = batch * batchSize;
+            job(recorder, first, std::min(count, first + batchSize));
+            batchStats[batch] = recorder.getStats();
+
+            if (vkEndCommandBuffer(commandBuffer) == VK_SUCCESS)
+            {
+                commandBuffers[batch] = commandBuffer;
+            }
+        }
+    });
+
+    // Stitch the batches in item order, whichever thread recorded them
+    std::vector<VkCommandBuffer>& secondaries = m_frames[m_currentFrame].secondaryCommandBuffers;
+    for (uint32_t batch = 0; batch < batchCount; ++batch)
+    {
+        if (commandBuffers[batch] != VK_NULL_HANDLE)
+        {
+            secondaries.push_back(commandBuffers[batch]);
+            accumulate(m_frameStats, batchStats[batch]);
+        }
+    }
+}
+
+VkCommandBuffer VulkanRenderer::beginSecondaryCommandBuffer()
+{
+    FrameData& frame = m_frames[m_currentFrame];
+    uint32_t threadIndex = core::JobSystem::getCurrentThreadIndex();
+    if (threadIndex >= frame.threadPools.size())
+    {
+        GN_ERROR("No command pool for thread {}, the job system was resized after renderer initialization",
+                 threadIndex);
+        return VK_NULL_HANDLE;
+    }
+
+    ThreadCommandPool& pool = frame.threadPools[threadIndex];
+    if (pool.usedCount == pool.commandBuffers.size())
+    {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = pool.commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        if (vkAllocateCommandBuffers(m_device, &allocInfo, &commandBuffer) != VK_SUCCESS)
+        {
+            GN_ERROR("Failed to allocate secondary command buffer");
+            return VK_NULL_HANDLE;
+        }
+        pool.commandBuffers.push_back(commandBuffer);
+    }
+    VkCommandBuffer commandBuffer = pool.commandBuffers[pool.usedCount++];
+
+    VkCommandBufferInheritanceInfo inheritanceInfo{};
+    inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritanceInfo.renderPass = m_renderPass;
+    inheritanceInfo.subpass = 0;
+    // The framebuffer is only known once the render graph is compiled at the end of the frame
+    inheritanceInfo.framebuffer = VK_NULL_HANDLE;
+    inheritanceInfo.pipelineStatistics = m_pipelineStatistics ? PIPELINE_STATISTICS : 0;
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    beginInfo.pInheritanceInfo = &inheritanceInfo;
+    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to begin secondary command buffer");
+        return VK_NULL_HANDLE;
+    }
+
+    // Viewport and scissor are dynamic, so pipelines survive swapchain resizes. Secondary
+    // command buffers don't inherit dynamic state, every one of them has to set it.
+    VkExtent2D extent = getRenderExtent();
+    VkViewport viewport{};
+    viewport.width = static_cast<float>(extent.width);
+    viewport.height = static_cast<float>(extent.height);
+    viewport.maxDepth = 1.0f;
+    VkRect2D scissor{{0, 0}, extent};
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+    // Pipelines share the bindless layout, so the set stays bound for every draw of the command buffer
+    if (m_bindless)
+    {
+        VkDescriptorSet set = m_bindlessHeap.getSet();
+        vkCmdBindDescriptorSets(
+            commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_bindlessPipelineLayout, 0, 1, &set, 0, nullptr);
+    }
+
+    return commandBuffer;
+}
+
+VulkanRenderer::SecondaryRecorder* VulkanRenderer::getImmediateRecorder()
+{
+    if (!m_frameStarted)
+    {
+        return nullptr;
+    }
+
+    if (!m_immediateRecorder)
+    {
+        VkCommandBuffer commandBuffer = beginSecondaryCommandBuffer();
+        if (commandBuffer == VK_NULL_HANDLE)
+        {
+            return nullptr;
+        }
+        m_immediateRecorder.emplace(*this, commandBuffer);
+    }
+    return &*m_immediateRecorder;
+}
+
+void VulkanRenderer::closeImmediateRecorder()
+{
+    if (!m_immediateRecorder)
+    {
+        return;
+    }
+
+    VkCommandBuffer commandBuffer = m_immediateRecorder->getCommandBuffer();
+    if (vkEndCommandBuffer(commandBuffer) == VK_SUCCESS)
+    {
+        m_frames[m_currentFrame].secondaryCommandBuffers.push_back(commandBuffer);
+        accumulate(m_frameStats, m_immediateRecorder->getStats());
+    }
+    else
+    {
+        GN_ERROR("Failed to record secondary command buffer");
+    }
+    m_immediateRecorder.reset();
+}
+
+const VulkanRenderer::PipelineData* VulkanRenderer::resolvePipeline(PipelineHandle pipeline) const
+{
+    // A pipeline still compiling is replaced by its fallback, without one the draws are skipped
+    auto it = m_pipelines.find(pipeline.id);
+    if (it == m_pipelines.end())
+    {
+        return nullptr;
+    }
+    if (it->second->state.load(std::memory_order_acquire) == PipelineState::Ready)
+    {
+        return it->second.get();
+    }
+    if (isPipelineReady(it->second->fallback))
+    {
+        return m_pipelines.at(it->second->fallback.id).get();
+    }
+    return nullptr;
+}
+
+void VulkanRenderer::SecondaryRecorder::bindPipeline(PipelineHandle pipeline)
+{
+    if (m_boundPipeline == pipeline)
+    {
+        return;
+    }
+    m_boundPipeline = pipeline;
+
+    const PipelineData* active = m_renderer.resolvePipeline(pipeline);
+    if (active && active != m_activePipeline)
+    {
+        vkCmdBindPipeline(m_commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, active->pipeline);
+        ++m_stats.pipelineBinds;
+    }
+    m_activePipeline = active;
+}
+
+void VulkanRenderer::SecondaryRecorder::bindVertexBuffer(BufferHandle buffer, size_t offset)
+{
+    auto it = m_renderer.m_buffers.find(buffer.id);
+    if (it == m_renderer.m_buffers.end())
+    {
+        GN_ERROR("bindVertexBuffer called with an invalid buffer");
+        return;
+    }
+
+    VkDeviceSize bufferOffset = offset;
+    vkCmdBindVertexBuffers(m_commandBuffer, 0, 1, &it->second.buffer, &bufferOffset);
+}
+
+void VulkanRenderer::SecondaryRecorder::bindIndexBuffer(BufferHandle buffer, IndexType type, size_t offset)
+{
+    auto it = m_renderer.m_buffers.find(buffer.id);
+    if (it == m_renderer.m_buffers.end())
+    {
+        GN_ERROR("bindIndexBuffer called with an invalid buffer");
+        return;
+    }
+
+    VkIndexType indexType = type == IndexType::Uint16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    vkCmdBindIndexBuffer(m_commandBuffer, it->second.buffer, offset, indexType);
+}
+
+void VulkanRenderer::SecondaryRecorder::pushConstants(const void* data, uint32_t size, uint32_t offset)
+{
+    if (!m_activePipeline)
+    {
+        return;
+    }
+
+    // A fallback pipeline may have a smaller push constant range than the pipeline it replaces
+    if (offset + size > m_activePipeline->pushConstantSize)
+    {
+        if (m_activePipeline == m_renderer.m_pipelines.at(m_boundPipeline.id).get())
+        {
+            GN_ERROR("Push constants exceed the pipeline's push constant size");
+        }
+        return;
+    }
+
+    vkCmdPushConstants(m_commandBuffer,
+                       m_activePipeline->layout,
+                       VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                       offset,
+                       size,
+                       data);
+}
+
+void VulkanRenderer::SecondaryRecorder::draw(uint32_t vertexCount,
+                                             uint32_t instanceCount,
+                                             uint32_t firstVertex,
+                                             uint32_t firstInstance)
+{
+    if (!m_activePipeline)
+    {
+        return;
+    }
+
+    vkCmdDraw(m_commandBuffer, vertexCount, instanceCount, firstVertex, firstInstance);
+    ++m_stats.drawCalls;
+    m_stats.triangles += getTriangleCount(m_activePipeline->topology, vertexCount) * instanceCount;
+}
+
+void VulkanRenderer::SecondaryRecorder::drawIndexed(uint32_t indexCount,
+                                                    uint32_t instanceCount,
+                                                    uint32_t firstIndex,
+                                                    int32_t vertexOffset,
+                                                    uint32_t firstInstance)
+{
+    if (!m_activePipeline)
+    {
+        return;
+    }
+
+    vkCmdDrawIndexed(m_commandBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+    ++m_stats.drawCalls;
+    m_stats.triangles += getTriangleCount(m_activePipeline->topology, indexCount) * instanceCount;
+}
+
+void VulkanRenderer::SecondaryRecorder::drawIndexedIndirectCount(BufferHandle commands,
+                                                                 size_t offset,
+                                                                 BufferHandle count,
+                                                                 size_t countOffset,
+                                                                 uint32_t maxDrawCount)
+{
+    if (!m_activePipeline)
+    {
+        return;
+    }
+    if (!m_renderer.m_gpuCulling)
+    {
+        GN_ERROR("drawIndexedIndirectCount is not supported by the device");
+        return;
+    }
+
+    auto commandsIt = m_renderer.m_buffers.find(commands.id);
+    auto countIt = m_renderer.m_buffers.find(count.id);
+    if (commandsIt == m_renderer.m_buffers.end() || countIt == m_renderer.m_buffers.end())
+    {
+        GN_ERROR("drawIndexedIndirectCount called with an invalid buffer");
+        return;
+    }
+
+    m_renderer.m_cmdDrawIndexedIndirectCount(m_commandBuffer,
+                                             commandsIt->second.buffer,
+                                             offset,
+                                             countIt->second.buffer,
+                                             countOffset,
+                                             maxDrawCount,
+                                             sizeof(DrawIndexedIndirectCommand));
+    ++m_stats.indirectDrawCalls;
+}
+
+void VulkanRenderer::SecondaryRecorder::resetBindings()
+{
+    m_boundPipeline = {};
+    m_activePipeline = nullptr;
+}
+
+bool VulkanRenderer::createInstance()
+{
+    VkApplicationInfo appInfo{};
+    appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+    appInfo.pApplicationName = m_config.appName.c_str();
+    appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
+    appInfo.pEngineName = "Graphyne";
+    appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
+
+    // 1.0 loaders reject newer versions and lack vkEnumerateInstanceVersion
+    m_apiVersion = VK_API_VERSION_1_0;
+    auto enumerateInstanceVersion =
+        (PFN_vkEnumerateInstanceVersion)vkGetInstanceProcAddr(nullptr, "vkEnumerateInstanceVersion");
+    if (enumerateInstanceVersion != nullptr && enumerateInstanceVersion(&m_apiVersion) != VK_SUCCESS)
+    {
+        m_apiVersion = VK_API_VERSION_1_0;
+    }
+    m_apiVersion = std::min(m_apiVersion, MAX_API_VERSION);
+    appInfo.apiVersion = m_apiVersion;
+
+    VkInstanceCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+    createInfo.pApplicationInfo = &appInfo;
+
+    auto extensions = getRequiredExtensions();
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+    createInfo.ppEnabledExtensionNames = extensions.data();
+
+    VkDebugUtilsMessengerCreateInfoEXT debugCreateInfo{};
+    if (m_config.enableValidation)
+    {
+        if (!checkValidationLayerSupport())
+        {
+            GN_ERROR("Validation layers requested but not available");
+            return false;
+        }
+
+        createInfo.enabledLayerCount = static_cast<uint32_t>(m_validationLayers.size());
+        createInfo.ppEnabledLayerNames = m_validationLayers.data();
+
+        debugCreateInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
+        debugCreateInfo.messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT |
+                                          VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT |
+                                          VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
+        debugCreateInfo.messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT |
+                                      VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT |
+                                      VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
+        debugCreateInfo.pfnUserCallback = debugCallback;
+        debugCreateInfo.pUserData = nullptr;
+
+        createInfo.pNext = &debugCreateInfo;
+    }
+    else
+    {
+        createInfo.enabledLayerCount = 0;
+        createInfo.pNext = nullptr;
+    }
+
+    if (vkCreateInstance(&createInfo, nullptr, &m_instance) != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to create Vulkan instance");
+        return false;
+    }
+
+    return true;
+}
+
+bool VulkanRenderer::setupDebugMessenger()
+{
+    VkDebugUtilsMessengerCreateInfoEXT createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
+    createInfo.messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT |
+                                 VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT |
+                                 VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
+    createInfo.messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT |
+                             VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT |
+                             VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
+    createInfo.pfnUserCallback = debugCallback;
+    createInfo.pUserData = nullptr;
+
+    auto func = (PFN_vkCreateDebugUtilsMessengerEXT)vkGetInstanceProcAddr(m_instance, "vkCreateDebugUtilsMessengerEXT");
+    if (func == nullptr)
+    {
+        GN_ERROR("Failed to load vkCreateDebugUtilsMessengerEXT");
+        return false;
+    }
+
+    if (func(m_instance, &createInfo, nullptr, &m_debugMessenger) != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to setup debug messenger");
+        return false;
+    }
+
+    return true;
+}
+
+bool VulkanRenderer::checkValidationLayerSupport()
+{
+    uint32_t layerCount;
+    vkEnumerateInstanceLayerProperties(&layerCount, nullptr);
+
+    std::vector<VkLayerProperties> availableLayers(layerCount);
+    vkEnumerateInstanceLayerProperties(&layerCount, availableLayers.data());
+
+    for (const char* layerName : m_validationLayers)
+    {
+        bool layerFound = false;
+
+        for (const auto& layerProperties : availableLayers)
+        {
+            if (strcmp(layerName, layerProperties.layerName) == 0)
+            {
+                layerFound = true;
+                break;
+            }
+        }
+
+        if (!layerFound)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::vector<const char*> VulkanRenderer::getRequiredExtensions()
+{
+    std::vector<const char*> extensions;
+
+    // Get required extensions from window, offscreen rendering needs no surface extensions
+    if (!isOffscreen())
+    {
+        auto windowExtensions = m_window->getRequiredExtensions();
+        extensions.insert(extensions.end(), windowExtensions.begin(), windowExtensions.end());
+    }
+
+    if (m_config.enableValidation)
+    {
+        extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+    }
+
+    return extensions;
+}
+
+bool VulkanRenderer::pickPhysicalDevice()
+{
+    uint32_t deviceCount = 0;
+    vkEnumeratePhysicalDevices(m_instance, &deviceCount, nullptr);
+
+    if (deviceCount == 0)
+    {
+        GN_ERROR("Failed to find GPUs with Vulkan support");
+        return false;
+    }
+
+    std::vector<VkPhysicalDevice> devices(deviceCount);
+    vkEnumeratePhysicalDevices(m_instance, &deviceCount, devices.data());
+
+    // Ties go to the first enumerated device, which the driver usually lists first for a reason
+    uint64_t bestScore = 0;
+    for (const auto& device : devices)
+    {
+        uint64_t score = rateDevice(device);
+        if (score > bestScore)
+        {
+            bestScore = score;
             m_physicalDevice = device;
+        }
+    }
+
+    if (m_physicalDevice == VK_NULL_HANDLE)
+    {
+        GN_ERROR("Failed to find a suitable GPU");
+        return false;
+    }
+
+    return true;
+}
+
+uint64_t VulkanRenderer::rateDevice(VkPhysicalDevice device)
+{
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(device, &properties);
+
+    QueueFamilyIndices indices = findQueueFamilies(device);
+    if (!indices.graphics)
+    {
+        GN_DEBUG("Skipping {}, it has no graphics queue", properties.deviceName);
+        return 0;
+    }
+
+    // Frames, readbacks and uploads are tracked with timeline semaphores
+    if (!supportsTimelineSemaphores(device, std::min(m_apiVersion, properties.apiVersion)))
+    {
+        GN_DEBUG("Skipping {}, it does not support timeline semaphores", properties.deviceName);
+        return 0;
+    }
+
+    if (!isOffscreen())
+    {
+        uint32_t formatCount = 0;
+        uint32_t presentModeCount = 0;
+        if (indices.present && isDeviceExtensionSupported(device, VK_KHR_SWAPCHAIN_EXTENSION_NAME))
+        {
+            vkGetPhysicalDeviceSurfaceFormatsKHR(device, m_surface, &formatCount, nullptr);
+            vkGetPhysicalDeviceSurfacePresentModesKHR(device, m_surface, &presentModeCount, nullptr);
+        }
+        if (formatCount == 0 || presentModeCount == 0)
+        {
+            GN_DEBUG("Skipping {}, it cannot present to the window", properties.deviceName);
+            return 0;
+        }
+    }
+
+    uint64_t typeRank = 1; // CPU and unknown device types
+    switch (properties.deviceType)
+    {
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+            typeRank = 4;
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+            typeRank = 3;
             break;
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+            typeRank = 2;
+            break;
+        default:
+            break;
+    }
+
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    vkGetPhysicalDeviceMemoryProperties(device, &memoryProperties);
+    VkDeviceSize localMemory = 0;
+    for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; ++i)
+    {
+        if (memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+        {
+            localMemory += memoryProperties.memoryHeaps[i].size;
+        }
+    }
+
+    // The device type decides, then device local memory, then a transfer queue able to run next to the graphics queue
+    uint64_t localMemoryMiB = std::min<uint64_t>(localMemory >> 20, (1ull << 40) - 1);
+    uint64_t score = (typeRank << 48) | (localMemoryMiB << 1) | (indices.transfer ? 1 : 0);
+
+    GN_DEBUG("{}: {}, {} MiB device local, transfer queue {}, score {}",
+             properties.deviceName,
+             getDeviceTypeName(properties.deviceType),
+             localMemoryMiB,
+             indices.transfer.has_value(),
+             score);
+    return score;
+}
+
+VulkanRenderer::QueueFamilyIndices VulkanRenderer::findQueueFamilies(VkPhysicalDevice device)
+{
+    QueueFamilyIndices indices;
+
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, nullptr);
+
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, queueFamilies.data());
+
+    bool transferOnlyFound = false;
+    for (uint32_t i = 0; i < queueFamilyCount; ++i)
+    {
+        VkQueueFlags flags = queueFamilies[i].queueFlags;
+        VkBool32 presentSupport = VK_FALSE;
+        if (m_surface != VK_NULL_HANDLE)
+        {
+            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_surface, &presentSupport);
+        }
+
+        // One family for both spares the swapchain images from being shared between families
+        bool graphics = flags & VK_QUEUE_GRAPHICS_BIT;
+        if (graphics && presentSupport && !(indices.graphics && indices.graphics == indices.present))
+        {
+            indices.graphics = i;
+            indices.present = i;
+        }
+        if (graphics && !indices.graphics)
+        {
+            indices.graphics = i;
+        }
+        if (presentSupport && !indices.present)
+        {
+            indices.present = i;
+        }
+
+        // Transfer-only families map to the copy engines, which run alongside graphics and compute work
+        bool transfer = (flags & VK_QUEUE_TRANSFER_BIT) && !graphics;
+        bool transferOnly = transfer && !(flags & VK_QUEUE_COMPUTE_BIT);
+        if ((transfer && !indices.transfer) || (transferOnly && !transferOnlyFound))
+        {
+            indices.transfer = i;
+            transferOnlyFound = transferOnly;
+        }
+    }
+
+    return indices;
+}
+
+bool VulkanRenderer::createLogicalDevice()
+{
+    QueueFamilyIndices indices = findQueueFamilies(m_physicalDevice);
+    m_graphicsQueueFamily = *indices.graphics;
+
+    // Device level functionality is limited by both the instance and the device version
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+    m_apiVersion = std::min(m_apiVersion, properties.apiVersion);
+    GN_INFO("Using Vulkan {}.{} on {} ({})",
+            VK_API_VERSION_MAJOR(m_apiVersion),
+            VK_API_VERSION_MINOR(m_apiVersion),
+            properties.deviceName,
+            getDeviceTypeName(properties.deviceType));
+
+    // Block compressed textures are only created when the device can sample them
+    VkPhysicalDeviceFeatures supportedFeatures;
+    vkGetPhysicalDeviceFeatures(m_physicalDevice, &supportedFeatures);
+    m_enabledFeatures = {};
+    m_enabledFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+
+    // The swapchain extension is only needed when presenting
+    std::vector<const char*> extensions;
+    if (!isOffscreen())
+    {
+        extensions = m_deviceExtensions;
+    }
+
+    VkPhysicalDeviceDescriptorIndexingFeatures indexingFeatures{};
+    indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+    m_bindless = m_config.bindless && enableDescriptorIndexing(indexingFeatures, extensions);
+    if (m_config.bindless && !m_bindless)
+    {
+        GN_WARNING("Descriptor indexing is not supported by the device, bindless mode is disabled");
+    }
+
+    // GPU culling reads draw counts from buffers, and passes object indices to shaders as the first instance
+    m_gpuCulling = supportedFeatures.drawIndirectFirstInstance &&
+                   isDeviceExtensionSupported(m_physicalDevice, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+    if (m_gpuCulling)
+    {
+        m_enabledFeatures.drawIndirectFirstInstance = VK_TRUE;
+        extensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+    }
+
+    // The query spans the whole frame, so the secondary command buffers executed inside it must inherit it
+    m_pipelineStatistics =
+        m_config.pipelineStatistics && supportedFeatures.pipelineStatisticsQuery && supportedFeatures.inheritedQueries;
+    if (m_pipelineStatistics)
+    {
+        m_enabledFeatures.pipelineStatisticsQuery = VK_TRUE;
+        m_enabledFeatures.inheritedQueries = VK_TRUE;
+    }
+    else if (m_config.pipelineStatistics)
+    {
+        GN_WARNING("Pipeline statistics queries are not supported by the device");
+    }
+
+    // rateDevice() only accepts devices supporting timeline semaphores
+    VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures{};
+    timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+    timelineFeatures.timelineSemaphore = VK_TRUE;
+    if (m_apiVersion < VK_API_VERSION_1_2)
+    {
+        extensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+    }
+
+    // Barriers and submissions are translated to the original API without it
+    VkPhysicalDeviceSynchronization2Features synchronization2Features{};
+    synchronization2Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES;
+    bool synchronization2 = enableSynchronization2(synchronization2Features, extensions);
+
+    std::set<uint32_t> uniqueQueueFamilies = {*indices.graphics};
+    if (indices.present)
+    {
+        uniqueQueueFamilies.insert(*indices.present);
+    }
+    if (indices.transfer)
+    {
+        uniqueQueueFamilies.insert(*indices.transfer);
+    }
+
+    float queuePriority = 1.0f;
+    std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
+    for (uint32_t queueFamily : uniqueQueueFamilies)
+    {
+        VkDeviceQueueCreateInfo queueCreateInfo{};
+        queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        queueCreateInfo.queueFamilyIndex = queueFamily;
+        queueCreateInfo.queueCount = 1;
+        queueCreateInfo.pQueuePriorities = &queuePriority;
+        queueCreateInfos.push_back(queueCreateInfo);
+    }
+
+    void* featureChain = &timelineFeatures;
+    if (synchronization2)
+    {
+        synchronization2Features.pNext = featureChain;
+        featureChain = &synchronization2Features;
+    }
+    if (m_bindless)
+    {
+        indexingFeatures.pNext = featureChain;
+        featureChain = &indexingFeatures;
+    }
+
+    VkDeviceCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    createInfo.pNext = featureChain;
+    createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
+    createInfo.pQueueCreateInfos = queueCreateInfos.data();
+    createInfo.pEnabledFeatures = &m_enabledFeatures;
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+    createInfo.ppEnabledExtensionNames = extensions.data();
+
+    if (m_config.enableValidation)
+    {
+        createInfo.enabledLayerCount = static_cast<uint32_t>(m_validationLayers.size());
+        createInfo.ppEnabledLayerNames = m_validationLayers.data();
+    }
+
+    if (vkCreateDevice(m_physicalDevice, &createInfo, nullptr, &m_device) != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to create logical device");
+        return false;
+    }
+
+    vkGetDeviceQueue(m_device, *indices.graphics, 0, &m_graphicsQueue);
+    if (indices.present)
+    {
+        m_presentQueueFamily = *indices.present;
+        vkGetDeviceQueue(m_device, *indices.present, 0, &m_presentQueue);
+    }
+    if (indices.transfer)
+    {
+        m_transferQueueFamily = *indices.transfer;
+        vkGetDeviceQueue(m_device, *indices.transfer, 0, &m_transferQueue);
+    }
+    GN_DEBUG("Queue families: graphics {}, present {}, transfer {}",
+             m_graphicsQueueFamily,
+             indices.present ? static_cast<int>(*indices.present) : -1,
+             indices.transfer ? static_cast<int>(m_transferQueueFamily) : -1);
+
+    if (!m_sync.initialize(m_device, m_apiVersion, synchronization2))
+    {
+        return false;
+    }
+
+    m_frameTimeline = m_sync.createTimelineSemaphore();
+    if (m_frameTimeline == VK_NULL_HANDLE)
+    {
+        GN_ERROR("Failed to create frame timeline semaphore");
+        return false;
+    }
+
+    if (m_gpuCulling)
+    {
+        m_cmdDrawIndexedIndirectCount = (PFN_vkCmdDrawIndexedIndirectCountKHR)vkGetDeviceProcAddr(
+            m_device, "vkCmdDrawIndexedIndirectCountKHR");
+        m_gpuCulling = m_cmdDrawIndexedIndirectCount != nullptr;
+    }
+
+    return true;
+}
+
+bool VulkanRenderer::isDeviceExtensionSupported(VkPhysicalDevice device, const char* extension)
+{
+    uint32_t extensionCount = 0;
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+
+    for (const auto& properties : availableExtensions)
+    {
+        if (strcmp(extension, properties.extensionName) == 0)
+        {
+            return true;
         }
     }
+    return false;
+}
+
+bool VulkanRenderer::enableDescriptorIndexing(VkPhysicalDeviceDescriptorIndexingFeatures& features,
+                                              std::vector<const char*>& extensions)
+{
+    // Core in 1.2, an extension of 1.1 devices, and the feature query itself needs 1.1
+    bool core = m_apiVersion >= VK_API_VERSION_1_2;
+    if (m_apiVersion < VK_API_VERSION_1_1 ||
+        (!core && !isDeviceExtensionSupported(m_physicalDevice, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME)))
+    {
+        return false;
+    }
+
+    VkPhysicalDeviceDescriptorIndexingFeatures supported{};
+    supported.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+    VkPhysicalDeviceFeatures2 features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.pNext = &supported;
+    vkGetPhysicalDeviceFeatures2(m_physicalDevice, &features2);
+
+    if (!supported.runtimeDescriptorArray || !supported.descriptorBindingPartiallyBound ||
+        !supported.descriptorBindingSampledImageUpdateAfterBind ||
+        !supported.descriptorBindingStorageBufferUpdateAfterBind ||
+        !supported.shaderSampledImageArrayNonUniformIndexing || !supported.shaderStorageBufferArrayNonUniformIndexing)
+    {
+        return false;
+    }
+
+    features.runtimeDescriptorArray = VK_TRUE;
+    features.descriptorBindingPartiallyBound = VK_TRUE;
+    features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    features.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+    features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+    features.shaderStorageBufferArrayNonUniformIndexing = VK_TRUE;
+    if (!core)
+    {
+        extensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+    }
+    return true;
+}
+
+bool VulkanRenderer::supportsTimelineSemaphores(VkPhysicalDevice device, uint32_t apiVersion)
+{
+    // Core in 1.2, an extension of 1.1 devices
+    bool core = apiVersion >= VK_API_VERSION_1_2;
+    if (apiVersion < VK_API_VERSION_1_1 ||
+        (!core && !isDeviceExtensionSupported(device, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME)))
+    {
+        return false;
+    }
+
+    VkPhysicalDeviceTimelineSemaphoreFeatures supported{};
+    supported.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+    VkPhysicalDeviceFeatures2 features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.pNext = &supported;
+    vkGetPhysicalDeviceFeatures2(device, &features2);
+    return supported.timelineSemaphore;
+}
+
+bool VulkanRenderer::enableSynchronization2(VkPhysicalDeviceSynchronization2Features& features,
+                                            std::vector<const char*>& extensions)
+{
+    // Core in 1.3, which the renderer does not request, the feature query needs 1.1 like timeline semaphores
+    if (!isDeviceExtensionSupported(m_physicalDevice, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME))
+    {
+        return false;
+    }
 
-    if (m_physicalDevice == VK_NULL_HANDLE)
+    VkPhysicalDeviceSynchronization2Features supported{};
+    supported.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES;
+    VkPhysicalDeviceFeatures2 features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.pNext = &supported;
+    vkGetPhysicalDeviceFeatures2(m_physicalDevice, &features2);
+
+    if (!supported.synchronization2)
     {
-        GN_ERROR("Failed to find a suitable GPU");
         return false;
     }
 
+    features.synchronization2 = VK_TRUE;
+    extensions.push_back(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
     return true;
 }
 
-bool VulkanRenderer::isDeviceSuitable(VkPhysicalDevice device)
+bool VulkanRenderer::createBindlessLayout()
 {
-    // TODO: Implement proper device suitability check
+    if (!m_bindlessHeap.initialize(m_physicalDevice, m_device))
+    {
+        return false;
+    }
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = MAX_BINDLESS_PUSH_CONSTANT_SIZE;
+
+    VkDescriptorSetLayout setLayout = m_bindlessHeap.getLayout();
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = &setLayout;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(m_device, &layoutInfo, nullptr, &m_bindlessPipelineLayout) != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to create bindless pipeline layout");
+        return false;
+    }
     return true;
 }
 
-bool VulkanRenderer::createLogicalDevice()
+bool VulkanRenderer::createSurface()
 {
-    // TODO: Implement logical device creation
+    if (!SDL_Vulkan_CreateSurface(m_window->getSDLWindow(), m_instance, &m_surface))
+    {
+        GN_ERROR("Failed to create window surface: {}", SDL_GetError());
+        return false;
+    }
     return true;
 }
 
-bool VulkanRenderer::createSurface()
+bool VulkanRenderer::createSwapChain(VkSwapchainKHR oldSwapChain)
 {
-    // TODO: Implement surface creation
+    VkSurfaceCapabilitiesKHR capabilities;
+    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(m_physicalDevice, m_surface, &capabilities);
+
+    uint32_t formatCount = 0;
+    vkGetPhysicalDeviceSurfaceFormatsKHR(m_physicalDevice, m_surface, &formatCount, nullptr);
+    std::vector<VkSurfaceFormatKHR> formats(formatCount);
+    vkGetPhysicalDeviceSurfaceFormatsKHR(m_physicalDevice, m_surface, &formatCount, formats.data());
+
+    uint32_t presentModeCount = 0;
+    vkGetPhysicalDeviceSurfacePresentModesKHR(m_physicalDevice, m_surface, &presentModeCount, nullptr);
+    std::vector<VkPresentModeKHR> presentModes(presentModeCount);
+    vkGetPhysicalDeviceSurfacePresentModesKHR(m_physicalDevice, m_surface, &presentModeCount, presentModes.data());
+
+    if (formats.empty() || presentModes.empty())
+    {
+        GN_ERROR("Surface has no formats or present modes");
+        return false;
+    }
+
+    VkSurfaceFormatKHR surfaceFormat = formats[0];
+    for (const auto& format : formats)
+    {
+        if (format.format == VK_FORMAT_B8G8R8A8_SRGB && format.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR)
+        {
+            surfaceFormat = format;
+            break;
+        }
+    }
+
+    VkPresentModeKHR presentMode = choosePresentMode(presentModes);
+
+    // A current extent of UINT32_MAX means the surface size is determined by the swapchain
+    VkExtent2D extent = capabilities.currentExtent;
+    if (extent.width == UINT32_MAX)
+    {
+        extent.width = std::clamp(static_cast<uint32_t>(m_window->getWidth()),
+                                  capabilities.minImageExtent.width,
+                                  capabilities.maxImageExtent.width);
+        extent.height = std::clamp(static_cast<uint32_t>(m_window->getHeight()),
+                                   capabilities.minImageExtent.height,
+                                   capabilities.maxImageExtent.height);
+    }
+    if (extent.width == 0 || extent.height == 0)
+    {
+        GN_DEBUG("Surface has a zero extent, the swapchain is created once the window is restored");
+        return false;
+    }
+
+    uint32_t imageCount = capabilities.minImageCount + 1;
+    if (capabilities.maxImageCount > 0)
+    {
+        imageCount = std::min(imageCount, capabilities.maxImageCount);
+    }
+
+    VkSwapchainCreateInfoKHR createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+    createInfo.surface = m_surface;
+    createInfo.minImageCount = imageCount;
+    createInfo.imageFormat = surfaceFormat.format;
+    createInfo.imageColorSpace = surfaceFormat.colorSpace;
+    createInfo.imageExtent = extent;
+    createInfo.imageArrayLayers = 1;
+    createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    createInfo.preTransform = capabilities.currentTransform;
+    createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+    createInfo.presentMode = presentMode;
+    createInfo.clipped = VK_TRUE;
+    createInfo.oldSwapchain = oldSwapChain;
+
+    uint32_t queueFamilies[] = {m_graphicsQueueFamily, m_presentQueueFamily};
+    if (m_graphicsQueueFamily != m_presentQueueFamily)
+    {
+        createInfo.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
+        createInfo.queueFamilyIndexCount = 2;
+        createInfo.pQueueFamilyIndices = queueFamilies;
+    }
+    else
+    {
+        createInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    }
+
+    if (vkCreateSwapchainKHR(m_device, &createInfo, nullptr, &m_swapChain) != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to create swap chain");
+        return false;
+    }
+
+    vkGetSwapchainImagesKHR(m_device, m_swapChain, &imageCount, nullptr);
+    m_swapChainImages.resize(imageCount);
+    vkGetSwapchainImagesKHR(m_device, m_swapChain, &imageCount, m_swapChainImages.data());
+    m_swapChainImageFormat = surfaceFormat.format;
+    m_swapChainExtent = extent;
+
+    m_swapChainImageViews.resize(imageCount, VK_NULL_HANDLE);
+    m_renderFinishedSemaphores.resize(imageCount, VK_NULL_HANDLE);
+    for (uint32_t i = 0; i < imageCount; ++i)
+    {
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = m_swapChainImages[i];
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = m_swapChainImageFormat;
+        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewInfo.subresourceRange.baseMipLevel = 0;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.baseArrayLayer = 0;
+        viewInfo.subresourceRange.layerCount = 1;
+
+        if (vkCreateImageView(m_device, &viewInfo, nullptr, &m_swapChainImageViews[i]) != VK_SUCCESS)
+        {
+            GN_ERROR("Failed to create swap chain image view");
+            return false;
+        }
+
+        // Present waits on the semaphore of its image, a per-frame semaphore could still be in use by the engine
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        if (vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &m_renderFinishedSemaphores[i]) != VK_SUCCESS)
+        {
+            GN_ERROR("Failed to create present semaphore");
+            return false;
+        }
+    }
+
+    GN_INFO("Swap chain created: {}x{}, {} images, {}",
+            extent.width,
+            extent.height,
+            imageCount,
+            getPresentModeName(presentMode));
     return true;
 }
 
-bool VulkanRenderer::createSwapChain()
+VkPresentModeKHR VulkanRenderer::choosePresentMode(const std::vector<VkPresentModeKHR>& supported) const
 {
-    // TODO: Implement swap chain creation
-    return true;
+    // FIFO is always available and caps the frame rate at the refresh rate
+    if (m_config.enableVSync)
+    {
+        return VK_PRESENT_MODE_FIFO_KHR;
+    }
+
+    std::array<VkPresentModeKHR, 2> preferred = {VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR};
+    if (m_config.presentLatency == PresentLatency::Uncapped)
+    {
+        std::swap(preferred[0], preferred[1]);
+    }
+
+    for (VkPresentModeKHR mode : preferred)
+    {
+        if (std::find(supported.begin(), supported.end(), mode) != supported.end())
+        {
+            return mode;
+        }
+    }
+    GN_WARNING("Surface only supports vsync, falling back to FIFO presentation");
+    return VK_PRESENT_MODE_FIFO_KHR;
 }
 
 void VulkanRenderer::cleanupSwapChain()
 {
-    // TODO: Implement swap chain cleanup
+    destroyRetiredSwapChains(true);
+    m_renderGraph.releaseFramebuffers();
+
+    for (VkImageView imageView : m_swapChainImageViews)
+    {
+        if (imageView != VK_NULL_HANDLE)
+        {
+            vkDestroyImageView(m_device, imageView, nullptr);
+        }
+    }
+    m_swapChainImageViews.clear();
+
+    for (VkSemaphore semaphore : m_renderFinishedSemaphores)
+    {
+        if (semaphore != VK_NULL_HANDLE)
+        {
+            vkDestroySemaphore(m_device, semaphore, nullptr);
+        }
+    }
+    m_renderFinishedSemaphores.clear();
+
+    if (m_swapChain != VK_NULL_HANDLE)
+    {
+        vkDestroySwapchainKHR(m_device, m_swapChain, nullptr);
+        m_swapChain = VK_NULL_HANDLE;
+    }
+    m_swapChainImages.clear();
 }
 
 bool VulkanRenderer::recreateSwapChain()
 {
-    // TODO: Implement swap chain recreation
+    // A minimized window has a zero sized surface, keep the old swapchain until it is restored.
+    // The window size is only updated on resize events, so the surface is asked instead
+    VkSurfaceCapabilitiesKHR capabilities;
+    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(m_physicalDevice, m_surface, &capabilities);
+    if (capabilities.currentExtent.width == 0 || capabilities.currentExtent.height == 0)
+    {
+        return false;
+    }
+
+    GN_PROFILE_SCOPE("VulkanRenderer::recreateSwapChain");
+
+    // Frames in flight may still render to or present the old images, so nothing waits for the device here.
+    // Passing the old swapchain lets the driver hand its presentation over to the new one
+    // After a failed creation there is no swapchain left to retire
+    VkSwapchainKHR oldSwapChain = m_swapChain;
+    if (oldSwapChain != VK_NULL_HANDLE)
+    {
+        RetiredSwapChain retired;
+        retired.swapChain = m_swapChain;
+        retired.imageViews = std::move(m_swapChainImageViews);
+        retired.renderFinishedSemaphores = std::move(m_renderFinishedSemaphores);
+        retired.framebuffers = m_renderGraph.detachFramebuffers();
+        retired.frameIndex = m_frameIndex;
+        m_retiredSwapChains.push_back(std::move(retired));
+    }
+
+    m_swapChain = VK_NULL_HANDLE;
+    m_swapChainImages.clear();
+    m_swapChainImageViews.clear();
+    m_renderFinishedSemaphores.clear();
+    return createSwapChain(oldSwapChain);
+}
+
+void VulkanRenderer::recoverFromFailedSubmit(uint32_t frameIndex)
+{
+    FrameData& frame = m_frames[frameIndex];
+
+    // The acquire still signals imageAvailable, and no submission waits on it anymore. The semaphore can't be
+    // reused for the next acquire, so it is released with the frame and replaced
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    VkSemaphore imageAvailable = VK_NULL_HANDLE;
+    if (vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &imageAvailable) == VK_SUCCESS)
+    {
+        m_deletionQueue.defer([device = m_device, semaphore = frame.imageAvailable]() {
+            vkDestroySemaphore(device, semaphore, nullptr);
+        });
+        frame.imageAvailable = imageAvailable;
+    }
+    else
+    {
+        GN_ERROR("Failed to replace the image available semaphore, rendering stops");
+        m_deviceLost = true;
+        return;
+    }
+
+    // The acquired image is never presented, recreating the swapchain hands it back with the retired one
+    m_framebufferResized = true;
+}
+
+void VulkanRenderer::destroyRetiredSwapChains(bool all)
+{
+    // Present has no fence, so one frame submitted after retirement must have executed too
+    uint64_t completedFrames = all ? UINT64_MAX : getCompletedFrames();
+    auto retired = m_retiredSwapChains.begin();
+    while (retired != m_retiredSwapChains.end() && retired->frameIndex < completedFrames)
+    {
+        for (VkFramebuffer framebuffer : retired->framebuffers)
+        {
+            vkDestroyFramebuffer(m_device, framebuffer, nullptr);
+        }
+        for (VkImageView imageView : retired->imageViews)
+        {
+            vkDestroyImageView(m_device, imageView, nullptr);
+        }
+        for (VkSemaphore semaphore : retired->renderFinishedSemaphores)
+        {
+            vkDestroySemaphore(m_device, semaphore, nullptr);
+        }
+        vkDestroySwapchainKHR(m_device, retired->swapChain, nullptr);
+        ++retired;
+    }
+    m_retiredSwapChains.erase(m_retiredSwapChains.begin(), retired);
+}
+
+VkExtent2D VulkanRenderer::getRenderExtent() const
+{
+    return isOffscreen() ? VkExtent2D{m_config.width, m_config.height} : m_swapChainExtent;
+}
+
+bool VulkanRenderer::createRenderPass()
+{
+    // Never begun, the render graph creates the scene pass. Pipelines and secondary command buffers
+    // only need a compatible render pass, which ignores load and store ops and layouts.
+    VkAttachmentDescription colorAttachment{};
+    colorAttachment.format = isOffscreen() ? OFFSCREEN_FORMAT : m_swapChainImageFormat;
+    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference colorAttachmentRef{};
+    colorAttachmentRef.attachment = 0;
+    colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &colorAttachmentRef;
+
+    VkRenderPassCreateInfo renderPassInfo{};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.attachmentCount = 1;
+    renderPassInfo.pAttachments = &colorAttachment;
+    renderPassInfo.subpassCount = 1;
+    renderPassInfo.pSubpasses = &subpass;
+
+    if (vkCreateRenderPass(m_device, &renderPassInfo, nullptr, &m_renderPass) != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to create render pass");
+        return false;
+    }
+
+    return true;
+}
+
+void VulkanRenderer::addScenePass()
+{
+    // Previous contents are discarded. The swapchain image waits for the acquire semaphore at the
+    // color attachment output stage, and the offscreen image for the readback of an earlier frame.
+    ImportedImage backbuffer;
+    backbuffer.image = isOffscreen() ? m_offscreenImage : m_swapChainImages[m_imageIndex];
+    backbuffer.view = isOffscreen() ? m_offscreenImageView : m_swapChainImageViews[m_imageIndex];
+    backbuffer.format = isOffscreen() ? OFFSCREEN_FORMAT : m_swapChainImageFormat;
+    backbuffer.extent = getRenderExtent();
+    backbuffer.initialUsage = isOffscreen() ? ResourceUsage::TransferSrc : ResourceUsage::ColorAttachment;
+    backbuffer.finalUsage = isOffscreen() ? ResourceUsage::TransferSrc : ResourceUsage::Present;
+    backbuffer.preserveContents = false;
+    m_backbuffer = m_renderGraph.importImage("backbuffer", backbuffer);
+
+    VkClearValue clearValue{};
+    clearValue.color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+
+    // All draws are recorded into secondary command buffers, so they can come from several threads
+    m_renderGraph
+        .addPass("scene",
+                 [this](VkCommandBuffer commandBuffer, const RenderGraph&) {
+                     const std::vector<VkCommandBuffer>& secondaries =
+                         m_frames[m_currentFrame].secondaryCommandBuffers;
+                     if (!secondaries.empty())
+                     {
+                         vkCmdExecuteCommands(
+                             commandBuffer, static_cast<uint32_t>(secondaries.size()), secondaries.data());
+                     }
+                 })
+        .write(m_backbuffer, ResourceUsage::ColorAttachment)
+        .clear(m_backbuffer, clearValue)
+        .setSecondaryContents();
+}
+
+void VulkanRenderer::resolvePipelineStatistics(uint32_t frameIndex)
+{
+    FrameData& frame = m_frames[frameIndex];
+    if (!frame.statisticsPending)
+    {
+        return;
+    }
+    frame.statisticsPending = false;
+
+    // The frame was waited on, a frame that never executed is skipped instead of waited for
+    std::array<uint64_t, PIPELINE_STATISTIC_COUNT> results{};
+    if (vkGetQueryPoolResults(m_device,
+                              frame.statisticsQuery,
+                              0,
+                              1,
+                              sizeof(results),
+                              results.data(),
+                              sizeof(results),
+                              VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+    {
+        return;
+    }
+
+    PipelineStatistics& statistics = m_stats.pipelineStatistics;
+    statistics.available = true;
+    statistics.frameIndex = frame.statisticsFrame;
+    statistics.inputPrimitives = results[0];
+    statistics.vertexInvocations = results[1];
+    statistics.clippedPrimitives = results[2];
+    statistics.fragmentInvocations = results[3];
+    statistics.computeInvocations = results[4];
+}
+
+void VulkanRenderer::finishFrameStats()
+{
+    // Uploads are counted in the frame they were flushed with, including the ones made between frames
+    const UploadStats& uploadStats = m_uploader.getStats();
+    m_frameStats.bytesUploaded = uploadStats.bytes - m_lastUploadStats.bytes;
+    m_frameStats.barriers += uploadStats.barriers - m_lastUploadStats.barriers;
+    m_lastUploadStats = uploadStats;
+
+    m_frameStats.frameIndex = m_frameIndex;
+    m_frameStats.pipelineStatistics = m_stats.pipelineStatistics;
+    m_stats = m_frameStats;
+    m_frameStats = {};
+}
+
+uint64_t VulkanRenderer::getCompletedFrames() const
+{
+    // Frame k signals k + 1, so frame k has executed once the value is above k
+    return m_sync.getValue(m_frameTimeline);
+}
+
+bool VulkanRenderer::createOffscreenTarget()
+{
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = OFFSCREEN_FORMAT;
+    imageInfo.extent = {m_config.width, m_config.height, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    if (!m_allocator.createImage(imageInfo, MemoryUsage::GpuOnly, m_offscreenImage, m_offscreenMemory))
+    {
+        GN_ERROR("Failed to create offscreen image");
+        return false;
+    }
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = m_offscreenImage;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = OFFSCREEN_FORMAT;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    if (vkCreateImageView(m_device, &viewInfo, nullptr, &m_offscreenImageView) != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to create offscreen image view");
+        return false;
+    }
+
+    return true;
+}
+
+void VulkanRenderer::destroyOffscreenTarget()
+{
+    m_renderGraph.releaseFramebuffers();
+
+    if (m_offscreenImageView != VK_NULL_HANDLE)
+    {
+        vkDestroyImageView(m_device, m_offscreenImageView, nullptr);
+        m_offscreenImageView = VK_NULL_HANDLE;
+    }
+
+    if (m_offscreenImage != VK_NULL_HANDLE)
+    {
+        m_allocator.destroyImage(m_offscreenImage, m_offscreenMemory);
+        m_offscreenImage = VK_NULL_HANDLE;
+    }
+}
+
+bool VulkanRenderer::createReadbackBuffers()
+{
+    VkDeviceSize size = static_cast<VkDeviceSize>(m_config.width) * m_config.height * 4;
+
+    for (Readback& readback : m_readbacks)
+    {
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        if (!m_allocator.createBuffer(bufferInfo, MemoryUsage::GpuToCpu, readback.buffer, readback.memory))
+        {
+            GN_ERROR("Failed to create readback buffer");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void VulkanRenderer::destroyReadbackBuffers()
+{
+    for (Readback& readback : m_readbacks)
+    {
+        if (readback.buffer != VK_NULL_HANDLE)
+        {
+            m_allocator.destroyBuffer(readback.buffer, readback.memory);
+        }
+        readback = Readback{};
+    }
+}
+
+void VulkanRenderer::recordReadback(VkCommandBuffer commandBuffer, uint32_t slot)
+{
+    // The render graph transitions the image to TRANSFER_SRC_OPTIMAL and orders the copy after the scene pass
+    VkBufferImageCopy region{};
+    region.bufferOffset = 0;
+    region.bufferRowLength = 0;
+    region.bufferImageHeight = 0;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = 1;
+    region.imageOffset = {0, 0, 0};
+    region.imageExtent = {m_config.width, m_config.height, 1};
+
+    vkCmdCopyImageToBuffer(
+        commandBuffer, m_offscreenImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, m_readbacks[slot].buffer, 1, &region);
+
+    // Make the copy visible to host reads
+    VkBufferMemoryBarrier2 barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+    barrier.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+    barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    barrier.dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT;
+    barrier.dstAccessMask = VK_ACCESS_2_HOST_READ_BIT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = m_readbacks[slot].buffer;
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+
+    VkDependencyInfo dependency{};
+    dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    dependency.bufferMemoryBarrierCount = 1;
+    dependency.pBufferMemoryBarriers = &barrier;
+    m_sync.pipelineBarrier(commandBuffer, dependency);
+    ++m_frameStats.barriers;
+}
+
+VkShaderModule VulkanRenderer::createShaderModule(const std::vector<uint32_t>& code)
+{
+    VkShaderModuleCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    createInfo.codeSize = code.size() * sizeof(uint32_t);
+    createInfo.pCode = code.data();
+
+    VkShaderModule module = VK_NULL_HANDLE;
+    if (vkCreateShaderModule(m_device, &createInfo, nullptr, &module) != VK_SUCCESS)
+    {
+        return VK_NULL_HANDLE;
+    }
+    return module;
+}
+
+bool VulkanRenderer::createFrameResources()
+{
+    m_frames.resize(std::max(1u, m_config.framesInFlight));
+
+    for (FrameData& frame : m_frames)
+    {
+        // Command buffers are short lived and reset together with their pool every frame
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        poolInfo.queueFamilyIndex = m_graphicsQueueFamily;
+
+        if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &frame.commandPool) != VK_SUCCESS)
+        {
+            GN_ERROR("Failed to create command pool");
+            return false;
+        }
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = frame.commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+
+        if (vkAllocateCommandBuffers(m_device, &allocInfo, &frame.commandBuffer) != VK_SUCCESS)
+        {
+            GN_ERROR("Failed to allocate command buffer");
+            return false;
+        }
+
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        if (vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &frame.imageAvailable) != VK_SUCCESS)
+        {
+            GN_ERROR("Failed to create frame synchronization objects");
+            return false;
+        }
+
+        if (m_pipelineStatistics)
+        {
+            VkQueryPoolCreateInfo queryInfo{};
+            queryInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+            queryInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+            queryInfo.queryCount = 1;
+            queryInfo.pipelineStatistics = PIPELINE_STATISTICS;
+            if (vkCreateQueryPool(m_device, &queryInfo, nullptr, &frame.statisticsQuery) != VK_SUCCESS)
+            {
+                GN_ERROR("Failed to create pipeline statistics query pool");
+                return false;
+            }
+        }
+
+        // One pool per thread that may record, so recording never contends on a pool
+        frame.threadPools.resize(core::JobSystem::getInstance().getWorkerCount() + 1);
+        for (ThreadCommandPool& threadPool : frame.threadPools)
+        {
+            if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &threadPool.commandPool) != VK_SUCCESS)
+            {
+                GN_ERROR("Failed to create secondary command pool");
+                return false;
+            }
+        }
+    }
+
+    m_currentFrame = 0;
     return true;
 }
 
+void VulkanRenderer::destroyFrameResources()
+{
+    for (FrameData& frame : m_frames)
+    {
+        if (frame.imageAvailable != VK_NULL_HANDLE)
+        {
+            vkDestroySemaphore(m_device, frame.imageAvailable, nullptr);
+        }
+        if (frame.statisticsQuery != VK_NULL_HANDLE)
+        {
+            vkDestroyQueryPool(m_device, frame.statisticsQuery, nullptr);
+        }
+        if (frame.commandPool != VK_NULL_HANDLE)
+        {
+            // Command buffers are freed together with their pool
+            vkDestroyCommandPool(m_device, frame.commandPool, nullptr);
+        }
+        for (ThreadCommandPool& threadPool : frame.threadPools)
+        {
+            if (threadPool.commandPool != VK_NULL_HANDLE)
+            {
+                vkDestroyCommandPool(m_device, threadPool.commandPool, nullptr);
+            }
+        }
+    }
+    m_frames.clear();
+}
+
 VKAPI_ATTR VkBool32 VKAPI_CALL VulkanRenderer::debugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
                                                              VkDebugUtilsMessageTypeFlagsEXT messageType,
                                                              const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData,
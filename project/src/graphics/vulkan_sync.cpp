@@ -0,0 +1,263 @@
+#include "graphics/vulkan_sync.h"
+#include "utils/logger.h"
+#include <vector>
+
+namespace graphyne::graphics
+{
+
+namespace
+{
+
+// Stages of the original API occupy the low 32 bits of the synchronization2 flags
+VkPipelineStageFlags toStages(VkPipelineStageFlags2 stages)
+{
+    return static_cast<VkPipelineStageFlags>(stages);
+}
+
+VkAccessFlags toAccess(VkAccessFlags2 access)
+{
+    return static_cast<VkAccessFlags>(access);
+}
+
+} // namespace
+
+bool VulkanSync::initialize(VkDevice device, uint32_t apiVersion, bool synchronization2)
+{
+    m_device = device;
+
+    // Core in 1.2, the extension functions carry a suffix on 1.1
+    bool core = apiVersion >= VK_API_VERSION_1_2;
+    m_waitSemaphores = reinterpret_cast<PFN_vkWaitSemaphores>(
+        vkGetDeviceProcAddr(device, core ? "vkWaitSemaphores" : "vkWaitSemaphoresKHR"));
+    m_getSemaphoreCounterValue = reinterpret_cast<PFN_vkGetSemaphoreCounterValue>(
+        vkGetDeviceProcAddr(device, core ? "vkGetSemaphoreCounterValue" : "vkGetSemaphoreCounterValueKHR"));
+    if (!m_waitSemaphores || !m_getSemaphoreCounterValue)
+    {
+        GN_ERROR("Failed to load the timeline semaphore functions");
+        return false;
+    }
+
+    m_cmdPipelineBarrier2 = nullptr;
+    m_queueSubmit2 = nullptr;
+    if (synchronization2)
+    {
+        m_cmdPipelineBarrier2 = reinterpret_cast<PFN_vkCmdPipelineBarrier2>(
+            vkGetDeviceProcAddr(device, "vkCmdPipelineBarrier2KHR"));
+        m_queueSubmit2 = reinterpret_cast<PFN_vkQueueSubmit2>(vkGetDeviceProcAddr(device, "vkQueueSubmit2KHR"));
+        if (!m_cmdPipelineBarrier2 || !m_queueSubmit2)
+        {
+            GN_WARNING("Failed to load the synchronization2 functions, barriers use the original API");
+            m_cmdPipelineBarrier2 = nullptr;
+            m_queueSubmit2 = nullptr;
+        }
+    }
+
+    GN_DEBUG("Recording barriers with {}", hasSynchronization2() ? "synchronization2" : "vkCmdPipelineBarrier");
+    return true;
+}
+
+VkSemaphore VulkanSync::createTimelineSemaphore() const
+{
+    VkSemaphoreTypeCreateInfo typeInfo{};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+
+    VkSemaphore semaphore = VK_NULL_HANDLE;
+    if (vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS)
+    {
+        return VK_NULL_HANDLE;
+    }
+    return semaphore;
+}
+
+uint64_t VulkanSync::getValue(VkSemaphore semaphore) const
+{
+    uint64_t value = 0;
+    if (m_getSemaphoreCounterValue(m_device, semaphore, &value) != VK_SUCCESS)
+    {
+        return 0;
+    }
+    return value;
+}
+
+bool VulkanSync::wait(VkSemaphore semaphore, uint64_t value) const
+{
+    if (value == 0)
+    {
+        return true;
+    }
+
+    VkSemaphoreWaitInfo waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &semaphore;
+    waitInfo.pValues = &value;
+    return m_waitSemaphores(m_device, &waitInfo, UINT64_MAX) == VK_SUCCESS;
+}
+
+void VulkanSync::pipelineBarrier(VkCommandBuffer commandBuffer, const VkDependencyInfo& dependency) const
+{
+    if (m_cmdPipelineBarrier2)
+    {
+        m_cmdPipelineBarrier2(commandBuffer, &dependency);
+        return;
+    }
+
+    // Kept per thread so translating a barrier does not allocate once the vectors have grown
+    thread_local std::vector<VkMemoryBarrier> memoryBarriers;
+    thread_local std::vector<VkBufferMemoryBarrier> bufferBarriers;
+    thread_local std::vector<VkImageMemoryBarrier> imageBarriers;
+    memoryBarriers.clear();
+    bufferBarriers.clear();
+    imageBarriers.clear();
+
+    VkPipelineStageFlags srcStages = 0;
+    VkPipelineStageFlags dstStages = 0;
+    for (uint32_t i = 0; i < dependency.memoryBarrierCount; ++i)
+    {
+        const VkMemoryBarrier2& barrier2 = dependency.pMemoryBarriers[i];
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = toAccess(barrier2.srcAccessMask);
+        barrier.dstAccessMask = toAccess(barrier2.dstAccessMask);
+        memoryBarriers.push_back(barrier);
+        srcStages |= toStages(barrier2.srcStageMask);
+        dstStages |= toStages(barrier2.dstStageMask);
+    }
+    for (uint32_t i = 0; i < dependency.bufferMemoryBarrierCount; ++i)
+    {
+        const VkBufferMemoryBarrier2& barrier2 = dependency.pBufferMemoryBarriers[i];
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = toAccess(barrier2.srcAccessMask);
+        barrier.dstAccessMask = toAccess(barrier2.dstAccessMask);
+        barrier.srcQueueFamilyIndex = barrier2.srcQueueFamilyIndex;
+        barrier.dstQueueFamilyIndex = barrier2.dstQueueFamilyIndex;
+        barrier.buffer = barrier2.buffer;
+        barrier.offset = barrier2.offset;
+        barrier.size = barrier2.size;
+        bufferBarriers.push_back(barrier);
+        srcStages |= toStages(barrier2.srcStageMask);
+        dstStages |= toStages(barrier2.dstStageMask);
+    }
+    for (uint32_t i = 0; i < dependency.imageMemoryBarrierCount; ++i)
+    {
+        const VkImageMemoryBarrier2& barrier2 = dependency.pImageMemoryBarriers[i];
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = toAccess(barrier2.srcAccessMask);
+        barrier.dstAccessMask = toAccess(barrier2.dstAccessMask);
+        barrier.oldLayout = barrier2.oldLayout;
+        barrier.newLayout = barrier2.newLayout;
+        barrier.srcQueueFamilyIndex = barrier2.srcQueueFamilyIndex;
+        barrier.dstQueueFamilyIndex = barrier2.dstQueueFamilyIndex;
+        barrier.image = barrier2.image;
+        barrier.subresourceRange = barrier2.subresourceRange;
+        imageBarriers.push_back(barrier);
+        srcStages |= toStages(barrier2.srcStageMask);
+        dstStages |= toStages(barrier2.dstStageMask);
+    }
+
+    // The original API has no empty stage masks
+    vkCmdPipelineBarrier(commandBuffer,
+                         srcStages != 0 ? srcStages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                         dstStages != 0 ? dstStages : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                         dependency.dependencyFlags,
+                         static_cast<uint32_t>(memoryBarriers.size()),
+                         memoryBarriers.data(),
+                         static_cast<uint32_t>(bufferBarriers.size()),
+                         bufferBarriers.data(),
+                         static_cast<uint32_t>(imageBarriers.size()),
+                         imageBarriers.data());
+}
+
+void VulkanSync::memoryBarrier(VkCommandBuffer commandBuffer,
+                               VkPipelineStageFlags2 srcStages,
+                               VkAccessFlags2 srcAccess,
+                               VkPipelineStageFlags2 dstStages,
+                               VkAccessFlags2 dstAccess) const
+{
+    VkMemoryBarrier2 barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+    barrier.srcStageMask = srcStages;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstStageMask = dstStages;
+    barrier.dstAccessMask = dstAccess;
+
+    VkDependencyInfo dependency{};
+    dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    dependency.memoryBarrierCount = 1;
+    dependency.pMemoryBarriers = &barrier;
+    pipelineBarrier(commandBuffer, dependency);
+}
+
+void VulkanSync::imageBarriers(VkCommandBuffer commandBuffer,
+                               uint32_t count,
+                               const VkImageMemoryBarrier2* barriers) const
+{
+    VkDependencyInfo dependency{};
+    dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    dependency.imageMemoryBarrierCount = count;
+    dependency.pImageMemoryBarriers = barriers;
+    pipelineBarrier(commandBuffer, dependency);
+}
+
+VkResult VulkanSync::submit(VkQueue queue, const VkSubmitInfo2& submitInfo) const
+{
+    if (m_queueSubmit2)
+    {
+        return m_queueSubmit2(queue, 1, &submitInfo, VK_NULL_HANDLE);
+    }
+
+    std::vector<VkSemaphore> waitSemaphores(submitInfo.waitSemaphoreInfoCount);
+    std::vector<uint64_t> waitValues(submitInfo.waitSemaphoreInfoCount);
+    std::vector<VkPipelineStageFlags> waitStages(submitInfo.waitSemaphoreInfoCount);
+    for (uint32_t i = 0; i < submitInfo.waitSemaphoreInfoCount; ++i)
+    {
+        const VkSemaphoreSubmitInfo& wait = submitInfo.pWaitSemaphoreInfos[i];
+        waitSemaphores[i] = wait.semaphore;
+        waitValues[i] = wait.value;
+        waitStages[i] = wait.stageMask != 0 ? toStages(wait.stageMask) : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    }
+
+    std::vector<VkCommandBuffer> commandBuffers(submitInfo.commandBufferInfoCount);
+    for (uint32_t i = 0; i < submitInfo.commandBufferInfoCount; ++i)
+    {
+        commandBuffers[i] = submitInfo.pCommandBufferInfos[i].commandBuffer;
+    }
+
+    // Signal operations of the original API always wait for all commands
+    std::vector<VkSemaphore> signalSemaphores(submitInfo.signalSemaphoreInfoCount);
+    std::vector<uint64_t> signalValues(submitInfo.signalSemaphoreInfoCount);
+    for (uint32_t i = 0; i < submitInfo.signalSemaphoreInfoCount; ++i)
+    {
+        signalSemaphores[i] = submitInfo.pSignalSemaphoreInfos[i].semaphore;
+        signalValues[i] = submitInfo.pSignalSemaphoreInfos[i].value;
+    }
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount = static_cast<uint32_t>(waitValues.size());
+    timelineInfo.pWaitSemaphoreValues = waitValues.data();
+    timelineInfo.signalSemaphoreValueCount = static_cast<uint32_t>(signalValues.size());
+    timelineInfo.pSignalSemaphoreValues = signalValues.data();
+
+    VkSubmitInfo legacyInfo{};
+    legacyInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    legacyInfo.pNext = &timelineInfo;
+    legacyInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+    legacyInfo.pWaitSemaphores = waitSemaphores.data();
+    legacyInfo.pWaitDstStageMask = waitStages.data();
+    legacyInfo.commandBufferCount = static_cast<uint32_t>(commandBuffers.size());
+    legacyInfo.pCommandBuffers = commandBuffers.data();
+    legacyInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
+    legacyInfo.pSignalSemaphores = signalSemaphores.data();
+    return vkQueueSubmit(queue, 1, &legacyInfo, VK_NULL_HANDLE);
+}
+
+} // namespace graphyne::graphics
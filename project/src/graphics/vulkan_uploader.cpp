@@ -0,0 +1,481 @@
+#include "graphics/vulkan_uploader.h"
+#include "utils/logger.h"
+#include "utils/profiler.h"
+#include <algorithm>
+#include <cstring>
+
+namespace graphyne::graphics
+{
+
+namespace
+{
+
+// Staging offsets of image copies must be multiples of the texel block size and of 4
+constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+uint64_t alignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+VkImageMemoryBarrier2 makeImageBarrier(VkImage image,
+                                       uint32_t baseMipLevel,
+                                       uint32_t levelCount,
+                                       VkImageLayout oldLayout,
+                                       VkImageLayout newLayout,
+                                       VkPipelineStageFlags2 srcStages,
+                                       VkAccessFlags2 srcAccess,
+                                       VkPipelineStageFlags2 dstStages,
+                                       VkAccessFlags2 dstAccess)
+{
+    VkImageMemoryBarrier2 barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+    barrier.srcStageMask = srcStages;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstStageMask = dstStages;
+    barrier.dstAccessMask = dstAccess;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, baseMipLevel, levelCount, 0, 1};
+    return barrier;
+}
+
+} // namespace
+
+VulkanUploader::~VulkanUploader()
+{
+    shutdown();
+}
+
+bool VulkanUploader::initialize(VkDevice device,
+                                VulkanAllocator& allocator,
+                                const VulkanSync& sync,
+                                const QueueInfo& queue,
+                                VkDeviceSize ringSize)
+{
+    m_device = device;
+    m_allocator = &allocator;
+    m_sync = &sync;
+    m_queue = queue;
+    m_ringSize = alignUp(std::max<VkDeviceSize>(ringSize, STAGING_ALIGNMENT), STAGING_ALIGNMENT);
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolInfo.queueFamilyIndex = m_queue.family;
+
+    if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &m_commandPool) != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to create upload command pool");
+        return false;
+    }
+
+    m_semaphore = m_sync->createTimelineSemaphore();
+    if (m_semaphore == VK_NULL_HANDLE)
+    {
+        GN_ERROR("Failed to create upload timeline semaphore");
+        return false;
+    }
+
+    VkBufferCreateInfo ringInfo{};
+    ringInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    ringInfo.size = m_ringSize;
+    ringInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    ringInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (!m_allocator->createBuffer(ringInfo, MemoryUsage::CpuToGpu, m_ring.buffer, m_ring.allocation))
+    {
+        GN_ERROR("Failed to create the {} byte staging ring", m_ringSize);
+        return false;
+    }
+
+    GN_INFO("Uploading through a {} KiB staging ring on the {} queue",
+            m_ringSize / 1024,
+            m_queue.dedicated ? "transfer" : "graphics");
+    return true;
+}
+
+void VulkanUploader::shutdown()
+{
+    if (m_device == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    waitIdle();
+    m_freeBatches.clear();
+
+    if (m_ring.buffer != VK_NULL_HANDLE)
+    {
+        m_allocator->destroyBuffer(m_ring.buffer, m_ring.allocation);
+        m_ring = {};
+    }
+
+    // Destroying the pool frees the command buffers of every batch
+    vkDestroySemaphore(m_device, m_semaphore, nullptr);
+    vkDestroyCommandPool(m_device, m_commandPool, nullptr);
+    m_semaphore = VK_NULL_HANDLE;
+    m_commandPool = VK_NULL_HANDLE;
+    m_submittedValue = 0;
+    m_ringHead = 0;
+    m_ringTail = 0;
+    m_sync = nullptr;
+    m_device = VK_NULL_HANDLE;
+}
+
+bool VulkanUploader::uploadBuffer(VkBuffer buffer, VkDeviceSize offset, const void* data, VkDeviceSize size)
+{
+    VkBuffer staging = VK_NULL_HANDLE;
+    VkDeviceSize stagingOffset = 0;
+    if (!stage(data, size, staging, stagingOffset))
+    {
+        return false;
+    }
+
+    VkBufferCopy region{stagingOffset, offset, size};
+    vkCmdCopyBuffer(m_openBatch.commandBuffer, staging, buffer, 1, &region);
+    ++m_stats.copies;
+    return true;
+}
+
+bool VulkanUploader::uploadImage(VkImage image,
+                                 uint32_t mipLevel,
+                                 VkExtent3D extent,
+                                 const void* data,
+                                 VkDeviceSize size)
+{
+    VkBuffer staging = VK_NULL_HANDLE;
+    VkDeviceSize stagingOffset = 0;
+    if (!stage(data, size, staging, stagingOffset))
+    {
+        return false;
+    }
+
+    // Waits for earlier samplers of the mip level, through the execution barrier at the start of the batch or the
+    // graphics timeline, and for earlier copies into it
+    VkCommandBuffer commandBuffer = m_openBatch.commandBuffer;
+    VkImageMemoryBarrier2 barrier = makeImageBarrier(image,
+                                                     mipLevel,
+                                                     1,
+                                                     VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                     VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                                                     VK_ACCESS_2_NONE,
+                                                     VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                                                     VK_ACCESS_2_TRANSFER_WRITE_BIT);
+    m_sync->imageBarriers(commandBuffer, 1, &barrier);
+
+    VkBufferImageCopy region{};
+    region.bufferOffset = stagingOffset;
+    region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, mipLevel, 0, 1};
+    region.imageExtent = extent;
+    vkCmdCopyBufferToImage(commandBuffer, staging, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+    // Visibility to the graphics queue comes from the end of the batch
+    barrier = makeImageBarrier(image,
+                               mipLevel,
+                               1,
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                               VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                               VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                               VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                               VK_ACCESS_2_NONE);
+    m_sync->imageBarriers(commandBuffer, 1, &barrier);
+
+    ++m_stats.copies;
+    m_stats.barriers += 2;
+    return true;
+}
+
+bool VulkanUploader::initializeImage(VkImage image, uint32_t mipLevels)
+{
+    Batch* batch = openBatch();
+    if (!batch)
+    {
+        return false;
+    }
+
+    VkImageMemoryBarrier2 barrier = makeImageBarrier(image,
+                                                     0,
+                                                     mipLevels,
+                                                     VK_IMAGE_LAYOUT_UNDEFINED,
+                                                     VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                                     VK_PIPELINE_STAGE_2_NONE,
+                                                     VK_ACCESS_2_NONE,
+                                                     VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                                                     VK_ACCESS_2_NONE);
+    m_sync->imageBarriers(batch->commandBuffer, 1, &barrier);
+    ++m_stats.barriers;
+    return true;
+}
+
+void VulkanUploader::waitForGraphics(VkSemaphore semaphore, uint64_t value)
+{
+    if (!m_queue.dedicated || value == 0)
+    {
+        return;
+    }
+
+    if (Batch* batch = openBatch())
+    {
+        batch->graphicsSemaphore = semaphore;
+        batch->graphicsValue = std::max(batch->graphicsValue, value);
+    }
+}
+
+uint64_t VulkanUploader::flush()
+{
+    if (!m_batchOpen)
+    {
+        return m_submittedValue;
+    }
+
+    GN_PROFILE_SCOPE("VulkanUploader::flush");
+
+    Batch batch = std::move(m_openBatch);
+    m_openBatch = {};
+    m_batchOpen = false;
+    batch.ringHead = m_ringHead;
+
+    // On the graphics queue, later frames see the uploads through this barrier instead of a semaphore
+    if (!m_queue.dedicated)
+    {
+        m_sync->memoryBarrier(batch.commandBuffer,
+                              VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                              VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                              VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                              VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT);
+        ++m_stats.barriers;
+    }
+
+    batch.value = m_submittedValue + 1;
+
+    VkSemaphoreSubmitInfo waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+    waitInfo.semaphore = batch.graphicsSemaphore;
+    waitInfo.value = batch.graphicsValue;
+    waitInfo.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+    VkCommandBufferSubmitInfo commandBufferInfo{};
+    commandBufferInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+    commandBufferInfo.commandBuffer = batch.commandBuffer;
+
+    VkSemaphoreSubmitInfo signalInfo{};
+    signalInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+    signalInfo.semaphore = m_semaphore;
+    signalInfo.value = batch.value;
+    signalInfo.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+    VkSubmitInfo2 submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+    submitInfo.waitSemaphoreInfoCount = batch.graphicsValue > 0 ? 1 : 0;
+    submitInfo.pWaitSemaphoreInfos = &waitInfo;
+    submitInfo.commandBufferInfoCount = 1;
+    submitInfo.pCommandBufferInfos = &commandBufferInfo;
+    submitInfo.signalSemaphoreInfoCount = 1;
+    submitInfo.pSignalSemaphoreInfos = &signalInfo;
+
+    if (vkEndCommandBuffer(batch.commandBuffer) != VK_SUCCESS ||
+        m_sync->submit(m_queue.queue, submitInfo) != VK_SUCCESS)
+    {
+        // The copies are dropped, the staging memory is reclaimed once earlier batches are done with the ring
+        GN_ERROR("Failed to submit upload batch");
+        vkQueueWaitIdle(m_queue.queue);
+        collect();
+        retire(batch);
+        m_freeBatches.push_back(std::move(batch));
+        return m_submittedValue;
+    }
+
+    m_submittedValue = batch.value;
+    ++m_stats.batches;
+    m_pendingBatches.push_back(std::move(batch));
+    return m_submittedValue;
+}
+
+void VulkanUploader::collect()
+{
+    if (m_pendingBatches.empty())
+    {
+        return;
+    }
+
+    uint64_t completedValue = m_sync->getValue(m_semaphore);
+    while (!m_pendingBatches.empty() && m_pendingBatches.front().value <= completedValue)
+    {
+        retire(m_pendingBatches.front());
+        m_freeBatches.push_back(std::move(m_pendingBatches.front()));
+        m_pendingBatches.pop_front();
+    }
+}
+
+void VulkanUploader::waitIdle()
+{
+    uint64_t value = flush();
+    if (value > 0)
+    {
+        m_sync->wait(m_semaphore, value);
+    }
+    collect();
+}
+
+VulkanUploader::Batch* VulkanUploader::openBatch()
+{
+    if (m_batchOpen)
+    {
+        return &m_openBatch;
+    }
+
+    Batch batch;
+    if (!m_freeBatches.empty())
+    {
+        batch = std::move(m_freeBatches.back());
+        m_freeBatches.pop_back();
+    }
+    else
+    {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = m_commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+
+        if (vkAllocateCommandBuffers(m_device, &allocInfo, &batch.commandBuffer) != VK_SUCCESS)
+        {
+            GN_ERROR("Failed to create upload batch");
+            return nullptr;
+        }
+    }
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if (vkBeginCommandBuffer(batch.commandBuffer, &beginInfo) != VK_SUCCESS)
+    {
+        GN_ERROR("Failed to begin upload batch");
+        m_freeBatches.push_back(std::move(batch));
+        return nullptr;
+    }
+
+    // On the graphics queue, copies overwriting data wait for the frames submitted earlier to stop reading it
+    if (!m_queue.dedicated)
+    {
+        m_sync->memoryBarrier(batch.commandBuffer,
+                              VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                              VK_ACCESS_2_NONE,
+                              VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                              VK_ACCESS_2_NONE);
+        ++m_stats.barriers;
+    }
+
+    m_openBatch = std::move(batch);
+    m_batchOpen = true;
+    return &m_openBatch;
+}
+
+bool VulkanUploader::stage(const void* data, VkDeviceSize size, VkBuffer& buffer, VkDeviceSize& offset)
+{
+    // Large uploads would keep most of the ring busy, they get a staging buffer of their own
+    if (size > m_ringSize / 2)
+    {
+        Batch* batch = openBatch();
+        if (!batch)
+        {
+            return false;
+        }
+
+        VkBufferCreateInfo stagingInfo{};
+        stagingInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        stagingInfo.size = size;
+        stagingInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        stagingInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        StagingBuffer staging;
+        if (!m_allocator->createBuffer(stagingInfo, MemoryUsage::CpuToGpu, staging.buffer, staging.allocation))
+        {
+            GN_ERROR("Failed to create a {} byte staging buffer", size);
+            return false;
+        }
+        std::memcpy(staging.allocation.mapped, data, size);
+        m_allocator->flush(staging.allocation);
+
+        batch->dedicatedStaging.push_back(staging);
+        buffer = staging.buffer;
+        offset = 0;
+        ++m_stats.dedicatedStaging;
+        m_stats.bytes += size;
+        return true;
+    }
+
+    // Submitting early lets the GPU copy one part of the ring while the CPU fills the rest
+    if (m_batchOpen && m_openBatch.bytes + size > m_ringSize / 4)
+    {
+        flush();
+    }
+
+    if (!allocateRing(size, offset))
+    {
+        return false;
+    }
+    std::memcpy(static_cast<uint8_t*>(m_ring.allocation.mapped) + offset, data, size);
+    m_allocator->flush(m_ring.allocation, offset, size);
+
+    Batch* batch = openBatch();
+    if (!batch)
+    {
+        return false;
+    }
+    batch->bytes += size;
+    buffer = m_ring.buffer;
+    m_stats.bytes += size;
+    return true;
+}
+
+bool VulkanUploader::allocateRing(VkDeviceSize size, VkDeviceSize& offset)
+{
+    // Allocations never wrap around the end of the ring, the rest of the ring is skipped instead
+    uint64_t position = alignUp(m_ringHead, STAGING_ALIGNMENT);
+    if (position % m_ringSize + size > m_ringSize)
+    {
+        position = alignUp(position, m_ringSize);
+    }
+
+    while (position + size - m_ringTail > m_ringSize)
+    {
+        flush();
+        if (m_pendingBatches.empty())
+        {
+            GN_ERROR("Staging ring of {} bytes cannot hold {} bytes", m_ringSize, size);
+            return false;
+        }
+
+        GN_PROFILE_SCOPE("VulkanUploader::waitForRing");
+        ++m_stats.ringStalls;
+        m_sync->wait(m_semaphore, m_pendingBatches.front().value);
+        collect();
+    }
+
+    m_ringHead = position + size;
+    offset = position % m_ringSize;
+    return true;
+}
+
+void VulkanUploader::retire(Batch& batch)
+{
+    m_ringTail = std::max(m_ringTail, batch.ringHead);
+    for (StagingBuffer& staging : batch.dedicatedStaging)
+    {
+        m_allocator->destroyBuffer(staging.buffer, staging.allocation);
+    }
+    batch.dedicatedStaging.clear();
+    batch.bytes = 0;
+    batch.graphicsSemaphore = VK_NULL_HANDLE;
+    batch.graphicsValue = 0;
+    vkResetCommandBuffer(batch.commandBuffer, 0);
+}
+
+} // namespace graphyne::graphics
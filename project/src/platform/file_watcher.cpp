@@ -0,0 +1,127 @@
+#include "platform/file_watcher.h"
+#include "utils/logger.h"
+#include <algorithm>
+#include <filesystem>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace graphyne::platform
+{
+
+FileWatcher::~FileWatcher()
+{
+    shutdown();
+}
+
+bool FileWatcher::initialize()
+{
+#ifdef __linux__
+    if (m_handle >= 0)
+    {
+        return true;
+    }
+
+    m_handle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_handle < 0)
+    {
+        GN_ERROR("Failed to initialize inotify: {}", std::strerror(errno));
+        return false;
+    }
+    return true;
+#else
+    GN_WARNING("File watching is not supported on this platform");
+    return false;
+#endif
+}
+
+void FileWatcher::shutdown()
+{
+#ifdef __linux__
+    if (m_handle >= 0)
+    {
+        close(m_handle);
+        m_handle = -1;
+    }
+#endif
+    m_watches.clear();
+}
+
+bool FileWatcher::watchDirectory(const std::string& directory)
+{
+    if (m_handle < 0)
+    {
+        return false;
+    }
+
+    std::string normalized = std::filesystem::path(directory).lexically_normal().string();
+    for (const auto& [descriptor, watched] : m_watches)
+    {
+        if (watched == normalized)
+        {
+            return true;
+        }
+    }
+
+#ifdef __linux__
+    // Editors either rewrite files in place or save to a temporary file and rename it
+    int descriptor = inotify_add_watch(m_handle, normalized.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (descriptor < 0)
+    {
+        GN_ERROR("Failed to watch directory {}: {}", normalized, std::strerror(errno));
+        return false;
+    }
+
+    m_watches[descriptor] = normalized;
+    GN_DEBUG("Watching directory: {}", normalized);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void FileWatcher::poll(std::vector<std::string>& changedFiles)
+{
+    changedFiles.clear();
+    if (m_handle < 0)
+    {
+        return;
+    }
+
+#ifdef __linux__
+    alignas(inotify_event) char buffer[4096];
+    for (;;)
+    {
+        ssize_t length = read(m_handle, buffer, sizeof(buffer));
+        if (length <= 0)
+        {
+            // EAGAIN means everything has been drained
+            break;
+        }
+
+        for (ssize_t offset = 0; offset < length;)
+        {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+            auto it = m_watches.find(event->wd);
+            if (it == m_watches.end() || event->len == 0)
+            {
+                continue;
+            }
+
+            std::string path = (std::filesystem::path(it->second) / event->name).lexically_normal().string();
+            if (std::find(changedFiles.begin(), changedFiles.end(), path) == changedFiles.end())
+            {
+                changedFiles.push_back(std::move(path));
+            }
+        }
+    }
+#endif
+}
+
+} // namespace graphyne::platform
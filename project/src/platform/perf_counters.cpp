@@ -0,0 +1,301 @@
+#include "platform/perf_counters.h"
+#include "utils/logger.h"
+#include <chrono>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace graphyne::platform
+{
+
+namespace
+{
+
+uint64_t getWallTime()
+{
+    auto time = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count());
+}
+
+#ifdef __linux__
+int openCounter(uint64_t config, int groupDescriptor)
+{
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    // The whole group is enabled through the leader
+    if (groupDescriptor < 0)
+    {
+        attr.disabled = 1;
+    }
+
+    // Calling thread on any CPU, every thread that is counted opens its own group
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupDescriptor, PERF_FLAG_FD_CLOEXEC));
+}
+#endif
+
+} // namespace
+
+PerfCounterValues& PerfCounterValues::operator+=(const PerfCounterValues& other)
+{
+    cycles += other.cycles;
+    instructions += other.instructions;
+    cacheMisses += other.cacheMisses;
+    branchMisses += other.branchMisses;
+    wallTime += other.wallTime;
+    return *this;
+}
+
+PerfCounterValues PerfCounterValues::operator-(const PerfCounterValues& other) const
+{
+    // Multiplexed counts are extrapolated and can step back slightly, clamp instead of wrapping around
+    auto difference = [](uint64_t a, uint64_t b) { return a > b ? a - b : 0; };
+
+    PerfCounterValues result;
+    result.cycles = difference(cycles, other.cycles);
+    result.instructions = difference(instructions, other.instructions);
+    result.cacheMisses = difference(cacheMisses, other.cacheMisses);
+    result.branchMisses = difference(branchMisses, other.branchMisses);
+    result.wallTime = difference(wallTime, other.wallTime);
+    return result;
+}
+
+double PerfCounterValues::getInstructionsPerCycle() const
+{
+    return cycles > 0 ? static_cast<double>(instructions) / static_cast<double>(cycles) : 0.0;
+}
+
+double PerfCounterValues::getCacheMissesPerKiloInstruction() const
+{
+    return instructions > 0 ? static_cast<double>(cacheMisses) * 1000.0 / static_cast<double>(instructions) : 0.0;
+}
+
+PerfCounters::~PerfCounters()
+{
+    shutdown();
+}
+
+bool PerfCounters::initialize()
+{
+#ifdef __linux__
+    if (isInitialized())
+    {
+        return true;
+    }
+
+    Group group;
+    if (!openGroup(group, true))
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_groups.push_back(group);
+    m_initialized = true;
+    GN_INFO("Opened {} hardware performance counters", group.openCount);
+    return true;
+#else
+    GN_WARNING("Hardware performance counters are not supported on this platform");
+    return false;
+#endif
+}
+
+bool PerfCounters::addCurrentThread()
+{
+    Group group;
+    if (!isInitialized() || !openGroup(group, false))
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_groups.push_back(group);
+    return true;
+}
+
+void PerfCounters::shutdown()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (Group& group : m_groups)
+    {
+        closeGroup(group);
+    }
+    m_groups.clear();
+    m_initialized = false;
+}
+
+uint32_t PerfCounters::getThreadCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<uint32_t>(m_groups.size());
+}
+
+bool PerfCounters::read(PerfCounterValues& values) const
+{
+    values = {};
+    values.wallTime = getWallTime();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    bool counted = false;
+    for (const Group& group : m_groups)
+    {
+        PerfCounterValues groupValues;
+        if (readGroup(group, groupValues))
+        {
+            values += groupValues;
+            counted = true;
+        }
+    }
+    return counted;
+}
+
+bool PerfCounters::openGroup(Group& group, bool logErrors)
+{
+#ifdef __linux__
+    static constexpr std::array<uint64_t, CounterCount> configs = {PERF_COUNT_HW_CPU_CYCLES,
+                                                                   PERF_COUNT_HW_INSTRUCTIONS,
+                                                                   PERF_COUNT_HW_CACHE_MISSES,
+                                                                   PERF_COUNT_HW_BRANCH_MISSES};
+
+    group.descriptors[Cycles] = openCounter(configs[Cycles], -1);
+    if (group.descriptors[Cycles] < 0)
+    {
+        if (logErrors)
+        {
+            GN_WARNING("Hardware performance counters are not available: {}", std::strerror(errno));
+        }
+        return false;
+    }
+
+    group.readOrder[0] = Cycles;
+    group.openCount = 1;
+    for (int counter = Instructions; counter < CounterCount; ++counter)
+    {
+        group.descriptors[counter] = openCounter(configs[counter], group.descriptors[Cycles]);
+        if (group.descriptors[counter] < 0)
+        {
+            if (logErrors)
+            {
+                GN_WARNING("Hardware performance counter {} is not available: {}", counter, std::strerror(errno));
+            }
+            continue;
+        }
+        group.readOrder[group.openCount++] = static_cast<Counter>(counter);
+    }
+
+    ioctl(group.descriptors[Cycles], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(group.descriptors[Cycles], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void PerfCounters::closeGroup(Group& group)
+{
+#ifdef __linux__
+    // Close the group members before their leader
+    for (int counter = CounterCount - 1; counter >= 0; --counter)
+    {
+        if (group.descriptors[counter] >= 0)
+        {
+            close(group.descriptors[counter]);
+        }
+    }
+#endif
+    group.descriptors.fill(-1);
+    group.openCount = 0;
+}
+
+bool PerfCounters::readGroup(const Group& group, PerfCounterValues& values)
+{
+#ifdef __linux__
+    // Layout of a PERF_FORMAT_GROUP read with both time fields
+    struct
+    {
+        uint64_t count;
+        uint64_t timeEnabled;
+        uint64_t timeRunning;
+        uint64_t values[CounterCount];
+    } data{};
+
+    // Reads from any thread, the counts stay readable after the counted thread exited
+    ssize_t bytes = ::read(group.descriptors[Cycles], &data, sizeof(data));
+    if (bytes < static_cast<ssize_t>(3 * sizeof(uint64_t)) || data.count != group.openCount)
+    {
+        return false;
+    }
+
+    // The kernel multiplexes counters when it runs out of hardware slots, extrapolate to the enabled time
+    double scale = 1.0;
+    if (data.timeRunning > 0 && data.timeRunning < data.timeEnabled)
+    {
+        scale = static_cast<double>(data.timeEnabled) / static_cast<double>(data.timeRunning);
+    }
+
+    for (uint32_t i = 0; i < group.openCount; ++i)
+    {
+        uint64_t value = static_cast<uint64_t>(static_cast<double>(data.values[i]) * scale);
+        switch (group.readOrder[i])
+        {
+            case Cycles:
+                values.cycles = value;
+                break;
+            case Instructions:
+                values.instructions = value;
+                break;
+            case CacheMisses:
+                values.cacheMisses = value;
+                break;
+            case BranchMisses:
+                values.branchMisses = value;
+                break;
+            case CounterCount:
+                break;
+        }
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+PerfCounterScope::PerfCounterScope(const PerfCounters* counters, PerfCounterValues& total)
+    : m_counters(counters), m_total(total)
+{
+    if (m_counters)
+    {
+        m_counters->read(m_start);
+    }
+    else
+    {
+        m_start.wallTime = getWallTime();
+    }
+}
+
+PerfCounterScope::~PerfCounterScope()
+{
+    PerfCounterValues end;
+    if (m_counters)
+    {
+        m_counters->read(end);
+    }
+    else
+    {
+        end.wallTime = getWallTime();
+    }
+    m_total += end - m_start;
+}
+
+} // namespace graphyne::platform
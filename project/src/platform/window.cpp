@@ -55,22 +55,49 @@ void Window::processEvents()
     SDL_Event event;
     while (SDL_PollEvent(&event))
     {
-        switch (event.type)
-        {
-            case SDL_QUIT:
-                m_shouldClose = true;
-                break;
-            case SDL_WINDOWEVENT:
-                if (event.window.event == SDL_WINDOWEVENT_RESIZED)
-                {
+        handleEvent(event);
+    }
+}
+
+void Window::waitEvents()
+{
+    SDL_Event event;
+    if (SDL_WaitEvent(&event))
+    {
+        handleEvent(event);
+    }
+    processEvents();
+}
+
+void Window::handleEvent(const SDL_Event& event)
+{
+    switch (event.type)
+    {
+        case SDL_QUIT:
+            m_shouldClose = true;
+            break;
+        case SDL_WINDOWEVENT:
+            switch (event.window.event)
+            {
+                case SDL_WINDOWEVENT_RESIZED:
                     m_width = event.window.data1;
                     m_height = event.window.data2;
                     GN_INFO("Window resized to {}x{}", m_width, m_height);
-                }
-                break;
-            default:
-                break;
-        }
+                    break;
+                case SDL_WINDOWEVENT_MINIMIZED:
+                    m_minimized = true;
+                    break;
+                case SDL_WINDOWEVENT_RESTORED:
+                case SDL_WINDOWEVENT_MAXIMIZED:
+                case SDL_WINDOWEVENT_SHOWN:
+                    m_minimized = false;
+                    break;
+                default:
+                    break;
+            }
+            break;
+        default:
+            break;
     }
 }
 
@@ -0,0 +1,126 @@
+#include "utils/hash.h"
+#include <cstring>
+#include <fmt/format.h>
+
+namespace graphyne::utils
+{
+
+namespace
+{
+
+constexpr uint64_t PRIME_1 = 11400714785074694791ULL;
+constexpr uint64_t PRIME_2 = 14029467366897019727ULL;
+constexpr uint64_t PRIME_3 = 1609587929392839161ULL;
+constexpr uint64_t PRIME_4 = 9650029242287828579ULL;
+constexpr uint64_t PRIME_5 = 2870177450012600261ULL;
+
+uint64_t rotateLeft(uint64_t value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+uint64_t read64(const uint8_t* data)
+{
+    uint64_t value = 0;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+uint32_t read32(const uint8_t* data)
+{
+    uint32_t value = 0;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+uint64_t round(uint64_t accumulator, uint64_t input)
+{
+    accumulator += input * PRIME_2;
+    accumulator = rotateLeft(accumulator, 31);
+    return accumulator * PRIME_1;
+}
+
+uint64_t mergeRound(uint64_t accumulator, uint64_t value)
+{
+    accumulator ^= round(0, value);
+    return accumulator * PRIME_1 + PRIME_4;
+}
+
+} // namespace
+
+uint64_t hash64(const void* data, size_t size, uint64_t seed)
+{
+    const auto* input = static_cast<const uint8_t*>(data);
+    const uint8_t* end = input + size;
+    uint64_t hash = 0;
+
+    if (size >= 32)
+    {
+        uint64_t v1 = seed + PRIME_1 + PRIME_2;
+        uint64_t v2 = seed + PRIME_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME_1;
+
+        const uint8_t* limit = end - 32;
+        do
+        {
+            v1 = round(v1, read64(input));
+            v2 = round(v2, read64(input + 8));
+            v3 = round(v3, read64(input + 16));
+            v4 = round(v4, read64(input + 24));
+            input += 32;
+        } while (input <= limit);
+
+        hash = rotateLeft(v1, 1) + rotateLeft(v2, 7) + rotateLeft(v3, 12) + rotateLeft(v4, 18);
+        hash = mergeRound(hash, v1);
+        hash = mergeRound(hash, v2);
+        hash = mergeRound(hash, v3);
+        hash = mergeRound(hash, v4);
+    }
+    else
+    {
+        hash = seed + PRIME_5;
+    }
+
+    hash += static_cast<uint64_t>(size);
+
+    while (input + 8 <= end)
+    {
+        hash ^= round(0, read64(input));
+        hash = rotateLeft(hash, 27) * PRIME_1 + PRIME_4;
+        input += 8;
+    }
+
+    if (input + 4 <= end)
+    {
+        hash ^= static_cast<uint64_t>(read32(input)) * PRIME_1;
+        hash = rotateLeft(hash, 23) * PRIME_2 + PRIME_3;
+        input += 4;
+    }
+
+    while (input < end)
+    {
+        hash ^= static_cast<uint64_t>(*input) * PRIME_5;
+        hash = rotateLeft(hash, 11) * PRIME_1;
+        ++input;
+    }
+
+    hash ^= hash >> 33;
+    hash *= PRIME_2;
+    hash ^= hash >> 29;
+    hash *= PRIME_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+uint64_t hashCombine(uint64_t seed, uint64_t value)
+{
+    return hash64(&value, sizeof(value), seed);
+}
+
+std::string hashToString(uint64_t hash)
+{
+    return fmt::format("{:016x}", hash);
+}
+
+} // namespace graphyne::utils
@@ -0,0 +1,508 @@
+#include "utils/profiler.h"
+#include "utils/logger.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fmt/format.h>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace graphyne::utils
+{
+
+namespace
+{
+
+constexpr uint32_t EVENTS_PER_CHUNK = 4096;
+constexpr size_t MAX_CHUNKS_PER_THREAD = 256; // About 24 MB of events per thread
+constexpr int32_t TRACE_PROCESS_ID = 1;
+constexpr uint64_t PROCESS_TRACK_UUID = 1;
+
+struct EventChunk
+{
+    std::array<ProfileEvent, EVENTS_PER_CHUNK> events;
+    std::atomic<uint32_t> count{0}; // Published by the owning thread with release semantics
+    std::atomic<EventChunk*> next{nullptr};
+};
+
+struct ThreadBuffer
+{
+    uint32_t threadId = 0;
+    std::string name; // Guarded by the profiler mutex
+    EventChunk* head = nullptr;
+    EventChunk* tail = nullptr; // Only touched by the owning thread
+    size_t chunkCount = 0;      // Only touched by the owning thread
+
+    ThreadBuffer() : head(new EventChunk()), tail(head), chunkCount(1) {}
+
+    ~ThreadBuffer()
+    {
+        EventChunk* chunk = head;
+        while (chunk)
+        {
+            EventChunk* next = chunk->next.load(std::memory_order_relaxed);
+            delete chunk;
+            chunk = next;
+        }
+    }
+
+    ThreadBuffer(const ThreadBuffer&) = delete;
+    ThreadBuffer& operator=(const ThreadBuffer&) = delete;
+};
+
+struct ThreadSnapshot
+{
+    uint32_t threadId = 0;
+    std::string name;
+    std::vector<ProfileEvent> events;
+};
+
+// Minimal protobuf encoding, enough for the Perfetto trace packets written below
+void writeVarint(std::string& out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+void writeVarintField(std::string& out, uint32_t field, uint64_t value)
+{
+    writeVarint(out, static_cast<uint64_t>(field) << 3);
+    writeVarint(out, value);
+}
+
+void writeBytesField(std::string& out, uint32_t field, const std::string& bytes)
+{
+    writeVarint(out, (static_cast<uint64_t>(field) << 3) | 2);
+    writeVarint(out, bytes.size());
+    out.append(bytes);
+}
+
+// Field numbers from perfetto/trace/trace_packet.proto and track_event/*.proto
+namespace perfetto
+{
+constexpr uint32_t TRACE_PACKET = 1;
+constexpr uint32_t PACKET_TIMESTAMP = 8;
+constexpr uint32_t PACKET_SEQUENCE_ID = 10;
+constexpr uint32_t PACKET_TRACK_EVENT = 11;
+constexpr uint32_t PACKET_SEQUENCE_FLAGS = 13;
+constexpr uint32_t PACKET_TRACK_DESCRIPTOR = 60;
+constexpr uint32_t SEQUENCE_INCREMENTAL_STATE_CLEARED = 1;
+
+constexpr uint32_t TRACK_UUID = 1;
+constexpr uint32_t TRACK_PROCESS = 3;
+constexpr uint32_t TRACK_THREAD = 4;
+constexpr uint32_t PROCESS_PID = 1;
+constexpr uint32_t PROCESS_NAME = 6;
+constexpr uint32_t THREAD_PID = 1;
+constexpr uint32_t THREAD_TID = 2;
+constexpr uint32_t THREAD_NAME = 5;
+
+constexpr uint32_t EVENT_TYPE = 9;
+constexpr uint32_t EVENT_TRACK_UUID = 11;
+constexpr uint32_t EVENT_NAME = 23;
+constexpr uint32_t EVENT_TYPE_SLICE_BEGIN = 1;
+constexpr uint32_t EVENT_TYPE_SLICE_END = 2;
+constexpr uint32_t EVENT_TYPE_INSTANT = 3;
+} // namespace perfetto
+
+uint64_t getThreadTrackUuid(uint32_t threadId)
+{
+    return PROCESS_TRACK_UUID + threadId;
+}
+
+void appendJsonString(std::string& out, const std::string& value)
+{
+    out.push_back('"');
+    for (char c : value)
+    {
+        if (c == '"' || c == '\\')
+        {
+            out.push_back('\\');
+            out.push_back(c);
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            fmt::format_to(std::back_inserter(out), "\\u{:04x}", static_cast<unsigned int>(c));
+        }
+        else
+        {
+            out.push_back(c);
+        }
+    }
+    out.push_back('"');
+}
+
+bool writeFile(const std::string& path, const std::string& data)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        GN_ERROR("Failed to open trace file {}", path);
+        return false;
+    }
+
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!file)
+    {
+        GN_ERROR("Failed to write trace file {}", path);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+struct Profiler::ProfilerImpl
+{
+    std::atomic<bool> enabled{false};
+    std::atomic<uint64_t> droppedEvents{0};
+
+    std::mutex mutex; // Guards the thread list, thread names, tracks and interned names
+    std::vector<std::unique_ptr<ThreadBuffer>> threads;
+    std::vector<ThreadBuffer*> tracks;     // Buffers not owned by a thread, also listed in threads
+    std::unordered_set<std::string> names; // Node based, so pointers to the strings stay valid
+
+    ThreadBuffer* getThreadBuffer()
+    {
+        thread_local ThreadBuffer* threadBuffer = nullptr;
+        if (!threadBuffer)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            threadBuffer = addBuffer();
+        }
+        return threadBuffer;
+    }
+
+    ThreadBuffer* addBuffer()
+    {
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->threadId = static_cast<uint32_t>(threads.size() + 1);
+        buffer->name = fmt::format("Thread {}", buffer->threadId);
+        threads.push_back(std::move(buffer));
+        return threads.back().get();
+    }
+
+    void record(const char* name, ProfileEventType type, uint32_t frameIndex)
+    {
+        uint64_t timestamp = now();
+        append(getThreadBuffer(), name, type, frameIndex, timestamp);
+    }
+
+    // Only called by the thread owning the buffer, or for tracks the thread recording them
+    void append(ThreadBuffer* buffer, const char* name, ProfileEventType type, uint32_t frameIndex, uint64_t timestamp)
+    {
+        EventChunk* chunk = buffer->tail;
+        uint32_t count = chunk->count.load(std::memory_order_relaxed);
+        if (count == EVENTS_PER_CHUNK)
+        {
+            if (buffer->chunkCount == MAX_CHUNKS_PER_THREAD)
+            {
+                droppedEvents.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            auto* next = new EventChunk();
+            chunk->next.store(next, std::memory_order_release);
+            buffer->tail = next;
+            ++buffer->chunkCount;
+            chunk = next;
+            count = 0;
+        }
+
+        ProfileEvent& event = chunk->events[count];
+        event.name = name;
+        event.timestamp = timestamp;
+        event.frameIndex = frameIndex;
+        event.type = type;
+        chunk->count.store(count + 1, std::memory_order_release);
+    }
+
+    std::vector<ThreadSnapshot> snapshot()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        std::vector<ThreadSnapshot> snapshots;
+        snapshots.reserve(threads.size());
+        for (const auto& buffer : threads)
+        {
+            ThreadSnapshot& snapshot = snapshots.emplace_back();
+            snapshot.threadId = buffer->threadId;
+            snapshot.name = buffer->name;
+
+            for (EventChunk* chunk = buffer->head; chunk; chunk = chunk->next.load(std::memory_order_acquire))
+            {
+                uint32_t count = chunk->count.load(std::memory_order_acquire);
+                snapshot.events.insert(snapshot.events.end(), chunk->events.begin(), chunk->events.begin() + count);
+            }
+        }
+        return snapshots;
+    }
+};
+
+Profiler& Profiler::getInstance()
+{
+    static Profiler instance;
+    return instance;
+}
+
+Profiler::Profiler() : m_impl(std::make_unique<ProfilerImpl>()) {}
+
+Profiler::~Profiler() = default;
+
+void Profiler::setEnabled(bool enabled)
+{
+    m_impl->enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Profiler::isEnabled() const
+{
+    return m_impl->enabled.load(std::memory_order_relaxed);
+}
+
+void Profiler::setThreadName(const std::string& name)
+{
+    ThreadBuffer* buffer = m_impl->getThreadBuffer();
+    std::lock_guard<std::mutex> lock(m_impl->mutex);
+    buffer->name = name;
+}
+
+void Profiler::beginScope(const char* name)
+{
+    if (m_impl->enabled.load(std::memory_order_relaxed))
+    {
+        m_impl->record(name, ProfileEventType::Begin, 0);
+    }
+}
+
+void Profiler::endScope(const char* name)
+{
+    if (m_impl->enabled.load(std::memory_order_relaxed))
+    {
+        m_impl->record(name, ProfileEventType::End, 0);
+    }
+}
+
+void Profiler::markFrame(uint64_t frameIndex)
+{
+    if (m_impl->enabled.load(std::memory_order_relaxed))
+    {
+        m_impl->record("Frame", ProfileEventType::Frame, static_cast<uint32_t>(frameIndex));
+    }
+}
+
+uint32_t Profiler::createTrack(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_impl->mutex);
+    ThreadBuffer* buffer = m_impl->addBuffer();
+    buffer->name = name;
+    m_impl->tracks.push_back(buffer);
+    return static_cast<uint32_t>(m_impl->tracks.size() - 1);
+}
+
+void Profiler::recordTrackEvent(uint32_t track, const char* name, ProfileEventType type, uint64_t timestamp)
+{
+    if (!m_impl->enabled.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    ThreadBuffer* buffer = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_impl->mutex);
+        if (track < m_impl->tracks.size())
+        {
+            buffer = m_impl->tracks[track];
+        }
+    }
+    if (buffer)
+    {
+        m_impl->append(buffer, name, type, 0, timestamp);
+    }
+}
+
+const char* Profiler::internName(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_impl->mutex);
+    return m_impl->names.insert(name).first->c_str();
+}
+
+void Profiler::clear()
+{
+    std::lock_guard<std::mutex> lock(m_impl->mutex);
+    for (const auto& buffer : m_impl->threads)
+    {
+        EventChunk* chunk = buffer->head->next.exchange(nullptr, std::memory_order_relaxed);
+        while (chunk)
+        {
+            EventChunk* next = chunk->next.load(std::memory_order_relaxed);
+            delete chunk;
+            chunk = next;
+        }
+        buffer->head->count.store(0, std::memory_order_relaxed);
+        buffer->tail = buffer->head;
+        buffer->chunkCount = 1;
+    }
+    m_impl->droppedEvents.store(0, std::memory_order_relaxed);
+}
+
+uint64_t Profiler::getDroppedEventCount() const
+{
+    return m_impl->droppedEvents.load(std::memory_order_relaxed);
+}
+
+bool Profiler::exportChromeTrace(const std::string& path) const
+{
+    std::vector<ThreadSnapshot> threads = m_impl->snapshot();
+
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto beginEvent = [&out, &first]() {
+        out.append(first ? "" : ",\n");
+        first = false;
+    };
+
+    size_t eventCount = 0;
+    for (const ThreadSnapshot& thread : threads)
+    {
+        beginEvent();
+        fmt::format_to(std::back_inserter(out),
+                       "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":{},\"tid\":{},\"args\":{{\"name\":",
+                       TRACE_PROCESS_ID,
+                       thread.threadId);
+        appendJsonString(out, thread.name);
+        out.append("}}");
+
+        for (const ProfileEvent& event : thread.events)
+        {
+            beginEvent();
+            out.append("{\"name\":");
+            switch (event.type)
+            {
+                case ProfileEventType::Begin:
+                    appendJsonString(out, event.name);
+                    out.append(",\"ph\":\"B\"");
+                    break;
+                case ProfileEventType::End:
+                    appendJsonString(out, event.name);
+                    out.append(",\"ph\":\"E\"");
+                    break;
+                case ProfileEventType::Frame:
+                    appendJsonString(out, fmt::format("Frame {}", event.frameIndex));
+                    out.append(",\"ph\":\"i\",\"s\":\"g\"");
+                    break;
+            }
+
+            // Chrome traces use microseconds, keep the nanosecond precision as decimals
+            fmt::format_to(std::back_inserter(out),
+                           ",\"pid\":{},\"tid\":{},\"ts\":{}.{:03}}}",
+                           TRACE_PROCESS_ID,
+                           thread.threadId,
+                           event.timestamp / 1000,
+                           event.timestamp % 1000);
+        }
+        eventCount += thread.events.size();
+    }
+    out.append("\n]}\n");
+
+    if (!writeFile(path, out))
+    {
+        return false;
+    }
+
+    GN_INFO("Wrote Chrome trace with {} events from {} threads to {}", eventCount, threads.size(), path);
+    return true;
+}
+
+bool Profiler::exportPerfettoTrace(const std::string& path) const
+{
+    std::vector<ThreadSnapshot> threads = m_impl->snapshot();
+
+    std::string out;
+    std::string packet;
+    std::string message;
+    std::string nested;
+
+    // Process track that all thread tracks belong to
+    writeVarintField(nested, perfetto::PROCESS_PID, TRACE_PROCESS_ID);
+    writeBytesField(nested, perfetto::PROCESS_NAME, "Graphyne");
+    writeVarintField(message, perfetto::TRACK_UUID, PROCESS_TRACK_UUID);
+    writeBytesField(message, perfetto::TRACK_PROCESS, nested);
+    writeBytesField(packet, perfetto::PACKET_TRACK_DESCRIPTOR, message);
+    writeBytesField(out, perfetto::TRACE_PACKET, packet);
+
+    size_t eventCount = 0;
+    for (const ThreadSnapshot& thread : threads)
+    {
+        uint64_t trackUuid = getThreadTrackUuid(thread.threadId);
+
+        // Every thread writes its own packet sequence, starting with its track descriptor
+        nested.clear();
+        writeVarintField(nested, perfetto::THREAD_PID, TRACE_PROCESS_ID);
+        writeVarintField(nested, perfetto::THREAD_TID, thread.threadId);
+        writeBytesField(nested, perfetto::THREAD_NAME, thread.name);
+        message.clear();
+        writeVarintField(message, perfetto::TRACK_UUID, trackUuid);
+        writeBytesField(message, perfetto::TRACK_THREAD, nested);
+        packet.clear();
+        writeVarintField(packet, perfetto::PACKET_SEQUENCE_ID, thread.threadId);
+        writeVarintField(packet, perfetto::PACKET_SEQUENCE_FLAGS, perfetto::SEQUENCE_INCREMENTAL_STATE_CLEARED);
+        writeBytesField(packet, perfetto::PACKET_TRACK_DESCRIPTOR, message);
+        writeBytesField(out, perfetto::TRACE_PACKET, packet);
+
+        for (const ProfileEvent& event : thread.events)
+        {
+            message.clear();
+            switch (event.type)
+            {
+                case ProfileEventType::Begin:
+                    writeVarintField(message, perfetto::EVENT_TYPE, perfetto::EVENT_TYPE_SLICE_BEGIN);
+                    writeBytesField(message, perfetto::EVENT_NAME, event.name);
+                    break;
+                case ProfileEventType::End:
+                    writeVarintField(message, perfetto::EVENT_TYPE, perfetto::EVENT_TYPE_SLICE_END);
+                    break;
+                case ProfileEventType::Frame:
+                    writeVarintField(message, perfetto::EVENT_TYPE, perfetto::EVENT_TYPE_INSTANT);
+                    writeBytesField(message, perfetto::EVENT_NAME, fmt::format("Frame {}", event.frameIndex));
+                    break;
+            }
+            writeVarintField(message, perfetto::EVENT_TRACK_UUID, trackUuid);
+
+            packet.clear();
+            writeVarintField(packet, perfetto::PACKET_TIMESTAMP, event.timestamp);
+            writeVarintField(packet, perfetto::PACKET_SEQUENCE_ID, thread.threadId);
+            writeBytesField(packet, perfetto::PACKET_TRACK_EVENT, message);
+            writeBytesField(out, perfetto::TRACE_PACKET, packet);
+        }
+        eventCount += thread.events.size();
+    }
+
+    if (!writeFile(path, out))
+    {
+        return false;
+    }
+
+    GN_INFO("Wrote Perfetto trace with {} events from {} threads to {}", eventCount, threads.size(), path);
+    return true;
+}
+
+bool Profiler::exportTrace(const std::string& path) const
+{
+    bool isJson = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    return isJson ? exportChromeTrace(path) : exportPerfettoTrace(path);
+}
+
+uint64_t Profiler::now()
+{
+    auto time = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count());
+}
+
+} // namespace graphyne::utils